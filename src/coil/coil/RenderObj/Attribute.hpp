@@ -16,6 +16,8 @@
 */
 #pragma once
 #include <magnet/GL/buffer.hpp>
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace coil {
@@ -97,6 +99,35 @@ namespace coil {
     inline void flagNewData()
     { _context->queueTask(std::bind(&Attribute::initGLData, this)); }
 
+    /*! \brief Marks that only some elements of the buffer have been
+     * updated, and only these should be uploaded to the GL system.
+     *
+     * The elements are uploaded as contiguous runs, where nearby
+     * elements are merged into a single run to reduce the number of
+     * transfers. If the GL buffer has not yet been created, the whole
+     * buffer is uploaded.
+     *
+     * \param elements The sorted indices of the updated elements.
+     */
+    inline void flagNewData(const std::vector<size_t>& elements)
+    {
+      if (elements.empty()) return;
+
+      //Gaps of fewer elements than this are uploaded with the runs
+      //either side of them
+      static const size_t maxGap = 16;
+
+      std::vector<std::pair<size_t, size_t> > runs;
+      runs.push_back(std::make_pair(elements.front(), elements.front() + 1));
+      for (const size_t& element : elements)
+	if (element > runs.back().second + maxGap)
+	  runs.push_back(std::make_pair(element, element + 1));
+	else
+	  runs.back().second = std::max(runs.back().second, element + 1);
+
+      _context->queueTask(std::bind(&Attribute::updateGLData, this, runs));
+    }
+
     /*! \brief Test if the attribute is in use and should be
      * updated. 
      */
@@ -159,6 +190,40 @@ namespace coil {
 	  }
     }
 
+    /*! \brief Copy runs of elements of the data to the OpenGL
+        buffer.
+
+	This function must be called in the OpenGL thread and is
+	invoked as a callback from \ref flagNewData(const
+	std::vector<size_t>&). The reported minimum and maximum values
+	are only expanded to include the updated elements, to avoid
+	scanning the whole data set.
+
+	\param runs The [begin, end) ranges of the updated elements.
+     */
+    void updateGLData(const std::vector<std::pair<size_t, size_t> >& runs)
+    {
+      if ((_glData.size() != size()) || _minVals.empty())
+	{
+	  initGLData();
+	  return;
+	}
+
+      const size_t comps = components();
+      for (const auto& run : runs)
+	{
+	  _glData.update(run.first * comps, (run.second - run.first) * comps, &(*this)[run.first * comps]);
+	  for (size_t i = run.first; i < run.second; ++i)
+	    for (size_t j = 0; j < comps; ++j)
+	      {
+		_minVals[j] = std::min(_minVals[j], (*this)[i * comps + j]);
+		_maxVals[j] = std::max(_maxVals[j], (*this)[i * comps + j]);
+	      }
+	}
+
+      ++_dataUpdates;
+    }
+
     /*! \brief The OpenGL representation of the attribute data.
      *
      * There are N * _components floats of attribute data.
@@ -40,6 +40,28 @@ namespace dynamo {
     return rij.nrm();
   }
 
+  void
+  BoundaryCondition::applyBC(double* const pos[NDIM], double* const vel[NDIM], const size_t N) const
+  {
+    for (size_t i(0); i < N; ++i)
+      {
+	Vector r, v;
+	for (size_t n(0); n < NDIM; ++n)
+	  {
+	    r[n] = pos[n][i];
+	    v[n] = vel[n][i];
+	  }
+
+	applyBC(r, v);
+
+	for (size_t n(0); n < NDIM; ++n)
+	  {
+	    pos[n][i] = r[n];
+	    vel[n][i] = v[n];
+	  }
+      }
+  }
+
   retptr
   BoundaryCondition::getClass(const magnet::xml::Node& XML, dynamo::Simulation* tmp)
   {
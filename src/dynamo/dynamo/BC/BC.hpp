@@ -90,6 +90,20 @@ namespace dynamo
      */
     virtual void applyBC(Vector  &pos, const double& dt) const = 0;
 
+    /*! \brief A batched form of applyBC(Vector&, Vector&).
+
+      The vectors are stored in structure-of-arrays form, as used by
+      the batched event prediction in the Dynamics classes. The
+      default implementation just calls the scalar applyBC on each
+      entry, but simple boundary conditions override this with a loop
+      which the compiler can vectorise.
+
+      \param pos The NDIM component arrays of the position vectors to affect.
+      \param vel The NDIM component arrays of the velocity vectors to affect.
+      \param N The number of vectors in the arrays.
+     */
+    virtual void applyBC(double* const pos[NDIM], double* const vel[NDIM], const size_t N) const;
+
     /*! \brief Stream the boundary conditions forward in time.*/
     virtual void update(const double&) {};
 
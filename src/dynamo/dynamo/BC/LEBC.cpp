@@ -78,18 +78,7 @@ namespace dynamo {
 
   void 
   BCLeesEdwards::applyBC(Vector  &pos, Vector &vel) const 
-  {
-    //Shift the x distance due to the Lee's Edwards conditions
-    pos[0] -= rint(pos[1] / Sim->primaryCellSize[1]) * _dxd;
-  
-    //Adjust the velocity due to the box shift
-    vel[0] -= rint(pos[1] / Sim->primaryCellSize[1]) 
-      * _shearRate * Sim->primaryCellSize[1];
-  
-    for (size_t n = 0; n < NDIM; ++n)
-      pos[n] -= Sim->primaryCellSize[n] *
-	lrint(pos[n] / Sim->primaryCellSize[n]);    
-  }
+  { minimumImage(pos, vel, Sim->primaryCellSize); }
 
   void 
   BCLeesEdwards::applyBC(Vector& posVec, const double& dt) const 
@@ -48,6 +48,24 @@ namespace dynamo {
 
     virtual void applyBC(Vector&, const double& dt) const;
 
+    virtual void applyBC(double* const pos[NDIM], double* const vel[NDIM], const size_t N) const
+    { BoundaryCondition::applyBC(pos, vel, N); }
+
+    /*! \brief The body of applyBC(Vector&, Vector&), see
+        BCPeriodic::minimumImage.
+     */
+    inline void minimumImage(Vector& pos, Vector& vel, const Vector& L) const
+    {
+      //Shift the x distance due to the Lee's Edwards conditions
+      pos[0] -= rint(pos[1] / L[1]) * _dxd;
+  
+      //Adjust the velocity due to the box shift
+      vel[0] -= rint(pos[1] / L[1]) * _shearRate * L[1];
+  
+      for (size_t n = 0; n < NDIM; ++n)
+	pos[n] -= L[n] * lrint(pos[n] / L[n]);
+    }
+
     virtual void update(const double&);
 
     /*! \brief Returns the shear rate of the boundaries. */
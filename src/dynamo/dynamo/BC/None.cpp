@@ -37,6 +37,10 @@ namespace dynamo {
   BCNone::applyBC(Vector  &, const double&) const 
   {}
 
+  void 
+  BCNone::applyBC(double* const[NDIM], double* const[NDIM], const size_t) const
+  {}
+
   void 
   BCNone::update(const double &) 
   {}
@@ -38,6 +38,13 @@ namespace dynamo {
 
     virtual void applyBC(Vector&, const double&) const;
 
+    virtual void applyBC(double* const[NDIM], double* const[NDIM], const size_t) const;
+
+    /*! \brief The body of applyBC(Vector&, Vector&), see
+        BCPeriodic::minimumImage.
+     */
+    inline void minimumImage(Vector&, Vector&, const Vector&) const {}
+
     virtual void update(const double&);
 
     virtual void outputXML(magnet::xml::XmlStream &XML) const;
@@ -18,6 +18,7 @@
 #include <dynamo/BC/PBC.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <cmath>
 
 namespace dynamo {
   BCPeriodic::BCPeriodic(const dynamo::Simulation* tmp):
@@ -35,19 +36,27 @@ namespace dynamo {
   }
 
   void 
-  BCPeriodic::applyBC(Vector & pos, Vector&) const
+  BCPeriodic::applyBC(Vector & pos, Vector& vel) const
+  { minimumImage(pos, vel, Sim->primaryCellSize); }
+
+  void 
+  BCPeriodic::applyBC(Vector  &pos, const double&) const 
   {
     for (size_t n = 0; n < NDIM; ++n)
       pos[n] -= Sim->primaryCellSize[n] *
 	lrint(pos[n] / Sim->primaryCellSize[n]);    
   }
 
-  void 
-  BCPeriodic::applyBC(Vector  &pos, const double&) const 
+  void
+  BCPeriodic::applyBC(double* const pos[NDIM], double* const[NDIM], const size_t N) const
   {
     for (size_t n = 0; n < NDIM; ++n)
-      pos[n] -= Sim->primaryCellSize[n] *
-	lrint(pos[n] / Sim->primaryCellSize[n]);    
+      {
+	const double L = Sim->primaryCellSize[n];
+	double* const r = pos[n];
+	for (size_t i = 0; i < N; ++i)
+	  r[i] -= L * std::rint(r[i] / L);
+      }
   }
 
   void 
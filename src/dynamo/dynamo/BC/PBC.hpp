@@ -36,6 +36,23 @@ namespace dynamo {
 
     virtual void applyBC(Vector &, const double&) const;
 
+    virtual void applyBC(double* const[NDIM], double* const[NDIM], const size_t) const;
+
+    /*! \brief The body of applyBC(Vector&, Vector&).
+
+      This is not virtual, so code which knows the exact type of the
+      boundary condition (see PairKernel) can call it directly and
+      have it inlined.
+
+      \param pos The position vector to affect.
+      \param L The size of the primary image, Simulation::primaryCellSize.
+     */
+    inline void minimumImage(Vector& pos, Vector&, const Vector& L) const
+    {
+      for (size_t n = 0; n < NDIM; ++n)
+	pos[n] -= L[n] * lrint(pos[n] / L[n]);
+    }
+
     virtual void outputXML(magnet::xml::XmlStream&) const;
     virtual void operator<<(const magnet::xml::Node&);
 
@@ -61,6 +78,9 @@ namespace dynamo {
   
     virtual void applyBC(Vector& pos, const double&) const;
 
+    virtual void applyBC(double* const pos[NDIM], double* const vel[NDIM], const size_t N) const
+    { BoundaryCondition::applyBC(pos, vel, N); }
+
     virtual void outputXML(magnet::xml::XmlStream&) const;
     virtual void operator<<(const magnet::xml::Node&);
   };
@@ -83,6 +103,9 @@ namespace dynamo {
   
     virtual void applyBC(Vector& pos, const double&) const;
 
+    virtual void applyBC(double* const pos[NDIM], double* const vel[NDIM], const size_t N) const
+    { BoundaryCondition::applyBC(pos, vel, N); }
+
     virtual void outputXML(magnet::xml::XmlStream&) const;
     virtual void operator<<(const magnet::xml::Node&);
   };
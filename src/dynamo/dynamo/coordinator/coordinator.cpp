@@ -64,6 +64,8 @@ namespace dynamo {
       ("help", "Produces this message")
       ("n-threads,N", po::value<unsigned int>(),
        "Number of threads to spawn for concurrent processing. (Only utilised by certain engine/sim configurations)")
+      ("thread-affinity",
+       "Bind each thread to a CPU core. The replica exchange engine then keeps each replica on a single thread, and loads it on that thread so its memory is allocated on the thread's NUMA node.")
       ("out-config-file,o", po::value<std::string>(),
        "Default config output file,(config.%ID.end.xml.bz2)")
       ("out-data-file", po::value<std::string>(),
@@ -78,7 +80,10 @@ namespace dynamo {
        " Values:\n"
        "  1: \tStandard Engine\n"
        "  2: \tNVT Replica Exchange Engine\n"
-       "  3: \tCompression Engine")
+       "  3: \tCompression Engine\n"
+       "  4: \tReplay Engine\n"
+       "  5: \tBatch Engine (many independent runs)\n"
+       "  6: \tDistributed NVT Replica Exchange Engine (one replica per process)")
       ;
 
     basicOpts.add(systemopts).add(engineopts);
@@ -86,6 +91,9 @@ namespace dynamo {
     Engine::getCommonOptions(detailedEngineOpts);
     EReplicaExchangeSimulation::getOptions(detailedEngineOpts);
     ECompressingSimulation::getOptions(detailedEngineOpts);
+    EReplay::getOptions(detailedEngineOpts);
+    EBatchSimulation::getOptions(detailedEngineOpts);
+    EDistributedReplicaExchange::getOptions(detailedEngineOpts);
   
     allopts.add(basicOpts).add(detailedEngineOpts);
 
@@ -136,6 +144,9 @@ namespace dynamo {
 	sigaction (SIGTERM, &new_action, NULL);
     }
 
+    if (vm.count("thread-affinity"))
+      _threads.setThreadAffinity(true);
+
     if (vm.count("n-threads"))
       _threads.setThreadCount(vm["n-threads"].as<unsigned int>());
 
@@ -150,6 +161,15 @@ namespace dynamo {
       case (3):
 	_engine = shared_ptr<ECompressingSimulation>(new ECompressingSimulation(vm, _threads));
 	break;
+      case (4):
+	_engine = shared_ptr<EReplay>(new EReplay(vm, _threads));
+	break;
+      case (5):
+	_engine = shared_ptr<EBatchSimulation>(new EBatchSimulation(vm, _threads));
+	break;
+      case (6):
+	_engine = shared_ptr<EDistributedReplicaExchange>(new EDistributedReplicaExchange(vm, _threads));
+	break;
       default:
 	M_throw() << vm["engine"].as<size_t>()
 		  <<", Unknown Engine Number Selected"; 
@@ -0,0 +1,306 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/coordinator/engine/batch.hpp>
+#include <dynamo/interactions/stepped.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/systems/snapshot.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/string/searchreplace.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+
+namespace dynamo {
+  namespace {
+    /*! \brief The largest Potential which is calculated in full to
+      be shared between the Simulations.
+     */
+    const size_t maxSharedSteps = 100000;
+  }
+
+  void
+  EBatchSimulation::getOptions(boost::program_options::options_description& opts)
+  {
+    boost::program_options::options_description
+      bopts("Batch Engine Options (--engine=5)");
+
+    bopts.add_options()
+      ("batch-copies", boost::program_options::value<size_t>()->default_value(1),
+       "No. of independent runs of each configuration file. Each copy is given its own random numbers.")
+      ;
+
+    opts.add(bopts);
+  }
+
+  EBatchSimulation::EBatchSimulation(const boost::program_options::variables_map& nVm,
+				     magnet::thread::ThreadPool& tp):
+    Engine(nVm, "config.%ID.end.xml.bz2", "output.%ID.xml.bz2", tp),
+    _copies(1),
+    _executed(false),
+    _finished(0)
+  {}
+
+  void
+  EBatchSimulation::preSimInit()
+  {
+    Engine::preSimInit();
+
+    if (configFormat.find("%ID") == configFormat.npos)
+      M_throw() << "Batch mode, but format string for config file output"
+	" doesnt contain %ID";
+
+    if (outputFormat.find("%ID") == outputFormat.npos)
+      M_throw() << "Batch mode, but format string for output"
+	" file doesnt contain %ID";
+
+    _copies = vm["batch-copies"].as<size_t>();
+    if (!_copies)
+      M_throw() << "You must run at least one copy of each configuration file";
+
+    _runs.clear();
+    for (const std::string& file : vm["config-file"].as<std::vector<std::string> >())
+      for (size_t copy(0); copy < _copies; ++copy)
+	_runs.push_back(RunData(file, copy));
+  }
+
+  void
+  EBatchSimulation::initialisation()
+  {
+    preSimInit();
+  }
+
+  void
+  EBatchSimulation::setupSim(Simulation& Sim, const std::string filename)
+  {
+    Engine::setupSim(Sim, filename);
+
+    if (_copies > 1)
+      {
+	Sim.randomStreams = Sim.randomStreams.split(_runs[Sim.simID].copy);
+
+	//The random seed gives every Simulation the same ranGenerator
+	if (vm.count("random-seed"))
+	  Sim.ranGenerator.seed(Sim.randomStreams.getStream(0)());
+      }
+
+    sharePotentials(Sim);
+  }
+
+  void
+  EBatchSimulation::sharePotentials(Simulation& Sim)
+  {
+    for (const shared_ptr<Interaction>& interaction : Sim.interactions)
+      {
+	IStepped* stepped = dynamic_cast<IStepped*>(interaction.get());
+	if (!stepped) continue;
+
+	const shared_ptr<Potential> potential = stepped->getPotential();
+
+	//The step cache of a Potential is not thread safe, so only
+	//Potentials which can be calculated in full are shared.
+	const size_t steps = potential->steps();
+	if (steps > maxSharedSteps) continue;
+
+	std::ostringstream os;
+	{
+	  magnet::xml::XmlStream XML(os);
+	  XML << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+	      << *potential;
+	}
+
+	std::lock_guard<std::mutex> lock(_potentialLock);
+	shared_ptr<Potential>& shared = _potentials[os.str()];
+	if (!shared)
+	  {
+	    if (steps) (*potential)[steps - 1];
+	    shared = potential;
+	  }
+
+	stepped->setPotential(shared);
+      }
+  }
+
+  void
+  EBatchSimulation::runTask(size_t ID, bool runEvents)
+  {
+    RunData& data = _runs[ID];
+
+    //Don't start any new runs once the runs are stopped
+    if (_SIGINT || _SIGTERM) return;
+
+    const std::chrono::system_clock::time_point start = std::chrono::system_clock::now();
+    const std::string IDString = boost::lexical_cast<std::string>(ID);
+
+    //The runs are the parallel tasks of the batch, so each run loads
+    //and writes its configuration on its own thread (the threads of
+    //the Simulation are left NULL).
+    Simulation Sim;
+    Sim.simID = ID;
+
+    try {
+      setupSim(Sim, data.configFile);
+
+      if (vm.count("snapshot"))
+	Sim.systems.push_back(shared_ptr<System>(new SysSnapshot(&Sim, vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+
+      Sim.initialise();
+
+      postSimInit(Sim);
+
+      if (vm.count("ticker-period"))
+	Sim.setTickerPeriod(vm["ticker-period"].as<double>());
+
+      data.N = Sim.N;
+      data.status = "Complete";
+
+      if (runEvents)
+	while (Sim.runSimulationStep(true))
+	  if (_SIGINT || _SIGTERM)
+	    {
+	      data.status = "Stopped";
+	      break;
+	    }
+
+      Sim.outputData(magnet::string::search_replace(outputFormat, "%ID", IDString));
+
+      if (runEvents)
+	Sim.writeXMLfile(magnet::string::search_replace(configFormat, "%ID", IDString), !vm.count("unwrapped"));
+
+      data.events = Sim.eventCount;
+      data.systemTime = Sim.systemTime / Sim.units.unitTime();
+      data.kT = Sim.dynamics->getkT() / Sim.units.unitEnergy();
+      data.internalEnergy = Sim.calcInternalEnergy() / (Sim.N * Sim.units.unitEnergy());
+    }
+    catch (std::exception& cep)
+      {
+	//A failed run does not stop the other runs
+	data.status = "Failed";
+	std::cerr << "\nEngine: Run " << ID << " (" << data.configFile
+		  << ") failed:-\n" << cep.what();
+
+	if (Sim.status >= INITIALISED && Sim.status != ERROR)
+	  try {
+	    std::cerr << "\nEngine: Trying to output config to config.error." << ID << ".xml.bz2";
+	    Sim.writeXMLfile("config.error." + IDString + ".xml.bz2", !vm.count("unwrapped"));
+	  } catch (...)
+	    {
+	      std::cerr << "\nEngine: Could not output error config";
+	    }
+
+	std::cerr << std::endl;
+      }
+
+    data.wallTime = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(_progressLock);
+    std::cout << "\rBatch run " << ID << " " << data.status
+	      << ", " << ++_finished << "/" << _runs.size() << " runs finished" << std::endl;
+  }
+
+  void
+  EBatchSimulation::runSimulation()
+  {
+    _start_time = std::chrono::system_clock::now();
+
+    //The largest configurations are run first, so the small runs
+    //fill in the gaps at the end of the batch.
+    std::vector<std::pair<uintmax_t, size_t> > order;
+    for (size_t ID(0); ID < _runs.size(); ++ID)
+      {
+	boost::system::error_code error;
+	uintmax_t size = boost::filesystem::file_size(_runs[ID].configFile, error);
+	order.push_back(std::make_pair(error ? 0 : size, ID));
+      }
+
+    std::stable_sort(order.begin(), order.end(),
+		     [](const std::pair<uintmax_t, size_t>& a, const std::pair<uintmax_t, size_t>& b)
+		     { return a.first > b.first; });
+
+    std::vector<std::function<void()> > tasks;
+    tasks.reserve(_runs.size());
+    for (const std::pair<uintmax_t, size_t>& run : order)
+      tasks.push_back(std::bind(&EBatchSimulation::runTask, this, run.second, vm["events"].as<size_t>() != 0));
+
+    threads.queueTasks(tasks);
+    threads.wait();
+
+    _executed = true;
+    _end_time = std::chrono::system_clock::now();
+  }
+
+  void
+  EBatchSimulation::outputData()
+  {
+    if (!_executed) runSimulation();
+
+    size_t totalEvents(0), complete(0), failed(0);
+
+    {
+      std::fstream batchof("batch.dat", std::ios::out | std::ios::trunc);
+
+      batchof << "#ID Copy Status N Events SystemTime kT U/N WallTime ConfigFile\n"
+	      << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+
+      for (size_t ID(0); ID < _runs.size(); ++ID)
+	{
+	  const RunData& data = _runs[ID];
+	  batchof << ID << " "
+		  << data.copy << " "
+		  << data.status << " "
+		  << data.N << " "
+		  << data.events << " "
+		  << data.systemTime << " "
+		  << data.kT << " "
+		  << data.internalEnergy << " "
+		  << data.wallTime << " "
+		  << data.configFile
+		  << "\n";
+
+	  totalEvents += data.events;
+	  complete += (data.status == "Complete");
+	  failed += (data.status == "Failed");
+	}
+
+      batchof.close();
+    }
+
+    {
+      std::fstream batchof("batch.stats", std::ios::out | std::ios::trunc);
+
+      const double duration = std::chrono::duration<double>(_end_time - _start_time).count();
+
+      batchof << "Number_of_runs " << _runs.size()
+	      << "\nComplete_runs " << complete
+	      << "\nFailed_runs " << failed
+	      << "\nTotal_events " << totalEvents
+	      << "\nTime_spent_running " << duration << "s"
+	      << "\nEvent_rate " << totalEvents / duration
+	      << "\nRun_rate " << _runs.size() / duration
+	      << "\n";
+
+      batchof.close();
+    }
+
+    std::cout << "\nBatch: " << complete << "/" << _runs.size() << " runs complete, "
+	      << failed << " failed. Summary written to batch.dat and batch.stats" << std::endl;
+  }
+}
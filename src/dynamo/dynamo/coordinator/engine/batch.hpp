@@ -0,0 +1,169 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file batch.hpp
+ * Holds the definition of the EBatchSimulation class.
+ */
+
+#pragma once
+
+#include <dynamo/coordinator/engine/engine.hpp>
+#include <dynamo/interactions/potentials/potential.hpp>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace dynamo {
+  /*! \brief An Engine to run many small, independent Simulations.
+
+    Parameter sweeps often require thousands of small systems, which
+    would otherwise each pay the start up cost of a dynarun
+    process. This Engine runs each configuration file (or several
+    copies of each, see getOptions()) as an independent task on the
+    ThreadPool. Each task loads, runs and writes out its Simulation
+    before releasing it, so there are no barriers between the runs
+    and only one Simulation per thread is held in memory. The tasks
+    are queued largest configuration file first, and each thread
+    takes the next task once it is idle, which balances the load.
+
+    Identical stepped Potentials (e.g., the step table of a
+    Lennard-Jones potential) are only calculated once, and are shared
+    between the Simulations.
+
+    A summary of every run is written once all of the runs are
+    complete.
+   */
+  class EBatchSimulation: public Engine
+  {
+  public:
+    /*! \brief The only constructor.
+
+      \param vm The parsed command line options held by the Coordinator.
+      \param tp The ThreadPool for this instance of dynarun.
+     */
+    EBatchSimulation(const boost::program_options::variables_map& vm,
+		     magnet::thread::ThreadPool& tp);
+
+    /*! \brief A trivial virtual destructor.
+     */
+    virtual ~EBatchSimulation() {}
+
+    /*! \brief Builds the list of runs.
+
+      The configuration files are loaded by the tasks which run them.
+     */
+    virtual void initialisation();
+
+    /*! \brief Run every Simulation, writing out the data and
+      configuration of each as soon as it is complete.
+
+      A SIGINT or SIGTERM stops every run, which then write out their
+      data and configurations. Runs which have not yet started are
+      skipped.
+     */
+    virtual void runSimulation();
+
+    /*! \brief Write out the summary of the runs.
+
+      If the runs were not run (i.e., zero events were requested), the
+      Simulations are loaded and their data written out first.
+     */
+    virtual void outputData();
+
+    /*! \brief The configurations are written out by each run.
+     */
+    virtual void outputConfigs() {}
+
+    /*! \brief No finalisation is required in this engine.
+     */
+    virtual void finaliseRun() {}
+
+    /*! \brief Return the options for the EBatchSimulation Engine.
+     */
+    static void getOptions(boost::program_options::options_description&);
+
+  protected:
+    //! \brief The state and results of a single run.
+    struct RunData
+    {
+      RunData(std::string file, size_t copy):
+	configFile(file), copy(copy), status("Skipped"), N(0),
+	events(0), systemTime(0), kT(0), internalEnergy(0), wallTime(0)
+      {}
+
+      std::string configFile;
+      //! \brief Which copy of the configuration file this run is.
+      size_t copy;
+      std::string status;
+      size_t N;
+      size_t events;
+      double systemTime;
+      double kT;
+      //! \brief The configurational energy per particle.
+      double internalEnergy;
+      //! \brief The seconds taken to load, run and write out the Simulation.
+      double wallTime;
+    };
+
+    virtual void preSimInit();
+
+    /*! \brief Sets up each simulation.
+
+      Each copy of a configuration file is given its own random
+      numbers, and the Potentials of the Simulation are replaced with
+      the shared ones.
+     */
+    virtual void setupSim(Simulation&, const std::string);
+
+    /*! \brief The task run for each Simulation.
+
+      \param ID The index of the run in _runs, which is also used as
+      the Simulation::simID and the %ID of its output files.
+      \param runEvents If false, the Simulation is only loaded and its
+      data written out.
+     */
+    void runTask(size_t ID, bool runEvents);
+
+    /*! \brief Replace the Potentials of a Simulation with the
+      identical Potentials of previously loaded Simulations.
+     */
+    void sharePotentials(Simulation&);
+
+    std::vector<RunData> _runs;
+
+    //! \brief The number of runs of each configuration file.
+    size_t _copies;
+
+    //! \brief Set once the runs have been run.
+    bool _executed;
+
+    //! \brief The number of runs that have finished.
+    size_t _finished;
+
+    std::mutex _progressLock;
+
+    /*! \brief The shared Potentials, keyed by their XML
+      representation.
+     */
+    std::map<std::string, shared_ptr<Potential> > _potentials;
+
+    std::mutex _potentialLock;
+
+    std::chrono::system_clock::time_point _start_time;
+
+    std::chrono::system_clock::time_point _end_time;
+  };
+}
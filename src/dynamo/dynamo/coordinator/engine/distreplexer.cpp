@@ -0,0 +1,433 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/coordinator/engine/distreplexer.hpp>
+#include <dynamo/systems/tHalt.hpp>
+#include <dynamo/systems/andersenThermostat.hpp>
+#include <dynamo/dynamics/multicanonical.hpp>
+#include <dynamo/outputplugins/misc.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <magnet/string/searchreplace.hpp>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+namespace dynamo {
+  void
+  EDistributedReplicaExchange::getOptions(boost::program_options::options_description& opts)
+  {
+    boost::program_options::options_description
+      ropts("Distributed REplica EXchange Engine Options (--engine=6)\n"
+	    "Each process runs one replica. The replex-interval and replex-swap-mode options are shared with --engine=2");
+
+    ropts.add_options()
+      ("replex-replicas", boost::program_options::value<size_t>(),
+       "Run the replica exchange server in this process, for this total number of replicas (including "
+       "this process). The other replicas are started without this option, and connect to this process.")
+      ("replex-host", boost::program_options::value<std::string>()->default_value("localhost"),
+       "The host running the replica exchange server.")
+      ("replex-port", boost::program_options::value<unsigned short>()->default_value(28600),
+       "The TCP port of the replica exchange server.")
+      ;
+
+    opts.add(ropts);
+  }
+
+  EDistributedReplicaExchange::EDistributedReplicaExchange(const boost::program_options::variables_map& nVm,
+							   magnet::thread::ThreadPool& tp):
+    Engine(nVm, "config.%ID.end.xml.bz2", "output.%ID.xml.bz2", tp),
+    _server(false),
+    _replicaID(0),
+    _rank(0),
+    _coldTime(0),
+    _replicaEndTime(0),
+    _replexSwapCalls(0),
+    _seqSelect(false)
+  {
+    if (vm["events"].as<size_t>() != std::numeric_limits<size_t>::max())
+      M_throw() << "You cannot use collisions to control a replica exchange simulation";
+
+    simulation.threads = &threads;
+  }
+
+  void
+  EDistributedReplicaExchange::checkConnection(const Connection& connection, const std::string& peer)
+  {
+    if (!connection)
+      M_throw() << "Lost the connection to " << peer << "\n" << connection.error().message();
+  }
+
+  void
+  EDistributedReplicaExchange::initialisation()
+  {
+    preSimInit();
+
+    if (vm["config-file"].as<std::vector<std::string> >().size() != 1)
+      M_throw() << "Each process of a distributed replica exchange runs a single configuration file";
+
+    if (configFormat.find("%ID") == configFormat.npos)
+      M_throw() << "Replex mode, but format string for config file output"
+	" doesnt contain %ID";
+
+    if (outputFormat.find("%ID") == outputFormat.npos)
+      M_throw() << "Replex mode, but format string for output"
+	" file doesnt contain %ID";
+
+    _replicaEndTime = vm["sim-end-time"].as<double>();
+
+    setupSim(simulation, vm["config-file"].as<std::vector<std::string> >()[0]);
+
+    simulation.initialise();
+
+    postSimInit(simulation);
+
+    if (!dynamic_cast<const EnsembleNVT*>(simulation.ensemble.get()))
+      M_throw() << vm["config-file"].as<std::vector<std::string> >()[0]
+		<< " does not have an NVT ensemble";
+
+    if (!std::dynamic_pointer_cast<SysAndersen>(simulation.systems["Thermostat"]))
+      M_throw() << "Could not find the Andersen Thermostat for the replica";
+
+    //The multicanonical weights of both replicas are needed to
+    //attempt a swap, but the replicas only exchange their energies
+    if (std::dynamic_pointer_cast<DynNewtonianMC>(simulation.dynamics))
+      M_throw() << "Multicanonical simulations are not supported by the distributed replica exchange, use --engine=2";
+
+    if (!simulation.getOutputPlugin<OPMisc>())
+      M_throw() << "The Misc output plugin is needed to calculate the exchange probabilities";
+
+    if (vm.count("ticker-period"))
+      simulation.setTickerPeriod(vm["ticker-period"].as<double>());
+
+    _server = vm.count("replex-replicas");
+    if (_server)
+      startServer();
+    else
+      connectToServer();
+  }
+
+  void
+  EDistributedReplicaExchange::setupSim(Simulation& Sim, const std::string filename)
+  {
+    Engine::setupSim(Sim, filename);
+
+    //Add the halt time, set to zero so a replica exchange occurrs immediately
+    Sim.systems.push_back(shared_ptr<System>(new SystHalt(&Sim, 0, "ReplexHalt")));
+  }
+
+  void
+  EDistributedReplicaExchange::startServer()
+  {
+    const size_t nReplicas = vm["replex-replicas"].as<size_t>();
+    if (nReplicas < 1)
+      M_throw() << "There must be at least one replica";
+
+    _replicas.resize(nReplicas);
+    _energies.resize(nReplicas, 0);
+    _temperatures.clear();
+    _temperatures.push_back(TemperatureData(simulation.ensemble->getReducedEnsembleVals()[2], 0));
+
+    using boost::asio::ip::tcp;
+    boost::asio::io_context io;
+    tcp::acceptor acceptor(io, tcp::endpoint(tcp::v4(), vm["replex-port"].as<unsigned short>()));
+
+    std::cout << "Replica exchange server waiting for " << nReplicas - 1
+	      << " replicas on port " << vm["replex-port"].as<unsigned short>() << std::endl;
+
+    for (size_t ID(1); ID < nReplicas; ++ID)
+      {
+	_replicas[ID].reset(new Connection);
+	acceptor.accept(_replicas[ID]->socket());
+	_replicas[ID]->socket().set_option(tcp::no_delay(true));
+	*_replicas[ID] << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+
+	const std::string peer = "replica " + boost::lexical_cast<std::string>(ID);
+	std::string message;
+	size_t N;
+	double kT;
+	*_replicas[ID] >> message >> N >> kT;
+	checkConnection(*_replicas[ID], peer);
+
+	if (message != "REPLICA")
+	  M_throw() << "Unexpected message \"" << message << "\" from " << peer;
+
+	if (N != simulation.N)
+	  M_throw() << "Every replica configuration file must have the same number of particles!";
+
+	_temperatures.push_back(TemperatureData(kT, ID));
+	*_replicas[ID] << "ID " << ID << std::endl;
+
+	std::cout << "Replica " << ID << " connected at kT=" << kT << std::endl;
+      }
+
+    std::sort(_temperatures.begin(), _temperatures.end());
+  }
+
+  void
+  EDistributedReplicaExchange::connectToServer()
+  {
+    const std::string host = vm["replex-host"].as<std::string>();
+    const std::string port = boost::lexical_cast<std::string>(vm["replex-port"].as<unsigned short>());
+    const std::string peer = "the replica exchange server at " + host + ":" + port;
+
+    //The server may still be loading its configuration
+    for (size_t attempt(0);; ++attempt)
+      {
+	_serverConnection.reset(new Connection(host, port));
+	if (*_serverConnection) break;
+
+	if (attempt == 60)
+	  M_throw() << "Could not connect to " << peer << "\n" << _serverConnection->error().message();
+
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+      }
+
+    _serverConnection->socket().set_option(boost::asio::ip::tcp::no_delay(true));
+    *_serverConnection << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+		       << "REPLICA " << simulation.N << " "
+		       << simulation.ensemble->getReducedEnsembleVals()[2] << std::endl;
+
+    std::string message;
+    *_serverConnection >> message >> _replicaID;
+    checkConnection(*_serverConnection, peer);
+
+    if (message != "ID")
+      M_throw() << "Unexpected message \"" << message << "\" from " << peer;
+
+    std::cout << "Connected to " << peer << " as replica " << _replicaID << std::endl;
+  }
+
+  void
+  EDistributedReplicaExchange::replexSwap(unsigned int mode)
+  {
+    if (_temperatures.size() < 2) return;
+
+    switch (mode)
+      {
+      case 0: //No swapping
+	break;
+      case 1: //Alternating sets of pairs
+	for (size_t i = _seqSelect ? 0 : 1; i + 1 < _temperatures.size(); i += 2)
+	  attemptSwap(i, i + 1);
+	_seqSelect = !_seqSelect;
+	break;
+      case 2: //A random pair
+	{
+	  std::uniform_int_distribution<size_t> tmpDist(0, _temperatures.size() - 2);
+	  const size_t ID = tmpDist(simulation.ranGenerator);
+	  attemptSwap(ID, ID + 1);
+	}
+	break;
+      case 3: //5 * Nsims random pairs
+	{
+	  std::uniform_int_distribution<size_t> tmpDist(0, _temperatures.size() - 1);
+	  for (size_t i(0); i < 5 * _temperatures.size(); ++i)
+	    {
+	      const size_t ID1 = tmpDist(simulation.ranGenerator);
+	      size_t ID2 = tmpDist(simulation.ranGenerator);
+	      while (ID2 == ID1)
+		ID2 = tmpDist(simulation.ranGenerator);
+	      attemptSwap(ID1, ID2);
+	    }
+	}
+	break;
+      case 4: //Random selection of the above
+	{
+	  std::uniform_int_distribution<size_t> tmpDist(0, 1);
+	  replexSwap(tmpDist(simulation.ranGenerator) ? 3 : 1);
+	}
+	break;
+      default:
+	M_throw() << "Unknown replica exchange swap mode " << mode;
+      }
+  }
+
+  void
+  EDistributedReplicaExchange::attemptSwap(size_t T1, size_t T2)
+  {
+    TemperatureData& data1 = _temperatures[T1];
+    TemperatureData& data2 = _temperatures[T2];
+
+    ++data1.attempts;
+    ++data2.attempts;
+
+    //This is -\Delta in the Sugita_Okamoto paper, see
+    //EnsembleNVT::exchangeProbability
+    const double factor = (_energies[data1.replica] - _energies[data2.replica])
+      * (1 / data1.kT - 1 / data2.kT);
+
+    std::uniform_real_distribution<> uniform_dist;
+    if (std::exp(factor) > uniform_dist(simulation.ranGenerator))
+      {
+	std::swap(data1.replica, data2.replica);
+	++data1.swaps;
+	++data2.swaps;
+      }
+  }
+
+  void
+  EDistributedReplicaExchange::applyExchange(double kT, double interval)
+  {
+    if (kT != simulation.ensemble->getReducedEnsembleVals()[2])
+      simulation.replexerSetTemperature(kT * simulation.units.unitEnergy());
+
+    shared_ptr<SystHalt> halt = std::dynamic_pointer_cast<SystHalt>(simulation.systems["ReplexHalt"]);
+#ifdef DYNAMO_DEBUG
+    if (!halt)
+      M_throw() << "Could not find the time halt event error";
+#endif
+    halt->increasedt(interval);
+    simulation.ptrScheduler->rebuildSystemEvents();
+
+    //Reset the max collisions
+    simulation.endEventCount = vm["events"].as<size_t>();
+    ++simulation.replexExchangeNumber;
+  }
+
+  void
+  EDistributedReplicaExchange::runSimulation()
+  {
+    _start_time = std::chrono::system_clock::now();
+
+    const double interval = vm["replex-interval"].as<double>();
+
+    for (;;)
+      {
+	//Run until the next exchange
+	simulation.runSimulation(true);
+
+	const double U = simulation.getOutputPlugin<OPMisc>()->getConfigurationalU() / simulation.units.unitEnergy();
+	bool stop = _SIGINT || _SIGTERM;
+
+	if (!_server)
+	  {
+	    const std::string peer = "the replica exchange server";
+	    *_serverConnection << "ENERGY " << U << " " << stop << std::endl;
+
+	    std::string message;
+	    *_serverConnection >> message;
+	    checkConnection(*_serverConnection, peer);
+
+	    if (message == "STOP")
+	      {
+		*_serverConnection >> _rank;
+		checkConnection(*_serverConnection, peer);
+		break;
+	      }
+	    else if (message != "RUN")
+	      M_throw() << "Unexpected message \"" << message << "\" from " << peer;
+
+	    double kT, dt;
+	    *_serverConnection >> kT >> dt;
+	    checkConnection(*_serverConnection, peer);
+	    applyExchange(kT, dt);
+	    continue;
+	  }
+
+	//The server collects the energies of every replica
+	_energies[0] = U;
+	for (size_t ID(1); ID < _replicas.size(); ++ID)
+	  {
+	    const std::string peer = "replica " + boost::lexical_cast<std::string>(ID);
+	    std::string message;
+	    bool replicaStop;
+	    *_replicas[ID] >> message >> _energies[ID] >> replicaStop;
+	    checkConnection(*_replicas[ID], peer);
+
+	    if (message != "ENERGY")
+	      M_throw() << "Unexpected message \"" << message << "\" from " << peer;
+
+	    stop |= replicaStop;
+	  }
+
+	if (stop || (_coldTime >= _replicaEndTime))
+	  {
+	    for (size_t rank(0); rank < _temperatures.size(); ++rank)
+	      if (_temperatures[rank].replica)
+		*_replicas[_temperatures[rank].replica] << "STOP " << rank << std::endl;
+	      else
+		_rank = rank;
+	    break;
+	  }
+
+	replexSwap(vm["replex-swap-mode"].as<unsigned int>());
+	++_replexSwapCalls;
+
+	//Each exchange interval is inversely proportional to the
+	//square root of the temperature, to try to keep the
+	//calculation times of the replicas equal
+	for (const TemperatureData& data : _temperatures)
+	  {
+	    const double dt = interval * std::sqrt(_temperatures.front().kT / data.kT);
+	    if (data.replica)
+	      *_replicas[data.replica] << "RUN " << data.kT << " " << dt << std::endl;
+	    else
+	      applyExchange(data.kT, dt);
+	  }
+
+	_coldTime += interval;
+
+	std::cout << "\rReplica Exchange No." << _replexSwapCalls
+		  << ", time " << _coldTime << "/" << _replicaEndTime << "        ";
+	std::cout.flush();
+      }
+
+    _end_time = std::chrono::system_clock::now();
+  }
+
+  void
+  EDistributedReplicaExchange::outputData()
+  {
+    if (_server)
+      {
+	{
+	  std::fstream replexof("replex.dat", std::ios::out | std::ios::trunc);
+
+	  for (const TemperatureData& data : _temperatures)
+	    replexof << data.kT << " "
+		     << data.swaps << " "
+		     << (static_cast<double>(data.swaps) / static_cast<double>(data.attempts))
+		     << "\n";
+
+	  replexof.close();
+	}
+
+	{
+	  std::fstream replexof("replex.stats", std::ios::out | std::ios::trunc);
+
+	  const double duration = std::chrono::duration<double>(_end_time - _start_time).count();
+	  replexof << "Number_of_replex_cycles " << _replexSwapCalls
+		   << "\nNumber_of_replicas " << _temperatures.size()
+		   << "\nTime_spent_replexing " << duration << "s"
+		   << "\nReplex Rate " << static_cast<double>(_replexSwapCalls) / duration
+		   << "\n";
+
+	  replexof.close();
+	}
+      }
+
+    simulation.outputData(magnet::string::search_replace(outputFormat, "%ID", boost::lexical_cast<std::string>(_rank)));
+  }
+
+  void
+  EDistributedReplicaExchange::outputConfigs()
+  {
+    simulation.writeXMLfile(magnet::string::search_replace(configFormat, "%ID", boost::lexical_cast<std::string>(_rank)),
+			    !vm.count("unwrapped"));
+  }
+}
@@ -0,0 +1,192 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file distreplexer.hpp
+ * Holds the definition of the EDistributedReplicaExchange class.
+ */
+
+#pragma once
+
+#include <dynamo/coordinator/engine/engine.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <memory>
+
+namespace dynamo {
+  /*! \brief A Replica Exchange/Parallel Tempering Engine where each
+    replica runs in its own dynarun process.
+
+    Unlike the EReplicaExchangeSimulation, which holds every replica
+    in a single process, each process of this Engine runs a single
+    replica, so the replicas may be spread over the cores and memory
+    of several hosts. One process (started with --replex-replicas)
+    acts as the server, and the other processes connect to it over
+    TCP.
+
+    The replicas only exchange their temperatures. At each exchange,
+    every replica sends its configurational energy to the server,
+    which attempts the replica exchange moves and replies with the
+    new temperature of each replica (and the time to run until the
+    next exchange). Each replica then rescales its own velocities (see
+    Simulation::replexerSetTemperature()), so the configurations never
+    leave their processes.
+
+    As the data collected by the OutputPlugins stays with the
+    configuration, it is collected over every temperature the replica
+    visits. The configuration and data files of each replica are
+    numbered by its final temperature, coldest first, as in the
+    EReplicaExchangeSimulation.
+
+    The protocol is a short text message per replica per exchange:
+    - On connecting: "REPLICA N kT", answered with "ID id".
+    - At each exchange: "ENERGY U stop", answered with "RUN kT
+      interval" or "STOP rank".
+
+    where all values are in reduced units, and a non-zero stop
+    requests that all of the replicas are stopped.
+   */
+  class EDistributedReplicaExchange: public Engine
+  {
+  public:
+    /*! \brief The only constructor.
+
+      \param vm The parsed command line options held by the Coordinator.
+      \param tp The ThreadPool for this instance of dynarun.
+     */
+    EDistributedReplicaExchange(const boost::program_options::variables_map& vm,
+				magnet::thread::ThreadPool& tp);
+
+    /*! \brief A trivial virtual destructor.
+     */
+    virtual ~EDistributedReplicaExchange() {}
+
+    /*! \brief Load the replica and connect the processes.
+
+      The server waits until every replica has connected.
+     */
+    virtual void initialisation();
+
+    /*! \brief Run the replica, exchanging temperatures periodically
+      until the server stops the replicas.
+     */
+    virtual void runSimulation();
+
+    /*! \brief Output the data of the replica, and (on the server)
+      the statistics of the replica exchange.
+     */
+    virtual void outputData();
+
+    /*! \brief Output the configuration of the replica.
+     */
+    virtual void outputConfigs();
+
+    /*! \brief No finalisation is required in this engine.
+     */
+    virtual void finaliseRun() {}
+
+    /*! \brief Return the options for the EDistributedReplicaExchange Engine.
+     */
+    static void getOptions(boost::program_options::options_description&);
+
+  protected:
+    typedef boost::asio::ip::tcp::iostream Connection;
+
+    //! \brief The server's data on a temperature.
+    struct TemperatureData
+    {
+      TemperatureData(double T, size_t ID):
+	kT(T), replica(ID), swaps(0), attempts(0)
+      {}
+
+      bool operator<(const TemperatureData& other) const
+      { return kT < other.kT; }
+
+      //! \brief The temperature in reduced units.
+      double kT;
+      //! \brief The replica currently at this temperature.
+      size_t replica;
+      size_t swaps;
+      size_t attempts;
+    };
+
+    virtual void setupSim(Simulation&, const std::string);
+
+    //! \brief Accept the connections of the other replicas.
+    void startServer();
+
+    //! \brief Connect to the server, retrying until it is available.
+    void connectToServer();
+
+    /*! \brief Carry out a replica exchange phase on the server.
+
+      The types of phase are the Replex_Mode_Type's of the
+      EReplicaExchangeSimulation.
+     */
+    void replexSwap(unsigned int mode);
+
+    //! \brief Attempt to exchange the replicas at two temperatures.
+    void attemptSwap(size_t T1, size_t T2);
+
+    /*! \brief Move the replica to a new temperature, and set the
+      time until the next exchange.
+
+      \param kT The new temperature in reduced units.
+      \param interval The time to the next exchange in reduced units.
+     */
+    void applyExchange(double kT, double interval);
+
+    //! \brief Throw an error if a connection has failed.
+    static void checkConnection(const Connection&, const std::string& peer);
+
+    Simulation simulation;
+
+    //! \brief Whether this process runs the server.
+    bool _server;
+
+    /*! \brief The ID of this replica (the server is replica 0), and
+      the rank of its temperature once it is stopped.
+     */
+    size_t _replicaID;
+    size_t _rank;
+
+    //! \brief The connection to the server of a replica.
+    std::unique_ptr<Connection> _serverConnection;
+
+    //! \brief The connections to each replica on the server (the first is unused).
+    std::vector<std::unique_ptr<Connection> > _replicas;
+
+    //! \brief The temperatures of the replica exchange, in ascending order.
+    std::vector<TemperatureData> _temperatures;
+
+    //! \brief The configurational energy of each replica at the current exchange.
+    std::vector<double> _energies;
+
+    /*! \brief The time the coldest temperature has been simulated
+      for, which decides when the replica exchange ends.
+     */
+    double _coldTime;
+
+    double _replicaEndTime;
+
+    size_t _replexSwapCalls;
+
+    bool _seqSelect;
+
+    std::chrono::system_clock::time_point _start_time;
+
+    std::chrono::system_clock::time_point _end_time;
+  };
+}
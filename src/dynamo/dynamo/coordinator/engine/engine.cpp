@@ -17,6 +17,7 @@
  
 #include <dynamo/coordinator/engine/engine.hpp>
 #include <dynamo/coordinator/engine/replexer.hpp>
+#include <dynamo/coordinator/engine/distreplexer.hpp>
 #include <dynamo/inputplugins/compression.hpp>
 #include <dynamo/systems/tHalt.hpp>
 #include <dynamo/systems/visualizer.hpp>
@@ -48,6 +49,9 @@ namespace dynamo {
       ("unwrapped", "Don't apply the boundary conditions of the system when writing out the particle positions.")
       ("snapshot", boost::program_options::value<double>(),
        "Sets the system time inbetween saving snapshots of the system.")
+      ("analysis-threads", boost::program_options::value<size_t>()->default_value(0),
+       "No. of threads to run the thread-safe output plugins on (e.g., CollisionMatrix, EventEffects), "
+       "in parallel with the simulation. If zero, they run on the simulation thread.")
       ;
   
     opts.add(simopts);
@@ -75,8 +79,6 @@ namespace dynamo {
       outputFormat = vm["out-data-file"].as<std::string>();
   }
 
-  class EReplicaExchangeSimulation;
-
   void 
   Engine::setupSim(Simulation& Sim, const std::string filename)
   {
@@ -86,9 +88,15 @@ namespace dynamo {
     ////////////////////////Simulation Initialisation!!!!!!!!!!!!!
     //Now load the config
     Sim.loadXMLfile(filename.c_str());
+
+    //The seed overrides the streams of the config, each replica is
+    //given its own family of streams
+    if (vm.count("random-seed"))
+      Sim.randomStreams = RandomStreams(vm["random-seed"].as<unsigned int>()).split(Sim.simID);
     
     Sim.status = CONFIG_LOADED;
     Sim.endEventCount = vm["events"].as<size_t>();
+    Sim.outputPluginBus.setAnalysisThreads(vm["analysis-threads"].as<size_t>());
   
     if (vm["events"].as<size_t>() 
 	> vm["print-events"].as<size_t>())
@@ -96,7 +104,8 @@ namespace dynamo {
     else
       Sim.eventPrintInterval = vm["events"].as<size_t>();
     
-    if (vm.count("sim-end-time") && (dynamic_cast<const EReplicaExchangeSimulation*>(this) == NULL))
+    if (vm.count("sim-end-time") && (dynamic_cast<const EReplicaExchangeSimulation*>(this) == NULL)
+	&& (dynamic_cast<const EDistributedReplicaExchange*>(this) == NULL))
       Sim.systems.push_back(shared_ptr<System>(new SystHalt(&Sim, vm["sim-end-time"].as<double>(), "SystemStopEvent")));
 
 #ifdef DYNAMO_visualizer
@@ -18,3 +18,6 @@
 #include <dynamo/coordinator/engine/replexer.hpp>
 #include <dynamo/coordinator/engine/single.hpp>
 #include <dynamo/coordinator/engine/compressor.hpp>
+#include <dynamo/coordinator/engine/replay.hpp>
+#include <dynamo/coordinator/engine/batch.hpp>
+#include <dynamo/coordinator/engine/distreplexer.hpp>
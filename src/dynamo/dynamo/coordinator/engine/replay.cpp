@@ -0,0 +1,449 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/coordinator/engine/replay.hpp>
+#include <dynamo/systems/sysTicker.hpp>
+#include <dynamo/systems/sleep.hpp>
+#include <dynamo/systems/umbrella.hpp>
+#include <dynamo/systems/rotateGravity.hpp>
+#include <dynamo/interactions/captures.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/globals/global.hpp>
+#include <dynamo/globals/globEvent.hpp>
+#include <dynamo/locals/local.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <dynamo/outputplugins/tickerproperty/ticker.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/species/species.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+
+namespace dynamo {
+  void
+  EReplay::getOptions(boost::program_options::options_description& opts)
+  {
+    boost::program_options::options_description ropts("Replay Engine (--engine=4)");
+
+    ropts.add_options()
+      ("replay-trajectory", boost::program_options::value<std::string>(),
+       "The binary trajectory (written by the BinaryTrajectory plugin) to replay")
+      ("replay-checkpoint", boost::program_options::value<std::string>(),
+       "A checkpoint of the trajectory to start the replay from")
+      ;
+
+    opts.add(ropts);
+  }
+
+  EReplay::EReplay(const boost::program_options::variables_map& nVM,
+		   magnet::thread::ThreadPool& tp):
+    ESingleSimulation(nVM, tp),
+    _endEventCount(0),
+    _ticker(NULL)
+  {
+    if (!vm.count("replay-trajectory"))
+      M_throw() << "The replay engine requires a trajectory to replay (--replay-trajectory)";
+  }
+
+  void
+  EReplay::initialisation()
+  {
+    namespace io = boost::iostreams;
+
+    preSimInit();
+
+    if (!(vm.count("config-file")) ||
+	(vm["config-file"].as<std::vector<std::string> >().size() != 1))
+      M_throw() << "You must only provide one input file in replay mode";
+
+    setupSim(simulation, vm["config-file"].as<std::vector<std::string> >()[0]);
+
+    if (simulation.dynamics->hasOrientationData())
+      M_throw() << "Orientational data is not stored in binary trajectories, so this system cannot be replayed";
+
+    for (const shared_ptr<System>& system : simulation.systems)
+      if (std::dynamic_pointer_cast<SysRotateGravity>(system))
+	M_throw() << "The System \"" << system->getName() << "\" changes the gravity vector, which is not "
+	  "stored in binary trajectories, so this system cannot be replayed";
+
+    //Setting the event limit to zero stops the Scheduler from being
+    //initialised, no events are ever predicted during a replay.
+    _endEventCount = simulation.endEventCount;
+    simulation.endEventCount = 0;
+
+    simulation.initialise();
+
+    postSimInit(simulation);
+
+    //These Systems reschedule themselves when particles are updated,
+    //but there is no Scheduler during a replay. Their events are
+    //replayed from the trajectory instead.
+    for (const shared_ptr<System>& system : simulation.systems)
+      {
+	if (SSleep* sleep = dynamic_cast<SSleep*>(system.get()))
+	  simulation._sigParticleUpdate.disconnect<SSleep, &SSleep::particlesUpdated>(sleep);
+	if (SysUmbrella* umbrella = dynamic_cast<SysUmbrella*>(system.get()))
+	  simulation._sigParticleUpdate.disconnect<SysUmbrella, &SysUmbrella::particlesUpdated>(umbrella);
+      }
+
+    if (vm.count("ticker-period"))
+      simulation.setTickerPeriod(vm["ticker-period"].as<double>());
+
+    auto tickerIt = simulation.systems.find("SystemTicker");
+    if (tickerIt != simulation.systems.end())
+      _ticker = dynamic_cast<SysTicker*>(tickerIt->get());
+
+    const std::string fileName = vm["replay-trajectory"].as<std::string>();
+    if (!boost::filesystem::exists(fileName))
+      M_throw() << "Could not find the trajectory file named " << fileName;
+
+    if ((fileName.size() > 4) && (std::string(fileName.end() - 4, fileName.end()) == ".bz2"))
+      _file.push(io::bzip2_decompressor());
+    else if ((fileName.size() > 3) && (std::string(fileName.end() - 3, fileName.end()) == ".gz"))
+      _file.push(io::gzip_decompressor());
+    _file.push(io::file_source(fileName, std::ios::in | std::ios::binary));
+
+    BinaryTrajectoryHeader header;
+    if (!_file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+      M_throw() << "Failed to read the header of " << fileName;
+
+    if (std::strncmp(header.magic, "DYNAMOTR", 8))
+      M_throw() << fileName << " is not a DynamO binary trajectory file";
+
+    if (header.version != BinaryTrajectoryHeader::currentVersion)
+      M_throw() << "Unsupported binary trajectory version " << header.version;
+
+    if ((header.dimensions != NDIM) || (header.recordSize != sizeof(BinaryTrajectoryRecord)))
+      M_throw() << "The binary trajectory was written with a different record layout";
+
+    if (header.N != simulation.N)
+      M_throw() << "The trajectory has " << header.N << " particles but the configuration has " << simulation.N;
+
+    simulation.systemTime = header.startTime * simulation.units.unitTime();
+    simulation.eventCount = header.startEventCount;
+
+    if (vm.count("replay-checkpoint"))
+      {
+	//Skip the records which were written before the checkpoint
+	uint64_t skip = loadCheckpoint(vm["replay-checkpoint"].as<std::string>());
+	std::vector<BinaryTrajectoryRecord> block(4096);
+	while (skip)
+	  {
+	    const size_t count = std::min(skip, uint64_t(block.size()));
+	    if (!_file.read(reinterpret_cast<char*>(block.data()), count * sizeof(BinaryTrajectoryRecord)))
+	      M_throw() << "The trajectory ended before the checkpoint was reached";
+	    skip -= count;
+	  }
+      }
+
+    std::cout << "Replaying " << fileName << " from event " << simulation.eventCount << std::endl;
+  }
+
+  uint64_t
+  EReplay::loadCheckpoint(const std::string& filename)
+  {
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+      M_throw() << "Failed to open the checkpoint file " << filename;
+
+    BinaryCheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+      M_throw() << "Failed to read the header of " << filename;
+
+    if (std::strncmp(header.magic, "DYNAMOCP", 8))
+      M_throw() << filename << " is not a DynamO binary checkpoint file";
+
+    if ((header.version != BinaryCheckpointHeader::currentVersion) || (header.dimensions != NDIM))
+      M_throw() << "Unsupported binary checkpoint version " << header.version;
+
+    if ((header.N != simulation.N) || (header.interactions != simulation.interactions.size()))
+      M_throw() << "The checkpoint " << filename << " does not match the loaded configuration";
+
+    //Synchronise the delayed states before overwriting the particles
+    simulation.dynamics->updateAllParticles();
+
+    std::vector<double> data(2 * NDIM * simulation.N);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double)))
+      M_throw() << "The checkpoint " << filename << " is truncated";
+
+    for (Particle& part : simulation.particles)
+      {
+	const double* ptr = data.data() + 2 * NDIM * part.getID();
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  part.getPosition()[iDim] = ptr[iDim];
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  part.getVelocity()[iDim] = ptr[NDIM + iDim];
+      }
+
+    std::vector<uint32_t> states(simulation.N);
+    if (!file.read(reinterpret_cast<char*>(states.data()), states.size() * sizeof(uint32_t)))
+      M_throw() << "The checkpoint " << filename << " is truncated";
+
+    for (Particle& part : simulation.particles)
+      part.setStates(states[part.getID()]);
+
+    for (shared_ptr<Interaction>& interaction : simulation.interactions)
+      {
+	uint64_t count;
+	if (!file.read(reinterpret_cast<char*>(&count), sizeof(count)))
+	  M_throw() << "The checkpoint " << filename << " is truncated";
+
+	std::vector<uint64_t> entries(3 * count);
+	if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(uint64_t)))
+	  M_throw() << "The checkpoint " << filename << " is truncated";
+
+	ICapture* capture = dynamic_cast<ICapture*>(interaction.get());
+	if (!capture)
+	  {
+	    if (count)
+	      M_throw() << "The checkpoint has capture map entries for the Interaction \""
+			<< interaction->getName() << "\", which does not have a capture map";
+	    continue;
+	  }
+
+	capture->clear();
+	for (size_t i(0); i < count; ++i)
+	  static_cast<detail::CaptureMap&>(*capture)[detail::PairKey(entries[3 * i], entries[3 * i + 1])] = entries[3 * i + 2];
+      }
+
+    simulation.systemTime = header.time * simulation.units.unitTime();
+    simulation.eventCount = header.eventCount;
+
+    std::cout << "Loaded the checkpoint " << filename << " at event " << header.eventCount << std::endl;
+
+    return header.recordCount;
+  }
+
+  void
+  EReplay::runSimulation()
+  {
+    simulation.status = PRODUCTION;
+    size_t nextPrint = simulation.eventCount + simulation.eventPrintInterval;
+
+    try {
+      BinaryTrajectoryRecord record;
+      while (simulation.eventCount < _endEventCount)
+	{
+	  if (_SIGINT || _SIGTERM)
+	    {
+	      std::cerr << "\nEngine: Replay interrupted at event " << simulation.eventCount << std::endl;
+	      break;
+	    }
+
+	  const bool eof = !_file.read(reinterpret_cast<char*>(&record), sizeof(record));
+
+	  if (eof && _file.gcount())
+	    M_throw() << "The trajectory file ends with a truncated record";
+
+	  //Every record of an event shares the same sequence number,
+	  //so the event is replayed once the next event's first record
+	  //(or the end of the file) is reached.
+	  if (!_group.empty() && (eof || (record.sequence != _group.front().sequence)))
+	    {
+	      replayEvent();
+	      _group.clear();
+
+	      if ((simulation.eventCount >= nextPrint) && !simulation.outputPlugins.empty())
+		{
+		  simulation.outputPluginBus.synchronise();
+		  for (shared_ptr<OutputPlugin>& Ptr : simulation.outputPlugins)
+		    Ptr->periodicOutput();
+		  nextPrint = simulation.eventCount + simulation.eventPrintInterval;
+		  std::cout << std::endl;
+		}
+	    }
+
+	  if (eof) break;
+
+	  _group.push_back(record);
+	}
+    }
+    catch (std::exception& cep)
+      {
+	M_throw() << "Exception caught while replaying event "
+		  << simulation.eventCount << "\n" << cep.what();
+      }
+  }
+
+  void
+  EReplay::advance(double dt)
+  {
+    //Run the ticker events which occur before the next recorded
+    //event. This mirrors SysTicker::runEvent, except there are no
+    //Scheduler events to stream.
+    while (_ticker && (_ticker->getdt() <= dt))
+      {
+	const double tickerdt = _ticker->getdt();
+	dt -= tickerdt;
+	simulation.systemTime += tickerdt;
+	simulation.stream(tickerdt);
+	_ticker->increasedt(_ticker->getPeriod() / simulation.units.unitTime());
+
+	simulation.dynamics->updateAllParticles();
+
+	for (shared_ptr<OutputPlugin>& Ptr : simulation.outputPlugins)
+	  {
+	    shared_ptr<OPTicker> ptr = std::dynamic_pointer_cast<OPTicker>(Ptr);
+	    if (ptr) ptr->ticker();
+	  }
+
+	simulation.outputPluginBus.eventUpdate(*_ticker, NEventData(), tickerdt);
+      }
+
+    simulation.systemTime += dt;
+    simulation.stream(dt);
+  }
+
+  void
+  EReplay::applyDeltaP(Particle& part, const double deltaP[NDIM], double sign)
+  {
+    const double mass = simulation.species.getMass(part);
+    //Infinite mass particles do not change velocity
+    if (std::isinf(mass)) return;
+
+    const double factor = sign * simulation.units.unitMomentum() / mass;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      part.getVelocity()[iDim] += factor * deltaP[iDim];
+  }
+
+  PairEventData
+  EReplay::replayPair(const BinaryTrajectoryRecord& record)
+  {
+    if ((record.p1 >= simulation.N) || (record.p2 >= simulation.N))
+      M_throw() << "The trajectory refers to particles which are not in the configuration";
+
+    Particle& p1 = simulation.particles[record.p1];
+    Particle& p2 = simulation.particles[record.p2];
+    simulation.dynamics->updateParticlePair(p1, p2);
+
+    PairEventData retVal(p1, p2, *simulation.species[p1], *simulation.species[p2], EEventType(record.resultType));
+    simulation.BCs->applyBC(retVal.rij, retVal.vijold);
+    retVal.rvdot = (retVal.rij | retVal.vijold);
+
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      retVal.impulse[iDim] = - record.deltaP[iDim] * simulation.units.unitMomentum();
+
+    applyDeltaP(p1, record.deltaP, 1);
+    applyDeltaP(p2, record.deltaP, -1);
+    p1.setStates(record.state1);
+    p2.setStates(record.state2);
+
+    retVal.particle1_.setDeltaU(0.5 * record.deltaU * simulation.units.unitEnergy());
+    retVal.particle2_.setDeltaU(0.5 * record.deltaU * simulation.units.unitEnergy());
+    return retVal;
+  }
+
+  void
+  EReplay::replayEvent()
+  {
+    const BinaryTrajectoryRecord& first = _group.front();
+    const EEventType eType = EEventType(first.eventType);
+
+    //Clamp any round-off in the reduced times of the records
+    const double dt = std::max(0.0, double(first.time * simulation.units.unitTime() - simulation.systemTime));
+    advance(dt);
+    simulation.eventCount = first.eventCount;
+
+    if (first.eventClass == INTERACTION)
+      {
+	if (first.sourceID >= simulation.interactions.size())
+	  M_throw() << "The trajectory refers to an Interaction which is not in the configuration";
+	Interaction& interaction = *simulation.interactions[first.sourceID];
+
+	for (const BinaryTrajectoryRecord& record : _group)
+	  {
+	    PairEventData EDat = replayPair(record);
+	    const Particle& p1 = simulation.particles[record.p1];
+	    const Particle& p2 = simulation.particles[record.p2];
+	    IntEvent iEvent(p1, p2, dt, eType, interaction);
+	    interaction.replayEvent(p1, p2, eType, EEventType(record.resultType));
+
+	    simulation._sigParticleUpdate(EDat);
+	    simulation.outputPluginBus.eventUpdate(iEvent, EDat);
+	  }
+	return;
+      }
+
+    NEventData SDat;
+    const Particle* part = NULL;
+    for (const BinaryTrajectoryRecord& record : _group)
+      {
+	if (record.p1 == BinaryTrajectoryRecord::noParticle) continue;
+
+	if (record.p2 != BinaryTrajectoryRecord::noParticle)
+	  SDat += replayPair(record);
+	else
+	  {
+	    if (record.p1 >= simulation.N)
+	      M_throw() << "The trajectory refers to particles which are not in the configuration";
+
+	    Particle& p = simulation.particles[record.p1];
+	    simulation.dynamics->updateParticle(p);
+	    ParticleEventData PDat(p, *simulation.species[p], EEventType(record.resultType));
+	    applyDeltaP(p, record.deltaP, 1);
+	    p.setStates(record.state1);
+	    PDat.setDeltaU(record.deltaU * simulation.units.unitEnergy());
+	    SDat += PDat;
+	  }
+
+	if (!part) part = &simulation.particles[record.p1];
+      }
+
+    //Events which did not change any particles (e.g., ticker or
+    //snapshot events of the original run) are not replayed.
+    if (!part) return;
+
+    simulation._sigParticleUpdate(SDat);
+
+    switch (first.eventClass)
+      {
+      case GLOBAL:
+	{
+	  if (first.sourceID >= simulation.globals.size())
+	    M_throw() << "The trajectory refers to a Global which is not in the configuration";
+	  GlobalEvent iEvent(*part, dt, eType, *simulation.globals[first.sourceID]);
+	  simulation.outputPluginBus.eventUpdate(iEvent, SDat);
+	  break;
+	}
+      case LOCAL:
+	{
+	  if (first.sourceID >= simulation.locals.size())
+	    M_throw() << "The trajectory refers to a Local which is not in the configuration";
+	  LocalEvent iEvent(*part, dt, eType, *simulation.locals[first.sourceID]);
+	  simulation.outputPluginBus.eventUpdate(iEvent, SDat);
+	  break;
+	}
+      case SYSTEM:
+	{
+	  //The type of some Systems (e.g., SSleep) changes with their
+	  //state, so only the ID is checked
+	  if (first.sourceID >= simulation.systems.size())
+	    M_throw() << "The trajectory refers to a System which is not in the configuration";
+	  simulation.outputPluginBus.eventUpdate(*simulation.systems[first.sourceID], SDat, dt);
+	  break;
+	}
+      default:
+	M_throw() << "Unknown event class " << EEventType(first.eventClass) << " in the trajectory";
+      }
+  }
+}
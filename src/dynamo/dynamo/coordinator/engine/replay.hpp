@@ -0,0 +1,130 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file replay.hpp
+ * \brief Contains the definition of EReplay.
+ */
+
+#pragma once
+#include <dynamo/coordinator/engine/single.hpp>
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <vector>
+
+namespace dynamo {
+  class SysTicker;
+
+  /*! \brief An Engine which replays a binary trajectory through the
+   * output plugins.
+   *
+   * Trajectories are recorded with the BinaryTrajectory output
+   * plugin. Every particle change of every event is stored, so the
+   * results of random events (e.g., Andersen thermostat or DSMC
+   * events) are replayed without needing the random number
+   * generator. The replay does not predict any events or use the
+   * Scheduler; it only streams the system between the recorded event
+   * times and applies the recorded momentum and particle state
+   * (e.g., SSleep sleeping or waking) changes. This makes it
+   * possible to rerun analysis with a different set of output
+   * plugins (and ticker period) at a small fraction of the cost of
+   * the original simulation.
+   *
+   * The configuration loaded must be the one the trajectory was
+   * recorded from. To start part way through a trajectory, a
+   * checkpoint written by the plugin's CheckpointInterval option may
+   * be given, which replaces the particle data and capture maps of
+   * the loaded configuration.
+   *
+   * The replayed state matches the original simulation up to
+   * round-off error, as the momentum changes are stored in reduced
+   * units. Orientational data and changes to the gravity vector are
+   * not recorded, so systems with orientation or a SysRotateGravity
+   * cannot be replayed. Neighbour lists are not maintained during
+   * the replay.
+   */
+  class EReplay: public ESingleSimulation
+  {
+  public:
+    /*! \brief Only constructor.
+     *
+     * \param vm A reference to the Coordinator's parsed command line variables.
+     * \param tp A reference to the thread pool of the dynarun instance.
+     */
+    EReplay(const boost::program_options::variables_map& vm,
+	    magnet::thread::ThreadPool& tp);
+
+    /*! \brief Trivial virtual destructor */
+    virtual ~EReplay() {}
+
+    /*! \brief Replays the trajectory until it ends, the event limit is
+     * reached or the user interrupts the replay.
+     */
+    virtual void runSimulation();
+
+    /*! \brief Loads the simulation without initialising the
+     * Scheduler, and then opens the trajectory and checkpoint.
+     */
+    virtual void initialisation();
+
+    /*! \brief The options specific to the EReplay class.
+     *
+     * This is used by the Coordinator::parseOptions function.
+     *
+     * \param od The options description to add the EReplay options to.
+     */
+    static void getOptions(boost::program_options::options_description& od);
+
+  protected:
+    /*! \brief Load the particle data and capture maps from a
+     * checkpoint file.
+     *
+     * \return The number of trajectory records which were written
+     * before the checkpoint.
+     */
+    uint64_t loadCheckpoint(const std::string& filename);
+
+    /*! \brief Free stream the system by dt, running any SysTicker
+     * events which fall within the interval.
+     */
+    void advance(double dt);
+
+    /*! \brief Apply the recorded event stored in _group and pass it
+     * to the output plugins.
+     */
+    void replayEvent();
+
+    /*! \brief Fills a PairEventData with the recorded change of a
+     * pair of particles and applies it.
+     */
+    PairEventData replayPair(const BinaryTrajectoryRecord&);
+
+    /*! \brief Applies a recorded momentum change to a particle.
+     */
+    void applyDeltaP(Particle&, const double deltaP[NDIM], double sign);
+
+    //! The trajectory being replayed.
+    boost::iostreams::filtering_istream _file;
+
+    //! The records of the event being replayed.
+    std::vector<BinaryTrajectoryRecord> _group;
+
+    //! The event limit from the command line.
+    size_t _endEventCount;
+
+    //! The ticker of the simulation, if any.
+    SysTicker* _ticker;
+  };
+}
@@ -72,21 +72,39 @@ namespace dynamo {
 
 
   void
-  EReplicaExchangeSimulation::initialisation()
+  EReplicaExchangeSimulation::loadReplica(size_t i)
   {
-    preSimInit();
-    for (unsigned int i = 0; i < nSims; i++)
-      {
-	setupSim(Simulations[i], 
-		 vm["config-file"].as<std::vector<std::string> >()[i]);
+    //A replica loaded on its bound thread is also parsed on that
+    //thread, so its particle data is first touched on its core.
+    Simulations[i].threads = threads.getThreadAffinity() ? NULL : &threads;
 
-	if (vm.count("snapshot"))
-	  Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+    setupSim(Simulations[i], 
+	     vm["config-file"].as<std::vector<std::string> >()[i]);
 
-	Simulations[i].initialise();
+    Simulations[i].threads = &threads;
 
-	postSimInit(Simulations[i]);
-      }
+    if (vm.count("snapshot"))
+      Simulations[i].systems.push_back(shared_ptr<System>(new SysSnapshot(&(Simulations[i]), vm["snapshot"].as<double>(), "SnapshotEvent", "ID%ID.%COUNT", !vm.count("unwrapped"))));
+
+    Simulations[i].initialise();
+
+    postSimInit(Simulations[i]);
+  }
+
+  void
+  EReplicaExchangeSimulation::initialisation()
+  {
+    preSimInit();
+
+    //If the threads are bound to cores, each replica is loaded by
+    //the thread which will run it, so its memory is first touched
+    //(and allocated) on the NUMA node of that thread.
+    for (unsigned int i = 0; i < nSims; i++)
+      if (threads.getThreadAffinity())
+	threads.queueTaskOn(i, std::bind(&EReplicaExchangeSimulation::loadReplica, this, i));
+      else
+	loadReplica(i);
+    threads.wait();
 
     //Ensure we are in the right ensemble for all simulations
     for (size_t i = nSims; i != 0;)
@@ -386,7 +404,7 @@ namespace dynamo {
 	  {
 	    //Clear the writes to screen
 	    std::cout.flush();
-	    std::cerr << "\n<S>hutdown, <D>ata or <P>eek at data output:";
+	    std::cerr << "\n<S>hutdown, <D>ata, <M>emory usage or <P>eek at data output:";
 	      
 	    char c;
 	    //Clear the input buffer
@@ -478,6 +496,17 @@ namespace dynamo {
 		    }
 		  break;
 		}
+	      case 'm':
+	      case 'M':
+		{
+		  for (const replexPair& dat : temperatureList)
+		    {
+		      std::cout << "\nReplica " << dat.second.simID << ", T = " 
+				<< Simulations[dat.second.simID].ensemble->getReducedEnsembleVals()[2];
+		      Simulations[dat.second.simID].outputMemoryUsage(std::cout);
+		    }
+		  break;
+		}
 	      }
 	    {
 	      struct sigaction new_action;
@@ -496,7 +525,12 @@ namespace dynamo {
 	    for (size_t i(0); i < nSims; ++i)
 	      tasks.push_back(std::bind(&Simulation::runSimulation, &static_cast<Simulation&>(Simulations[i]), true));
 
-	    threads.queueTasks(tasks);
+	    //Bound threads keep each replica on the core it was loaded on
+	    if (threads.getThreadAffinity())
+	      for (size_t i(0); i < nSims; ++i)
+		threads.queueTaskOn(i, std::move(tasks[i]));
+	    else
+	      threads.queueTasks(tasks);
 	    threads.wait();//This syncs the systems for the replica exchange
 		  
 	    //Swap calculation
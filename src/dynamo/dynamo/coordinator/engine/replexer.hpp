@@ -196,6 +196,10 @@ namespace dynamo {
      */
     virtual void preSimInit();
 
+    /*! \brief Load and initialise a single replica.
+     */
+    void loadReplica(size_t);
+
     /*! \brief Sets up each simulation.
      
       Ensures the systems are in the right Ensemble, have a
@@ -25,7 +25,9 @@ namespace dynamo {
   ESingleSimulation::ESingleSimulation(const boost::program_options::variables_map& nVM, 
 				       magnet::thread::ThreadPool& tp):
     Engine(nVM, "config.out.xml.bz2", "output.xml.bz2", tp)
-  {}
+  {
+    simulation.threads = &threads;
+  }
 
   void
   ESingleSimulation::runSimulation()
@@ -38,7 +40,7 @@ namespace dynamo {
 	    {
 	      //Clear the writes to screen
 	      std::cout.flush();
-	      std::cerr << "\n<S>hutdown or <P>eek at data output:";
+	      std::cerr << "\n<S>hutdown, <M>emory usage or <P>eek at data output:";
 	      
 	      char c;
 	      //Clear the input buffer
@@ -56,6 +58,10 @@ namespace dynamo {
 		case 'P':
 		  simulation.outputData("peek.data.xml.bz2");
 		  break;
+		case 'm':
+		case 'M':
+		  simulation.outputMemoryUsage(std::cout);
+		  break;
 		}	      
 
 	      _SIGINT = false;
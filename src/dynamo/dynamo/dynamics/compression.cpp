@@ -115,11 +115,11 @@ namespace dynamo {
     updateParticlePair(particle1, particle2);  
     PairEventData retVal(particle1, particle2, *Sim->species[particle1], *Sim->species[particle2], eType);
     Sim->BCs->applyBC(retVal.rij, retVal.vijold);
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID()); 
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID()); 
+    double p1Mass = Sim->species.getMass(particle1); 
+    double p2Mass = Sim->species.getMass(particle2); 
     double r2 = retVal.rij.nrm2();
     retVal.rvdot = (retVal.rij | retVal.vijold);
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
     bool infinite_masses = (p1Mass == HUGE_VAL) && (p2Mass == HUGE_VAL);
     if (infinite_masses)
       {
@@ -144,9 +144,9 @@ namespace dynamo {
     updateParticlePair(particle1, particle2);  
     PairEventData retVal(particle1, particle2, *Sim->species[particle1], *Sim->species[particle2], event.getType());
     Sim->BCs->applyBC(retVal.rij, retVal.vijold);
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double p1Mass = Sim->species.getMass(particle1);
+    double p2Mass = Sim->species.getMass(particle2);
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
     bool infinite_masses = (p1Mass == HUGE_VAL) && (p2Mass == HUGE_VAL);
     if (infinite_masses)
       {
@@ -254,7 +254,7 @@ namespace dynamo {
     //distributed Normal component. See Granular Simulation Book
     ParticleEventData tmpDat(part, *Sim->species[part], WALL);
  
-    double mass = Sim->species[tmpDat.getSpeciesID()]->getMass(part.getID());
+    double mass = Sim->species.getMass(part);
 
     std::normal_distribution<> normal_dist;
     std::uniform_real_distribution<> uniform_dist;
@@ -34,6 +34,12 @@ namespace dynamo {
     DynCompression(dynamo::Simulation*, double);
     virtual double SphereSphereInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;  
+    virtual void SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereInRoot(batch, d, dt); }
+    virtual void SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+    { Dynamics::SphereSphereOutRoot(batch, d, dt); }
+    virtual size_t sphereOverlaps(const PairBatch& batch, const std::vector<double>& d) const
+    { return Dynamics::sphereOverlaps(batch, d); }
     virtual std::pair<bool, double> getOffcentreSpheresCollision(const double offset1, const double diameter1, const double offset2, const double diameter2, const Particle& p1, const Particle& p2, double t_max, double maxdist) const;
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
     virtual PairEventData SmoothSpheresColl(const IntEvent&, const double&, const double&, const EEventType&) const;
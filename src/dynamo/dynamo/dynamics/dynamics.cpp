@@ -23,6 +23,8 @@
 #include <dynamo/BC/LEBC.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/string/scientific.hpp>
+#include <magnet/thread/threadpool.hpp>
 #include <cstring>
 
 namespace dynamo {
@@ -105,21 +107,120 @@ namespace dynamo {
   Dynamics::getPBCSentinelTime(const Particle&, const double&) const
   { M_throw() << "Not implemented for this Dynamics."; }
 
-  void 
-  Dynamics::loadParticleXMLData(const magnet::xml::Node& XML)
+  void
+  Dynamics::getPairBatch(const Particle& p1, const std::vector<size_t>& ids, PairBatch& batch) const
+  {
+#ifdef DYNAMO_DEBUG
+    if (!isUpToDate(p1))
+      M_throw() << "Particle " << p1.getID() << " is not up to date";
+#endif
+
+    batch.p1ID = p1.getID();
+    batch.IDs = ids;
+    batch.resize(ids.size());
+
+    const Vector& pos1 = p1.getPosition();
+    const Vector& vel1 = p1.getVelocity();
+    for (size_t i(0); i < ids.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[ids[i]];
+#ifdef DYNAMO_DEBUG
+	if (!isUpToDate(p2))
+	  M_throw() << "Particle " << p2.getID() << " is not up to date";
+#endif
+	for (size_t n(0); n < NDIM; ++n)
+	  {
+	    batch.rij[n][i] = pos1[n] - p2.getPosition()[n];
+	    batch.vij[n][i] = vel1[n] - p2.getVelocity()[n];
+	  }
+      }
+
+    double* rij[NDIM];
+    double* vij[NDIM];
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	rij[n] = batch.rij[n].data();
+	vij[n] = batch.vij[n].data();
+      }
+    Sim->BCs->applyBC(rij, vij, batch.size());
+  }
+
+  void
+  Dynamics::SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    const Particle& p1 = Sim->particles[batch.p1ID];
+    for (size_t i(0); i < batch.size(); ++i)
+      dt[i] = SphereSphereInRoot(p1, Sim->particles[batch.IDs[i]], d[i]);
+  }
+
+  void
+  Dynamics::SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    const Particle& p1 = Sim->particles[batch.p1ID];
+    for (size_t i(0); i < batch.size(); ++i)
+      dt[i] = SphereSphereOutRoot(p1, Sim->particles[batch.IDs[i]], d[i]);
+  }
+
+  size_t
+  Dynamics::sphereOverlaps(const PairBatch& batch, const std::vector<double>& d) const
+  {
+    const Particle& p1 = Sim->particles[batch.p1ID];
+    size_t count(0);
+    for (size_t i(0); i < batch.size(); ++i)
+      count += (sphereOverlap(p1, Sim->particles[batch.IDs[i]], d[i]) > 0);
+    return count;
+  }
+
+  namespace {
+    /*! \brief Fetch the columns of a Vector stored in a child tag of
+        the particle records.
+     */
+    std::vector<const std::vector<double>*>
+    getVectorColumns(const magnet::xml::RecordTable& particles, const std::string& tag)
+    {
+      std::vector<const std::vector<double>*> columns;
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  //Vectors may use either the x,y,z or 0,1,2 attribute names
+	  std::string name = tag + "." + char('x' + iDim);
+	  if (!particles.hasColumn(name))
+	    name = tag + "." + char('0' + iDim);
+	  columns.push_back(&particles.getColumn(name));
+	}
+      return columns;
+    }
+  }
+
+  void
+  Dynamics::loadParticleXMLData(const magnet::xml::Node& XML, const magnet::xml::RecordTable& particles)
   {
     dout << "Loading Particle Data" << std::endl;
 
-    bool outofsequence = false;  
-  
-    for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); 
-	 node.valid(); ++node)
+    const size_t N = particles.size();
+    const std::vector<const std::vector<double>*> pos = getVectorColumns(particles, "P");
+    const std::vector<const std::vector<double>*> vel = getVectorColumns(particles, "V");
+
+    bool outofsequence = false;
+    const magnet::xml::RecordTable::Column* staticFlags = particles.findColumn("Static");
+    const magnet::xml::RecordTable::Column* ids = particles.findColumn("ID");
+
+    Sim->particles.clear();
+    Sim->particles.reserve(N);
+    for (size_t i(0); i < N; ++i)
       {
-	if (!node.hasAttribute("ID")
-	    || node.getAttribute("ID").as<size_t>() != Sim->particles.size())
+	if (!ids || !ids->_present[i] || (ids->_values[i] != i))
 	  outofsequence = true;
-      
-	Particle part(node, Sim->particles.size());
+
+	Vector position, velocity;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    position[iDim] = (*pos[iDim])[i];
+	    velocity[iDim] = (*vel[iDim])[i];
+	  }
+
+	Particle part(position, velocity, i);
+	if (staticFlags && staticFlags->_present[i])
+	  part.clearState(Particle::DYNAMIC);
 	part.getVelocity() *= Sim->units.unitVelocity();
 	part.getPosition() *= Sim->units.unitLength();
 	Sim->particles.push_back(part);
@@ -136,13 +237,20 @@ namespace dynamo {
 
     if (XML.getNode("ParticleData").hasAttribute("OrientationData"))
       {
+	const std::vector<const std::vector<double>*> U = getVectorColumns(particles, "U");
+	const std::vector<double>& Uw = particles.getColumn("U.w");
+	const std::vector<const std::vector<double>*> O = getVectorColumns(particles, "O");
+
 	orientationData.resize(Sim->N);
-	size_t i(0);
-	for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); node.valid(); ++node, ++i)
+	for (size_t i(0); i < Sim->N; ++i)
 	  {
-	    orientationData[i].orientation << node.getNode("U");
-	    orientationData[i].angularVelocity << node.getNode("O");
-      
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      {
+		orientationData[i].orientation.imaginary()[iDim] = (*U[iDim])[i];
+		orientationData[i].angularVelocity[iDim] = (*O[iDim])[i];
+	      }
+	    orientationData[i].orientation.real() = Uw[i];
+
 	    //Makes the vector a unit vector
 	    orientationData[i].orientation.normalise();
 	    if (orientationData[i].orientation.nrm() == 0)
@@ -151,36 +259,142 @@ namespace dynamo {
       }
   }
 
+  namespace {
+    inline char*
+    writeString(char* p, const char* str, size_t length)
+    {
+      std::memcpy(p, str, length);
+      return p + length;
+    }
+
+    inline char*
+    writeUnsigned(char* p, size_t value)
+    {
+      char buffer[24];
+      char* end = buffer + sizeof(buffer);
+      char* start = end;
+      do { *(--start) = '0' + value % 10; value /= 10; } while (value);
+      return writeString(p, start, end - start);
+    }
+
+    //! Writes an attribute in the same form as the XmlStream
+    inline char*
+    writeAttribute(char* p, const char* name, size_t length, double value, int precision)
+    {
+      *(p++) = ' ';
+      p = writeString(p, name, length);
+      *(p++) = '=';
+      *(p++) = '"';
+      p = magnet::string::formatScientific(p, value, precision);
+      *(p++) = '"';
+      return p;
+    }
+
+    //! Writes a tag containing a Vector in the same form as the XmlStream
+    inline char*
+    writeVectorTag(char* p, char tag, const Vector& vec, int precision)
+    {
+      p = writeString(p, "      <", 7);
+      *(p++) = tag;
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  const char name = 'x' + iDim;
+	  p = writeAttribute(p, &name, 1, vec[iDim], precision);
+	}
+      return p;
+    }
+  }
+
   void 
-  Dynamics::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const
+  Dynamics::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC, magnet::thread::ThreadPool& pool) const
   {
     XML << magnet::xml::tag("ParticleData");
   
     if (hasOrientationData())
       XML << magnet::xml::attr("OrientationData") << "Y";
 
-    for (size_t i = 0; i < Sim->N; ++i)
+    if (Sim->N)
       {
-	Particle tmp(Sim->particles[i]);
-	if (applyBC) 
-	  Sim->BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
-      
-	tmp.getVelocity() *= (1.0 / Sim->units.unitVelocity());
-	tmp.getPosition() *= (1.0 / Sim->units.unitLength());
-      
-	XML << magnet::xml::tag("Pt");
-	Sim->_properties.outputParticleXMLData(XML, i);
-	XML << tmp;
-
+	//Close the start of the ParticleData tag, the particles are
+	//then written directly to the stream at the indentation the
+	//XmlStream would use.
+	XML << magnet::xml::chardata();
+	std::ostream& os = XML.getUnderlyingStream();
+	const int precision = os.precision();
+
+	std::vector<std::pair<std::string, const Property*> > properties;
+	for (const auto& property : Sim->_properties)
+	  properties.push_back(std::make_pair(property->getName(), property.get()));
+
+	//An upper bound on the length of a formatted value
+	const size_t valueLength = precision + 40;
+	size_t maxLength = 128 + (2 * NDIM + 3) * valueLength;
 	if (hasOrientationData())
-	  XML << magnet::xml::tag("O")
-	      << orientationData[i].angularVelocity
-	      << magnet::xml::endtag("O")
-	      << magnet::xml::tag("U")
-	      << orientationData[i].orientation
-	      << magnet::xml::endtag("U") ;
-
-	XML << magnet::xml::endtag("Pt");
+	  maxLength += (2 * NDIM + 4) * valueLength;
+	for (const auto& property : properties)
+	  maxLength += property.first.size() + valueLength;
+
+	const size_t chunkSize = 4096;
+	const size_t chunks = (Sim->N + chunkSize - 1) / chunkSize;
+	const size_t batchSize = 2 * std::max(pool.getThreadCount(), size_t(1));
+	std::vector<std::string> buffers(batchSize);
+
+	for (size_t batchStart(0); batchStart < chunks; batchStart += batchSize)
+	  {
+	    const size_t batchEnd = std::min(chunks, batchStart + batchSize);
+	    magnet::thread::TaskGroup group(pool);
+	    for (size_t chunk(batchStart); chunk < batchEnd; ++chunk)
+	      group.run([&, chunk]{
+		  const size_t begin = chunk * chunkSize;
+		  const size_t end = std::min(Sim->N, begin + chunkSize);
+		  std::string& buffer = buffers[chunk - batchStart];
+		  buffer.resize((end - begin) * maxLength);
+		  char* p = &buffer[0];
+
+		  for (size_t i(begin); i < end; ++i)
+		    {
+		      Particle tmp(Sim->particles[i]);
+		      if (applyBC) 
+			Sim->BCs->applyBC(tmp.getPosition(), tmp.getVelocity());
+      
+		      tmp.getVelocity() *= (1.0 / Sim->units.unitVelocity());
+		      tmp.getPosition() *= (1.0 / Sim->units.unitLength());
+
+		      p = writeString(p, "    <Pt", 7);
+		      for (const auto& property : properties)
+			p = writeAttribute(p, property.first.data(), property.first.size(), 
+					   property.second->getProperty(i), precision);
+
+		      p = writeString(p, " ID=\"", 5);
+		      p = writeUnsigned(p, tmp.getID());
+		      *(p++) = '"';
+		      if (!tmp.testState(Particle::DYNAMIC))
+			p = writeString(p, " Static=\"Static\"", 16);
+		      p = writeString(p, ">\n", 2);
+
+		      p = writeVectorTag(p, 'P', tmp.getPosition(), precision);
+		      p = writeString(p, "/>\n", 3);
+		      p = writeVectorTag(p, 'V', tmp.getVelocity(), precision);
+		      p = writeString(p, "/>\n", 3);
+
+		      if (hasOrientationData())
+			{
+			  p = writeVectorTag(p, 'O', orientationData[i].angularVelocity, precision);
+			  p = writeString(p, "/>\n", 3);
+			  p = writeVectorTag(p, 'U', orientationData[i].orientation.imaginary(), precision);
+			  p = writeAttribute(p, "w", 1, orientationData[i].orientation.real(), precision);
+			  p = writeString(p, "/>\n", 3);
+			}
+
+		      p = writeString(p, "    </Pt>\n", 10);
+		    }
+		  buffer.resize(p - &buffer[0]);
+		});
+	    group.wait();
+
+	    for (size_t chunk(batchStart); chunk < batchEnd; ++chunk)
+	      os.write(buffers[chunk - batchStart].data(), buffers[chunk - batchStart].size());
+	  }
       }
   
     XML << magnet::xml::endtag("ParticleData");
@@ -189,7 +403,7 @@ namespace dynamo {
   double 
   Dynamics::getParticleKineticEnergy(const Particle& part) const
   {
-    const double mass = Sim->species[part]->getMass(part.getID());
+    const double mass = Sim->species.getMass(part);
 
     double energy(0);
     if (!std::isinf(mass))
@@ -231,7 +445,7 @@ namespace dynamo {
 	const BCLeesEdwards& bc = static_cast<const BCLeesEdwards&>(*Sim->BCs);
 	for (Particle& part : Sim->particles)
 	  {
-	    const double mass = Sim->species[part]->getMass(part.getID());
+	    const double mass = Sim->species.getMass(part);
 	    if (!std::isinf(mass))
 	      part.getVelocity() = Vector(bc.getPeculiarVelocity(part) * scalefactor + bc.getStreamVelocity(part));
 	  }
@@ -239,7 +453,7 @@ namespace dynamo {
     else
       for (Particle& part : Sim->particles)
 	{
-	  const double mass = Sim->species[part]->getMass(part.getID());
+	  const double mass = Sim->species.getMass(part);
 	  if (!std::isinf(mass))
 	    part.getVelocity() *= scalefactor;
 	}
@@ -378,7 +592,7 @@ namespace dynamo {
     for (size_t ID : particles)
       {
 	const Particle& part = Sim->particles[ID];
-	double mass = Sim->species[part]->getMass(ID);
+	double mass = Sim->species.getMass(part);
 
 	//Take everything relative to the first particle's position to
 	//minimise issues with PBC wrapping the particles.
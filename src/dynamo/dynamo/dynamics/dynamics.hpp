@@ -19,10 +19,12 @@
 #include <dynamo/base.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/particle.hpp>
+#include <dynamo/dynamics/pairbatch.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/math/quaternion.hpp>
 
 namespace xml { class XmlStream; }
+namespace magnet { namespace thread { class ThreadPool; } }
 namespace dynamo {
   class Particle;
   class PairEventData;
@@ -81,20 +83,25 @@ namespace dynamo {
      */
     virtual void replicaExchange(Dynamics& oDynamics) {}
 
-    /*! \brief Parses the XML data to see if it can load XML particle
-      data or if it needs to decode the binary data. Then loads the
-      particle data.
+    /*! \brief Loads the particle data.
      
       \param XML The root xml::Node of the xml::Document which has the ParticleData tag within.
+      \param particles The attributes of the Pt tags in the ParticleData.
      */
-    virtual void loadParticleXMLData(const magnet::xml::Node& XML);
+    virtual void loadParticleXMLData(const magnet::xml::Node& XML, const magnet::xml::RecordTable& particles);
   
-    /*! \brief Writes the XML particle data, either the base64 header or
-      the entire XML form.
+    /*! \brief Writes the XML particle data.
+
+      The particle tags are formatted in parallel chunks and written
+      directly to the underlying stream of the XmlStream, which must
+      be in scientific mode. The output is identical to writing each
+      particle through the XmlStream.
+
       \param XML The XMLStream to write the configuration data to.
       \param applyBC Wether to apply the boundary conditions to the final particle positions before writing them out.
+      \param pool The ThreadPool used to format the particle data.
      */
-    void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const;
+    void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC, magnet::thread::ThreadPool& pool) const;
 
     /*! \brief Returns the degrees of freedom per particle.
      */
@@ -182,6 +189,49 @@ namespace dynamo {
      */
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const = 0;  
 
+    /*! \brief Collects the minimum image separations and relative
+      velocities of a particle and a list of its neighbours into a
+      PairBatch.
+
+      All of the particles must already be up to date (see
+      updateParticle).
+
+      \param p1 The particle at the centre of the batch.
+      \param ids The IDs of the neighbours of p1.
+      \param batch The PairBatch to fill.
+     */
+    void getPairBatch(const Particle& p1, const std::vector<size_t>& ids, PairBatch& batch) const;
+
+    /*! \brief A batched form of SphereSphereInRoot for all of the
+      pairs in a PairBatch.
+
+      The default implementation calls the scalar SphereSphereInRoot
+      for each pair. Dynamics with a closed form for the root search
+      override this to operate directly on the batch arrays.
+
+      \param batch The pairs to test, filled by getPairBatch.
+      \param d The interaction diameters of each pair.
+      \param dt The output times of the next event for each pair, or
+      HUGE_VAL if there is no event.
+     */
+    virtual void SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
+
+    /*! \brief A batched form of SphereSphereOutRoot for all of the
+      pairs in a PairBatch.
+
+      See the batched SphereSphereInRoot for a description of the
+      arguments.
+     */
+    virtual void SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
+
+    /*! \brief Counts how many of the pairs in a PairBatch are
+      overlapping (see sphereOverlap).
+
+      \param batch The pairs to test, filled by getPairBatch.
+      \param d The interaction diameters of each pair.
+     */
+    virtual size_t sphereOverlaps(const PairBatch& batch, const std::vector<double>& d) const;
+
     /*! \brief Determines if two spheres are overlapping
      
       \param d The interaction distance.
@@ -524,6 +574,24 @@ namespace dynamo {
 				 double& maxprob, const double& factor,
 				 Vector rij) const = 0;
   
+    /*! \brief Calculates the ESMC (Enskog DSMC) collision
+      probability of two spherical particles.
+
+      Unlike DSMCSpheresTest, this function draws no random numbers
+      and only modifies the two particles (to bring them up to
+      date), so it may be called in parallel for disjoint pairs.
+
+      \param p1 First particle to test
+      \param p1 Second particle to test
+      \param factor The factor multiplying the approach velocity.
+      \param rij The vector seperating the two particles.
+      \return The collision probability, which is negative if the
+      particles are receding.
+     */  
+    virtual double DSMCSpheresProbability(Particle& p1, Particle& p2,
+					  const double& factor,
+					  Vector rij) const = 0;
+
     /*! \brief Performs a hard sphere collision between the two
       particles according to the ESMC (Enskog DSMC)
       
@@ -105,6 +105,76 @@ namespace dynamo {
     return magnet::intersection::parabola_sphere(r12, v12, g12, d);
   }
 
+  void
+  DynGravity::SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    DynNewtonian::SphereSphereInRoot(batch, d, dt);
+    parabolaBatchRoots(batch, d, dt, false);
+  }
+
+  void
+  DynGravity::SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    DynNewtonian::SphereSphereOutRoot(batch, d, dt);
+    parabolaBatchRoots(batch, d, dt, true);
+  }
+
+  void
+  DynGravity::parabolaBatchRoots(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt, const bool inverse) const
+  {
+    const bool p1Dynamic = Sim->particles[batch.p1ID].testState(Particle::DYNAMIC);
+
+    //Gather the pairs where one particle feels gravity and the other
+    //does not, recording the index of each pair in the batch.
+    PairBatch& pairs = _parabolaPairs;
+    pairs.IDs.clear();
+    _parabolaIndices.clear();
+    for (size_t i(0); i < batch.size(); ++i)
+      if (Sim->particles[batch.IDs[i]].testState(Particle::DYNAMIC) != p1Dynamic)
+	{
+	  pairs.IDs.push_back(batch.IDs[i]);
+	  _parabolaIndices.push_back(i);
+	}
+
+    const size_t N = pairs.size();
+    if (!N) return;
+
+    pairs.resize(N);
+    //Here we get the sign right on the acceleration g12
+    Vector g12(g);
+    if (!p1Dynamic) g12 = -g;
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	_parabolaAccel[n].assign(N, g12[n]);
+	for (size_t j(0); j < N; ++j)
+	  {
+	    pairs.rij[n][j] = batch.rij[n][_parabolaIndices[j]];
+	    pairs.vij[n][j] = batch.vij[n][_parabolaIndices[j]];
+	  }
+      }
+
+    for (size_t j(0); j < N; ++j)
+      pairs.inner_d[j] = d[_parabolaIndices[j]];
+
+    const double* rij[NDIM];
+    const double* vij[NDIM];
+    const double* g12s[NDIM];
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	rij[n] = pairs.rij[n].data();
+	vij[n] = pairs.vij[n].data();
+	g12s[n] = _parabolaAccel[n].data();
+      }
+
+    if (inverse)
+      magnet::intersection::parabola_invsphere(rij, vij, g12s, pairs.inner_d.data(), pairs.inner_dt.data(), N);
+    else
+      magnet::intersection::parabola_sphere(rij, vij, g12s, pairs.inner_d.data(), pairs.inner_dt.data(), N);
+
+    for (size_t j(0); j < N; ++j)
+      dt[_parabolaIndices[j]] = pairs.inner_dt[j];
+  }
+
   double
   DynGravity::SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const
   {
@@ -113,7 +183,7 @@ namespace dynamo {
     for (const size_t ID : p1)
       {
 	const Particle& part = Sim->particles[ID];       
-	double mass = Sim->species[part]->getMass(ID);
+	double mass = Sim->species.getMass(part);
 
 	if (part.testState(Particle::DYNAMIC))
 	  accel1sum += mass;
@@ -127,7 +197,7 @@ namespace dynamo {
     for (const size_t ID : p2)
       {
 	const Particle& part = Sim->particles[ID];       
-	double mass = Sim->species[part]->getMass(ID);
+	double mass = Sim->species.getMass(part);
 
 	if (part.testState(Particle::DYNAMIC))
 	  accel2sum += mass;
@@ -175,7 +245,7 @@ namespace dynamo {
     for (const size_t ID : p1)
       {
 	const Particle& part = Sim->particles[ID];       
-	double mass = Sim->species[part]->getMass(ID);
+	double mass = Sim->species.getMass(part);
 
 	if (part.testState(Particle::DYNAMIC))
 	  accel1sum += mass;
@@ -189,7 +259,7 @@ namespace dynamo {
     for (const size_t ID : p2)
       {
 	const Particle& part = Sim->particles[ID];       
-	double mass = Sim->species[part]->getMass(ID);
+	double mass = Sim->species.getMass(part);
 
 	if (part.testState(Particle::DYNAMIC))
 	  accel2sum += mass;
@@ -34,6 +34,8 @@ namespace dynamo {
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;
+    virtual void SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
+    virtual void SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
     virtual void streamParticle(Particle&, const double&) const;
     virtual double getSquareCellCollision2(const Particle&, const Vector &, const Vector &) const;
     virtual int getSquareCellCollision3(const Particle&, const Vector &, const Vector &) const;
@@ -53,6 +55,21 @@ namespace dynamo {
     double elasticV;
     Vector g;
     mutable std::vector<long double> _tcList;
+
+    /*! \brief Replace the roots of the pairs in a PairBatch where
+      only one particle feels gravity with the parabolic roots.
+
+      \param inverse If true, the roots of the SphereSphereOutRoot
+      are calculated.
+     */
+    void parabolaBatchRoots(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt, bool inverse) const;
+
+    //! \brief Scratch space for the pairs of parabolaBatchRoots.
+    mutable PairBatch _parabolaPairs;
+    //! \brief The index in the batch of each of the _parabolaPairs.
+    mutable std::vector<size_t> _parabolaIndices;
+    //! \brief The relative accelerations of the _parabolaPairs.
+    mutable std::vector<double> _parabolaAccel[NDIM];
     double _tc;
 
     virtual void outputXML(magnet::xml::XmlStream&) const;
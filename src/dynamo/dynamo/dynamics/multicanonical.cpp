@@ -57,22 +57,20 @@ namespace dynamo {
   void 
   DynNewtonianMC::outputXML(magnet::xml::XmlStream& XML) const
   {
-    std::unordered_map<int, double> wout = _W;
-
     XML << magnet::xml::attr("Type")
 	<< "NewtonianMC"
 	<< magnet::xml::tag("PotentialDeformation")
 	<< magnet::xml::attr("EnergyStep")
 	<< EnergyPotentialStep * Sim->units.unitEnergy();
 
-    typedef std::pair<const int, double> locpair;
-
-    for (const locpair& val : wout)
-      XML << magnet::xml::tag("W")
-	  << magnet::xml::attr("Energy")
-	  << val.first * EnergyPotentialStep * Sim->units.unitEnergy()
-	  << magnet::xml::attr("Value") << val.second
-	  << magnet::xml::endtag("W");
+    //Zero bins are not written, as this is the default value
+    for (long i(_W.begin_index()); i < _W.end_index(); ++i)
+      if (_W(i))
+	XML << magnet::xml::tag("W")
+	    << magnet::xml::attr("Energy")
+	    << i * EnergyPotentialStep * Sim->units.unitEnergy()
+	    << magnet::xml::attr("Value") << _W(i)
+	    << magnet::xml::endtag("W");
     
     XML << magnet::xml::endtag("PotentialDeformation");
   }
@@ -116,8 +114,8 @@ namespace dynamo {
   
     retVal.rvdot = (retVal.rij | retVal.vijold);
   
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
+    double p1Mass = Sim->species.getMass(particle1);
+    double p2Mass = Sim->species.getMass(particle2);
     double mu = p1Mass * p2Mass / (p1Mass + p2Mass);  
     double R2 = retVal.rij.nrm2();
 
@@ -17,7 +17,7 @@
 
 #pragma once
 #include <dynamo/dynamics/newtonian.hpp>
-#include <unordered_map>
+#include <magnet/containers/offset_array.hpp>
 
 namespace dynamo {
   /*! \brief A Dynamics which implements Newtonian dynamics, but with
@@ -68,14 +68,15 @@ namespace dynamo {
     /*! \brief Returns the \f$W(E)\f$ function.
      
       The lookup is performed by taking the system energy, E, and
-      calculating the key like so:
+      calculating the index like so:
      
-      \f[\textrm{key}= \textrm{int}\left[E / \Delta E\right]\f]
+      \f[\textrm{index}= \textrm{int}\left[E / \Delta E\right]\f]
      
       where \f$ \Delta E\f$ is the energy step returned from
-      getEnergyStep().
+      getEnergyStep(). Energies outside of the stored bins have
+      \f$W(E)=0\f$.
      */
-    inline const std::unordered_map<int, double>& getMap() const { return _W; }
+    inline const magnet::containers::OffsetArray<double>& getMap() const { return _W; }
 
     /*! \brief Returns \f$ \Delta E\f$.
        \sa getMap()
@@ -85,19 +86,13 @@ namespace dynamo {
     /*! \brief Returns \f$ W(E)\f$.
      */
     inline double W(double E) const 
-    { 
-      std::unordered_map<int, double>::const_iterator 
-	iPtr = _W.find(lrint(E / EnergyPotentialStep));
-      if (iPtr != _W.end())
-	return iPtr->second;
-      return 0;
-    }
+    { return _W(lrint(E / EnergyPotentialStep)); }
 
     virtual void replicaExchange(Dynamics& oDynamics);
 
   protected:
     virtual void outputXML(magnet::xml::XmlStream& ) const;
-    std::unordered_map<int, double> _W; 
+    magnet::containers::OffsetArray<double> _W;
     double EnergyPotentialStep;
   };
 }
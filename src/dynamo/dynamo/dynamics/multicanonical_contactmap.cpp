@@ -113,8 +113,8 @@ namespace dynamo {
   
     retVal.rvdot = (retVal.rij | retVal.vijold);
   
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
+    double p1Mass = Sim->species.getMass(particle1);
+    double p2Mass = Sim->species.getMass(particle2);
     double mu = p1Mass * p2Mass / (p1Mass + p2Mass);  
     double R2 = retVal.rij.nrm2();
 
@@ -184,7 +184,7 @@ namespace dynamo {
     size_t applicable_tethers = 0;
     double accumilated_W = 0;
 
-    for (auto tethermap : _W)
+    for (const auto& tethermap : _W)
       {
 	auto il = tethermap.first.begin();
 	auto ir = map.begin();
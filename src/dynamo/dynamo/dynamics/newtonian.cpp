@@ -98,6 +98,46 @@ namespace dynamo {
     return magnet::intersection::ray_inv_sphere(r12, v12, d);
   }
 
+  void
+  DynNewtonian::SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    const double* rij[NDIM];
+    const double* vij[NDIM];
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	rij[n] = batch.rij[n].data();
+	vij[n] = batch.vij[n].data();
+      }
+    magnet::intersection::ray_sphere(rij, vij, d.data(), dt.data(), batch.size());
+  }
+
+  void
+  DynNewtonian::SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const
+  {
+    const double* rij[NDIM];
+    const double* vij[NDIM];
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	rij[n] = batch.rij[n].data();
+	vij[n] = batch.vij[n].data();
+      }
+    magnet::intersection::ray_inv_sphere(rij, vij, d.data(), dt.data(), batch.size());
+  }
+
+  size_t
+  DynNewtonian::sphereOverlaps(const PairBatch& batch, const std::vector<double>& d) const
+  {
+    size_t count(0);
+    for (size_t i(0); i < batch.size(); ++i)
+      {
+	double r2(0);
+	for (size_t n(0); n < NDIM; ++n)
+	  r2 += batch.rij[n][i] * batch.rij[n][i];
+	count += (std::sqrt(r2) < d[i]);
+      }
+    return count;
+  }
+
   ParticleEventData 
   DynNewtonian::randomGaussianEvent(Particle& part, const double& sqrtT, 
 				  const size_t dimensions) const
@@ -119,7 +159,7 @@ namespace dynamo {
     //Collect the precoll data
     ParticleEventData tmpDat(part, *Sim->species[part], GAUSSIAN);
 
-    double mass = Sim->species[tmpDat.getSpeciesID()]->getMass(part.getID());
+    double mass = Sim->species.getMass(part);
     double factor = sqrtT / std::sqrt(mass);
 
     std::normal_distribution<> norm_dist;
@@ -247,7 +287,7 @@ namespace dynamo {
     //distributed Normal component. See Granular Simulation Book
     ParticleEventData tmpDat(part, *Sim->species[part], WALL);
  
-    double mass = Sim->species[tmpDat.getSpeciesID()]->getMass(part.getID());
+    double mass = Sim->species.getMass(part);
     std::normal_distribution<> norm_dist;
     for (size_t iDim = 0; iDim < NDIM; iDim++)
       part.getVelocity()[iDim] = norm_dist(Sim->ranGenerator) * sqrtT / std::sqrt(mass);
@@ -327,19 +367,11 @@ namespace dynamo {
   bool 
   DynNewtonian::DSMCSpheresTest(Particle& p1, Particle& p2, double& maxprob, const double& factor, Vector rij) const
   {
-    updateParticlePair(Sim->particles[p1.getID()], Sim->particles[p2.getID()]);
-
-    Vector vij = p1.getVelocity() - p2.getVelocity();
-    Sim->BCs->applyBC(rij, vij);
-
-    //Sim->BCs->applyBC(pdat.rij, pdat.vij);
-    double rvdot = (rij | vij);
+    double prob = DSMCSpheresProbability(p1, p2, factor, rij);
   
-    if (rvdot > 0)
+    if (prob < 0)
       return false; //Positive rvdot
 
-    double prob = factor * (-rvdot);
-
     if (prob > maxprob)
       maxprob = prob;
 
@@ -347,6 +379,17 @@ namespace dynamo {
     return prob > uniform_dist(Sim->ranGenerator) * maxprob;
   }
 
+  double
+  DynNewtonian::DSMCSpheresProbability(Particle& p1, Particle& p2, const double& factor, Vector rij) const
+  {
+    updateParticlePair(p1, p2);
+
+    Vector vij = p1.getVelocity() - p2.getVelocity();
+    Sim->BCs->applyBC(rij, vij);
+
+    return factor * (-(rij | vij));
+  }
+
   PairEventData
   DynNewtonian::DSMCSpheresRun(Particle& p1, Particle& p2, const double& e, Vector rij) const
   {
@@ -365,9 +408,9 @@ namespace dynamo {
     retVal.rij = rij;
     retVal.rvdot = rvdot;
 
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(p1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(p2.getID());
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double p1Mass = Sim->species.getMass(p1);
+    double p2Mass = Sim->species.getMass(p2);
+    double mu = 1.0 / (Sim->species.getInvMass(p1) + Sim->species.getInvMass(p2));
 
     retVal.impulse = rij * ((1.0 + e) * mu * rvdot / rij.nrm2());  
 
@@ -388,12 +431,12 @@ namespace dynamo {
 
     Sim->BCs->applyBC(retVal.rij, retVal.vijold);
 
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID()); 
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
+    double p1Mass = Sim->species.getMass(particle1); 
+    double p2Mass = Sim->species.getMass(particle2);
  
     retVal.rvdot = retVal.rij | retVal.vijold;
 
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
 
     //Treat special cases if one particle has infinite mass
     bool infinite_masses = (p1Mass == HUGE_VAL) && (p2Mass == HUGE_VAL);
@@ -434,9 +477,9 @@ namespace dynamo {
     for (size_t iDim(1); iDim < NDIM; ++iDim)
       if (fabs(retVal.rij[dim]) < fabs(retVal.rij[iDim])) dim = iDim;
 
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID()); 
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double p1Mass = Sim->species.getMass(particle1); 
+    double p2Mass = Sim->species.getMass(particle2);
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
 
     bool infinite_masses = (p1Mass == HUGE_VAL) && (p2Mass == HUGE_VAL);
     if (infinite_masses)
@@ -476,7 +519,7 @@ namespace dynamo {
       {
 	updateParticle(Sim->particles[ID]);
       
-	double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	double mass = Sim->species.getMass(Sim->particles[ID]);
 	structmass1 += mass;
       
 	Vector pos(Sim->particles[ID].getPosition()),
@@ -493,7 +536,7 @@ namespace dynamo {
       {
 	updateParticle(Sim->particles[ID]);
 
-	double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	double mass = Sim->species.getMass(Sim->particles[ID]);
 	structmass2 += mass;
       
 	Vector pos(Sim->particles[ID].getPosition()),
@@ -556,7 +599,7 @@ namespace dynamo {
     for (const size_t& ID : range1)
       {
 	updateParticle(Sim->particles[ID]);
-	double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	double mass = Sim->species.getMass(Sim->particles[ID]);
 
 	structmass1 += mass;
 
@@ -574,7 +617,7 @@ namespace dynamo {
       {
 	updateParticle(Sim->particles[ID]);
 
-	double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	double mass = Sim->species.getMass(Sim->particles[ID]);
       
 	structmass2 += mass;
       
@@ -659,9 +702,9 @@ namespace dynamo {
   
     retVal.rvdot = (retVal.rij | retVal.vijold);
   
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double p1Mass = Sim->species.getMass(particle1);
+    double p2Mass = Sim->species.getMass(particle2);
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
 
     bool infinite_masses = (p1Mass == HUGE_VAL) && (p2Mass == HUGE_VAL);
     if (infinite_masses)
@@ -953,7 +996,7 @@ namespace dynamo {
 
     Sim->BCs->applyBC(pos, vel);
   
-    double pmass = Sim->species[retVal.getSpeciesID()]->getMass(part.getID());
+    double pmass = Sim->species.getMass(part);
     double mu = (pmass * mass) / (mass + pmass);
 
     Vector vwall(fL.wallVelocity());
@@ -1121,7 +1164,7 @@ namespace dynamo {
     // \Delta {\bf v}_{imp}
     Vector vr = retVal.vijold + (cp.first * fL.getw1() ^ fL.getu1()) - (cp.second * fL.getw2() ^ fL.getu2());
   
-    const double mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
+    const double mass = Sim->species.getMass(particle1);
     const double inertia = Sim->species[retVal.particle1_.getSpeciesID()]->getScalarMomentOfInertia(particle1.getID());
 
     retVal.impulse = uPerp * (((vr | uPerp) * (1.0 + elasticity)) / ((2.0 / mass) + ((cp.first * cp.first + cp.second * cp.second) / inertia)));
@@ -1162,8 +1205,8 @@ namespace dynamo {
     
     Sim->BCs->applyBC(retVal.rij, retVal.vijold);
   
-    double p1Mass = Sim->species[retVal.particle1_.getSpeciesID()]->getMass(particle1.getID());
-    double p2Mass = Sim->species[retVal.particle2_.getSpeciesID()]->getMass(particle2.getID());
+    double p1Mass = Sim->species.getMass(particle1);
+    double p2Mass = Sim->species.getMass(particle2);
 
     retVal.rvdot = (retVal.rij | retVal.vijold);
 
@@ -1172,7 +1215,7 @@ namespace dynamo {
     const Vector rcrossgij = rijhat ^ gij;
     const double rdotgij = rijhat | gij;
 
-    double mu = 1.0 / ((1.0 / p1Mass) + (1.0 / p2Mass));
+    double mu = 1.0 / (Sim->species.getInvMass(particle1) + Sim->species.getInvMass(particle2));
 
     double I = 2.0/5.0;
     
@@ -1208,7 +1251,7 @@ namespace dynamo {
 
     ParticleEventData retVal(part, *Sim->species[part], WALL);
 
-    double p1Mass = Sim->species[retVal.getSpeciesID()]->getMass(part.getID()); 
+    double p1Mass = Sim->species.getMass(part); 
 
     double Jbar = Sim->species[retVal.getSpeciesID()]->getScalarMomentOfInertia(part.getID())
       / (p1Mass * r * r);
@@ -38,6 +38,9 @@ namespace dynamo {
     virtual double SphereSphereInRoot(const IDRange& p1, const IDRange& p2, double d) const;
     virtual double SphereSphereOutRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual double SphereSphereOutRoot(const IDRange& p1, const IDRange& p2, double d) const;  
+    virtual void SphereSphereInRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
+    virtual void SphereSphereOutRoot(const PairBatch& batch, const std::vector<double>& d, std::vector<double>& dt) const;
+    virtual size_t sphereOverlaps(const PairBatch& batch, const std::vector<double>& d) const;
     virtual double sphereOverlap(const Particle& p1, const Particle& p2, const double& d) const;
     virtual double CubeCubeInRoot(const Particle& p1, const Particle& p2, double d) const;
     virtual bool cubeOverlap(const Particle& p1, const Particle& p2, const double d) const;
@@ -49,6 +52,7 @@ namespace dynamo {
     virtual double getPBCSentinelTime(const Particle&, const double&) const;
     virtual PairEventData SmoothSpheresColl(const IntEvent&, const double&, const double&, const EEventType& eType) const;
     virtual bool DSMCSpheresTest(Particle&, Particle&, double&, const double&, Vector) const;
+    virtual double DSMCSpheresProbability(Particle&, Particle&, const double&, Vector) const;
     virtual PairEventData DSMCSpheresRun(Particle&, Particle&, const double&, Vector) const;
     virtual PairEventData SphereWellEvent(const IntEvent&, const double&, const double&, size_t) const;
     virtual double getPlaneEvent(const Particle&, const Vector &, const Vector &, double) const;
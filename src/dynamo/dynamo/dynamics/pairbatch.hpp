@@ -0,0 +1,70 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/math/vector.hpp>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief Scratch storage for predicting the events between one
+    particle and a batch of its neighbours.
+
+    The relative positions and velocities of the pairs are stored in
+    structure-of-arrays form so that the Dynamics and
+    BoundaryCondition classes can process the whole batch in tight,
+    vectorisable loops (see Dynamics::getPairBatch). The remaining
+    arrays are general per-pair scratch space for the Interaction
+    which owns the batch, so that no allocations are performed once
+    the batch has grown to the typical neighbourhood size.
+   */
+  struct PairBatch
+  {
+    PairBatch(): p1ID(0) {}
+
+    /*! \brief Resize all of the per-pair arrays to hold N pairs. */
+    void resize(const size_t N)
+    {
+      for (size_t n(0); n < NDIM; ++n)
+	{
+	  rij[n].resize(N);
+	  vij[n].resize(N);
+	}
+      inner_d.resize(N);
+      outer_d.resize(N);
+      inner_dt.resize(N);
+      outer_dt.resize(N);
+      state.resize(N);
+    }
+
+    size_t size() const { return IDs.size(); }
+
+    //! The ID of the particle the batch is centred on.
+    size_t p1ID;
+    //! The IDs of the partner particles.
+    std::vector<size_t> IDs;
+    //! The minimum image separation vectors \f$\bm r_{12}\f$.
+    std::vector<double> rij[NDIM];
+    //! The corresponding relative velocities \f$\bm v_{12}\f$.
+    std::vector<double> vij[NDIM];
+    //! Interaction distances for the inner/outer root searches.
+    std::vector<double> inner_d, outer_d;
+    //! Event times returned from the inner/outer root searches.
+    std::vector<double> inner_dt, outer_dt;
+    //! Per-pair state of the Interaction (e.g., the capture state).
+    std::vector<size_t> state;
+  };
+}
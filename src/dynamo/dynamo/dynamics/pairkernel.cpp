@@ -0,0 +1,60 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/dynamics/pairkernel.hpp>
+#include <dynamo/dynamics/multicanonical.hpp>
+#include <dynamo/dynamics/multicanonical_contactmap.hpp>
+#include <typeinfo>
+
+namespace dynamo {
+  void
+  PairKernel::select(const Simulation* Sim) const
+  {
+    _dynamics = Sim->dynamics.get();
+    _BC = Sim->BCs.get();
+    _typedBC = NULL;
+    _type = GENERIC;
+
+    if (!_dynamics || !_BC) return;
+
+    //The types must match exactly, as derived classes may override
+    //the pair tests. The multicanonical Dynamics only change how the
+    //events are run, not when they occur.
+    const std::type_info& dynamics = typeid(*_dynamics);
+    if ((dynamics != typeid(DynNewtonian))
+	&& (dynamics != typeid(DynNewtonianMC))
+	&& (dynamics != typeid(DynNewtonianMCCMap)))
+      return;
+
+    const std::type_info& BC = typeid(*_BC);
+    if (BC == typeid(BCNone))
+      {
+	_typedBC = dynamic_cast<const BCNone*>(_BC);
+	_type = NEWTONIAN_NONE;
+      }
+    else if (BC == typeid(BCPeriodic))
+      {
+	_typedBC = static_cast<const BCPeriodic*>(_BC);
+	_type = NEWTONIAN_PERIODIC;
+      }
+    else if (BC == typeid(BCLeesEdwards))
+      {
+	_typedBC = static_cast<const BCLeesEdwards*>(_BC);
+	_type = NEWTONIAN_LEESEDWARDS;
+      }
+  }
+}
@@ -0,0 +1,127 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/None.hpp>
+#include <dynamo/BC/LEBC.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
+
+namespace dynamo {
+  class Dynamics;
+
+  /*! \brief Selects a compile time specialised pair test for the
+    current Dynamics and BoundaryCondition.
+
+    A pair event test through the generic interface calls the
+    virtual Dynamics::SphereSphereInRoot, which calls the virtual
+    BoundaryCondition::applyBC, before the intersection test
+    itself. For the most common combinations of the Dynamics and
+    BoundaryCondition, an Interaction can instead compile the whole
+    test as one function, using a NewtonianPairKernel.
+
+    The Interaction holds a PairKernel, and switches on the result of
+    get() to the matching instantiation of its test. The selection is
+    cached, and only repeated if the Dynamics or BoundaryCondition of
+    the Simulation is replaced (e.g., by the compression
+    plugin). Unsupported combinations return GENERIC, and the
+    Interaction falls back to the virtual calls.
+   */
+  class PairKernel
+  {
+  public:
+    enum Type
+      {
+	GENERIC, //!< Use the virtual Dynamics and BoundaryCondition calls.
+	NEWTONIAN_NONE, //!< NewtonianPairKernel<BCNone>
+	NEWTONIAN_PERIODIC, //!< NewtonianPairKernel<BCPeriodic>
+	NEWTONIAN_LEESEDWARDS //!< NewtonianPairKernel<BCLeesEdwards>
+      };
+
+    PairKernel(): _type(GENERIC), _dynamics(NULL), _BC(NULL), _typedBC(NULL) {}
+
+    //! \brief The kernel to use for the current Simulation state.
+    inline Type get(const Simulation* Sim) const
+    {
+      if ((Sim->dynamics.get() != _dynamics) || (Sim->BCs.get() != _BC))
+	select(Sim);
+      return _type;
+    }
+
+    /*! \brief The BoundaryCondition of the selected kernel, cast to
+        its exact type.
+
+	BCNone is a virtual base class, so this cast is done once in
+	select(), rather than for every test.
+     */
+    template<class BCType>
+    inline const BCType& getBC() const
+    { return *static_cast<const BCType*>(_typedBC); }
+
+  private:
+    void select(const Simulation* Sim) const;
+
+    mutable Type _type;
+    mutable const Dynamics* _dynamics;
+    mutable const BoundaryCondition* _BC;
+    mutable const void* _typedBC;
+  };
+
+  /*! \brief The pair tests of DynNewtonian, for a BoundaryCondition
+    of a known type.
+
+    Each method gives exactly the same result as the corresponding
+    DynNewtonian method, but the boundary condition is applied
+    through its non-virtual minimumImage() so the whole test may be
+    inlined.
+
+    \tparam BCType The exact type of the BoundaryCondition.
+   */
+  template<class BCType>
+  class NewtonianPairKernel
+  {
+  public:
+    NewtonianPairKernel(const Simulation* Sim, const PairKernel& kernel):
+      _BC(kernel.getBC<BCType>()),
+      _L(Sim->primaryCellSize)
+    {}
+
+    //! \brief The minimum image separation and relative velocity of a pair.
+    inline void separation(const Particle& p1, const Particle& p2, Vector& r12, Vector& v12) const
+    {
+      r12 = p1.getPosition() - p2.getPosition();
+      v12 = p1.getVelocity() - p2.getVelocity();
+      _BC.BCType::minimumImage(r12, v12, _L);
+    }
+
+    //! \brief As DynNewtonian::SphereSphereInRoot, for a separation.
+    static inline double sphereInRoot(const Vector& r12, const Vector& v12, double d)
+    { return magnet::intersection::ray_sphere(r12, v12, d); }
+
+    //! \brief As DynNewtonian::SphereSphereOutRoot, for a separation.
+    static inline double sphereOutRoot(const Vector& r12, const Vector& v12, double d)
+    { return magnet::intersection::ray_inv_sphere(r12, v12, d); }
+
+    //! \brief As DynNewtonian::sphereOverlap() > 0, for a separation.
+    static inline bool sphereOverlap(const Vector& r12, double d)
+    { return std::sqrt(r12 | r12) < d; }
+
+  private:
+    const BCType& _BC;
+    const Vector& _L;
+  };
+}
@@ -108,6 +108,13 @@ namespace dynamo {
     return retval;
   }
 
+  void
+  EnsembleNVT::setTemperature(double kT)
+  {
+    EnsembleVals[2] = kT;
+    std::static_pointer_cast<SysAndersen>(thermostat)->setTemperature(kT);
+  }
+
   double 
   EnsembleNVT::exchangeProbability(const Ensemble& oE) const
   {
@@ -123,6 +123,11 @@ namespace dynamo {
 
     virtual const std::array<double,3>& getEnsembleVals() const { return EnsembleVals; }
 
+    /*! \brief Change the temperature of the Ensemble and its
+      thermostat (in simulation units).
+     */
+    void setTemperature(double kT);
+
   protected:
     shared_ptr<System> thermostat;
   };
@@ -79,8 +79,7 @@ namespace dynamo {
 
     Sim->_sigParticleUpdate(EDat);
 
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent, EDat);
 
     Sim->ptrScheduler->fullUpdate(part);
   }
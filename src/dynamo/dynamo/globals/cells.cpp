@@ -25,6 +25,7 @@
 #include <dynamo/BC/LEBC.hpp>
 #include <dynamo/ranges/IDRangeList.hpp>
 #include <magnet/xmlwriter.hpp>
+#include <magnet/memUsage.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cstdio>
 #include <set>
@@ -32,6 +33,23 @@
 
 namespace {
   const bool verbose = false;
+
+  /*! \brief Test if two cells are within overlink cells of each
+    other in every dimension of a periodic grid.
+   */
+  bool cellsAreNeighbours(const magnet::math::MortonNumber<3>& cell1,
+			  const magnet::math::MortonNumber<3>& cell2,
+			  const size_t cellCount[3], const size_t overlink)
+  {
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	size_t separation = std::max(cell1[iDim].getRealValue(), cell2[iDim].getRealValue())
+	  - std::min(cell1[iDim].getRealValue(), cell2[iDim].getRealValue());
+	separation = std::min(separation, cellCount[iDim] - separation);
+	if (separation > overlink) return false;
+      }
+    return true;
+  }
 }
 
 namespace dynamo {
@@ -262,6 +280,60 @@ namespace dynamo {
       Sim->ptrScheduler->initialise();
   }
 
+  void
+  GCells::expandMaxInteractionRange(double newRange)
+  {
+    if (!_initialised || (newRange < _maxInteractionRange))
+      {
+	setMaxInteractionRange(newRange);
+	return;
+      }
+
+    dout << "Resizing the cells on collision " << Sim->eventCount << std::endl;
+
+    _maxInteractionRange = newRange;
+
+    //Store the old cell of each particle and the old size of the
+    //grid, to find the pairs which were not already neighbours
+    const size_t oldCellCount[3] = {cellCount[0], cellCount[1], cellCount[2]};
+    std::vector<size_t> oldCells(Sim->N);
+    for (const std::pair<const size_t, size_t>& entry : partCellData)
+      oldCells[entry.first] = entry.second;
+
+    addCells((_maxInteractionRange 
+	      * (1.0 + 10 * std::numeric_limits<double>::epsilon()))
+	     * _oversizeCells / overlink);
+
+    //The old cell events are discarded by the Scheduler as their
+    //cells no longer exist
+    invalidateEvents();
+
+    size_t newPairs(0);
+    std::vector<size_t> neighbours;
+    for (const size_t& id : *range)
+      {
+	Particle& part = Sim->particles[id];
+	const magnet::math::MortonNumber<3> oldCell(oldCells[id]);
+
+	neighbours.clear();
+	getParticleNeighbours(part, neighbours);
+
+	//The relation is symmetric, so each new pair is only signalled
+	//once, as a single valid event per pair is sufficient
+	for (const size_t& id2 : neighbours)
+	  if ((id2 > id) && !cellsAreNeighbours(oldCell, oldCells[id2], oldCellCount, overlink))
+	    {
+	      _sigNewNeighbour(part, id2);
+	      ++newPairs;
+	    }
+
+	Sim->ptrScheduler->pushEvent(part, getEvent(part));
+	Sim->ptrScheduler->sort(part);
+      }
+
+    dout << "Signalled " << newPairs << " new neighbour pairs" << std::endl;
+  }
+
   void
   GCells::outputXML(magnet::xml::XmlStream& XML) const
   { 
@@ -460,6 +532,15 @@ namespace dynamo {
     return retval;
   }
 
+  size_t
+  GCells::getMemoryUsage() const
+  {
+    size_t bytes = magnet::container_mem_usage(list) + magnet::container_mem_usage(partCellData);
+    for (const std::vector<size_t>& cell : list)
+      bytes += magnet::container_mem_usage(cell);
+    return bytes;
+  }
+
   Vector 
   GCells::calcPosition(const magnet::math::MortonNumber<3>& coords, const Particle& part) const
   {
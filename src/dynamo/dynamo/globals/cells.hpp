@@ -61,6 +61,17 @@ namespace dynamo {
 
     virtual void reinitialise();
 
+    /*! \brief Resize the cells to support a larger interaction range,
+      without rebuilding the events of the Scheduler.
+
+      The particles are sorted into the new cells, and only the pairs
+      of particles which were not in neighbouring cells of the old
+      grid are signalled as new neighbours. The cell events of every
+      particle are replaced, and the old cell events are discarded by
+      the Scheduler as out of date.
+     */
+    virtual void expandMaxInteractionRange(double);
+
     virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
     virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
     
@@ -71,6 +82,8 @@ namespace dynamo {
 
     virtual double getMaxSupportedInteractionLength() const;
 
+    virtual size_t getMemoryUsage() const;
+
   protected:
     void getParticleNeighbours(const magnet::math::MortonNumber<3>&, std::vector<size_t>&) const;
 
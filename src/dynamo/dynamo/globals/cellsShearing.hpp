@@ -38,6 +38,12 @@ namespace dynamo {
     virtual void getParticleNeighbours(const Particle&, std::vector<size_t>&) const;
     virtual void getParticleNeighbours(const Vector&, std::vector<size_t>&) const;
 
+    /*! \brief The neighbourhoods across the sheared boundaries
+      depend on the time, so the cells are always rebuilt in full.
+     */
+    virtual void expandMaxInteractionRange(double range)
+    { setMaxInteractionRange(range); }
+
   protected:
     void getParticleNeighbours(const magnet::math::MortonNumber<3>&, std::vector<size_t>&) const;
     void getAdditionalLEParticleNeighbourhood(const Particle&, std::vector<size_t>&) const;
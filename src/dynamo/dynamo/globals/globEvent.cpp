@@ -29,7 +29,8 @@ namespace dynamo {
   GlobalEvent::GlobalEvent(const Particle& part1, const double &delt, 
 			   EEventType nType, const Global& glob):
     particle_(&part1), dt(delt), 
-    CType(nType), globalID(glob.getID())
+    CType(nType), globalID(glob.getID()),
+    generation(glob.getEventGeneration())
   {}
   
   magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream &XML, 
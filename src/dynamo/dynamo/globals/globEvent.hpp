@@ -75,6 +75,9 @@ namespace dynamo {
 
     const size_t& getGlobalID() const { return globalID; } 
 
+    //! \brief The event generation of the Global when this event was calculated.
+    unsigned long getGeneration() const { return generation; }
+
     inline void scaleTime(const double& scale)
     { dt *= scale; }
 
@@ -83,5 +86,6 @@ namespace dynamo {
     double dt;
     EEventType CType;
     size_t globalID;
+    unsigned long generation;
   };
 }
@@ -27,7 +27,8 @@
 namespace dynamo {
   Global::Global(dynamo::Simulation* tmp, std::string name, IDRange* nR):
     SimBase(tmp, name),
-    range(nR ? nR : new IDRangeAll(tmp))
+    range(nR ? nR : new IDRangeAll(tmp)),
+    _eventGeneration(0)
   {}
 
   bool 
@@ -93,8 +93,29 @@ namespace dynamo {
     /*! \brief Returns the unique ID number of this Global.
      */
     inline const size_t& getID() const { return ID; }
+
+    /*! \brief Returns the bytes of memory held by the data
+        structures of this Global.
+     */
+    virtual size_t getMemoryUsage() const { return 0; }
+
+    /*! \brief Returns the generation of the events of this Global.
+
+      The generation is stored in each event when it is calculated,
+      and the Scheduler discards any queued event from an earlier
+      generation (see invalidateEvents()).
+     */
+    unsigned long getEventGeneration() const { return _eventGeneration; }
   
   protected:
+    /*! \brief Marks every queued event of this Global as out of date.
+
+      This allows a Global to replace the events of all of the
+      particles without the Scheduler rebuilding the rest of their
+      events.
+     */
+    void invalidateEvents() { ++_eventGeneration; }
+
     /*! \brief Writes out an XML representation of the Global
      */
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
@@ -102,6 +123,7 @@ namespace dynamo {
     shared_ptr<IDRange> range;  
     std::string globName;
     size_t ID;
+    unsigned long _eventGeneration;
   };
 }
 
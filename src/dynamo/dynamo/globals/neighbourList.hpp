@@ -90,6 +90,19 @@ namespace dynamo {
       if (_initialised) reinitialise();
     }
 
+    /*! \brief Increase the range this neighbourlist supports while
+      the simulation is running.
+
+      Unlike setMaxInteractionRange(), which reinitialises the
+      neighbourlist and rebuilds every event in the Scheduler,
+      neighbourlists which can find the pairs of particles that become
+      neighbours only signal those pairs (through _sigNewNeighbour), as
+      the events of the existing pairs remain valid. This default
+      implementation falls back to setMaxInteractionRange().
+     */
+    virtual void expandMaxInteractionRange(double range)
+    { setMaxInteractionRange(range); }
+
     /*! \brief Returns the requested minimum supported interaction
         range.
      */
@@ -144,8 +144,7 @@ namespace dynamo {
     //Now we're past the event update the scheduler and plugins
     Sim->ptrScheduler->fullUpdate(part);
   
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent, EDat);
 
   }
 
@@ -53,15 +53,15 @@ namespace dynamo {
   {
     ID=nID;
 
-    try {
-      _NBListID = Sim->globals[_nblistName]->getID();
-    }
-    catch(std::exception& cxp)
-      {
-	M_throw() << "Failed while finding the neighbour list global.\n"
-		  << "You must have a neighbour list for this waker event"
-		  << cxp.what();
-      }
+    //The neighbour list may be initialised after this Global, so its
+    //ID is taken from its position in the container
+    auto nblist = Sim->globals.find(_nblistName);
+    if (nblist == Sim->globals.end())
+      M_throw() << "Failed while finding the neighbour list global.\n"
+		<< "You must have a neighbour list named " << _nblistName 
+		<< " for this waker event";
+
+    _NBListID = nblist - Sim->globals.begin();
   
     if (!std::dynamic_pointer_cast<GNeighbourList>(Sim->globals[_NBListID]))
       M_throw() << "The Global named SchedulerNBList is not a neighbour list!";
@@ -71,7 +71,7 @@ namespace dynamo {
   void 
   GWaker::operator<<(const magnet::xml::Node& XML)
   {
-    range = shared_ptr<IDRange>(IDRange::getClass(XML, Sim));
+    range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
 
     try {
       globName = XML.getAttribute("Name");
@@ -144,8 +144,7 @@ namespace dynamo {
       
     Sim->_sigParticleUpdate(EDat);
       
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent, EDat);
 
     //Now we're past the event, update the scheduler and plugins
     Sim->ptrScheduler->fullUpdate(part);
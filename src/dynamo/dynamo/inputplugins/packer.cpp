@@ -37,6 +37,7 @@
 #include <dynamo/locals/lwall.hpp>
 #include <dynamo/locals/oscillatingplate.hpp>
 #include <dynamo/systems/DSMCspheres.hpp>
+#include <dynamo/systems/DSMCcells.hpp>
 #include <dynamo/systems/rescale.hpp>
 #include <dynamo/systems/sleep.hpp>
 #include <magnet/math/matrix.hpp>
@@ -972,7 +973,8 @@ namespace dynamo {
 	      std::cout<<
 		"Mode specific options:\n"
 		"  10: Monocomponent hard spheres using DSMC interactions\n"
-		"       --i1 : Picks the packing routine to use [0] (0:FCC,1:BCC,2:SC)\n";
+		"       --i1 : Picks the packing routine to use [0] (0:FCC,1:BCC,2:SC)\n"
+		"       --b1 : Use the parallel cell based DSMC collisions\n";
 	      exit(1);
 	    }
 	  //Pack of DSMC hard spheres
@@ -1014,11 +1016,20 @@ namespace dynamo {
 	    / (4.0 * std::sqrt(M_PI) * vm["density"].as<double>() * chi);
 
 	  //No thermostat added yet
-	  Sim->systems.push_back
-	    (shared_ptr<System>
-	     (new SysDSMCSpheres(Sim, particleDiam,
-				 2.0 * tij / latticeSites.size(), chi, 1.0,
+	  if (vm.count("b1"))
+	    //Around 20 particles per cell, and each particle collides
+	    //every 10 steps
+	    Sim->systems.push_back
+	      (shared_ptr<System>
+	       (new SysDSMCCells(Sim, particleDiam, 0.1 * tij, chi, 1.0,
+				 std::cbrt(20.0 * simVol / latticeSites.size()),
 				 "Thermostat", new IDRangeAll(Sim), new IDRangeAll(Sim))));
+	  else
+	    Sim->systems.push_back
+	      (shared_ptr<System>
+	       (new SysDSMCSpheres(Sim, particleDiam,
+				   2.0 * tij / latticeSites.size(), chi, 1.0,
+				   "Thermostat", new IDRangeAll(Sim), new IDRangeAll(Sim))));
 
 	  Sim->addSpecies(shared_ptr<Species>
 			  (new SpPoint(Sim, new IDRangeAll(Sim), 1.0, "Bulk", 0,
@@ -1048,7 +1059,8 @@ namespace dynamo {
 		"       --i2 : Picks the g(r) to use (0:BMCSL, 1:VS, 2:HC2)\n"
 		"       --f1 : Size Ratio (B/A), must be (0,1] [0.1]\n"
 		"       --f2 : Mass Ratio (B/A) [0.001]\n"
-		"       --f3 : Mol Fraction of large system (A) [0.95]\n";
+		"       --f3 : Mol Fraction of large system (A) [0.95]\n"
+		"       --b1 : Use the parallel cell based DSMC collisions\n";
 	      exit(1);
 	    }
 	  //Pack the system, determine the number of particles
@@ -1189,11 +1201,24 @@ namespace dynamo {
 
 	  Sim->interactions.push_back(shared_ptr<Interaction>(new IHardSphere(Sim, sizeRatio * particleDiam, new IDPairRangeSingle(new IDRangeRange(nA, latticeSites.size() - 1)), "BBInt")));
 
-	  Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, particleDiam, tAA / (2.0 * nA), chiAA, 1.0, "AADSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(0, nA - 1))));
+	  if (vm.count("b1"))
+	    {
+	      const double cellWidth = std::cbrt(20.0 * simVol / latticeSites.size());
+
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCCells(Sim, particleDiam, 0.1 * tAA, chiAA, 1.0, cellWidth, "AADSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(0, nA - 1))));
 
-	  Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, ((1.0 + sizeRatio) / 2.0) * particleDiam, tAB / (2.0 * nA), chiAB, 1.0, "ABDSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCCells(Sim, ((1.0 + sizeRatio) / 2.0) * particleDiam, 0.1 * tAB, chiAB, 1.0, cellWidth, "ABDSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
 
-	  Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, sizeRatio * particleDiam, tBB / (2.0 * (latticeSites.size() - nA)), chiBB, 1.0, "BBDSMC", new IDRangeRange(nA, latticeSites.size() - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCCells(Sim, sizeRatio * particleDiam, 0.1 * tBB, chiBB, 1.0, cellWidth, "BBDSMC", new IDRangeRange(nA, latticeSites.size() - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
+	    }
+	  else
+	    {
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, particleDiam, tAA / (2.0 * nA), chiAA, 1.0, "AADSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(0, nA - 1))));
+
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, ((1.0 + sizeRatio) / 2.0) * particleDiam, tAB / (2.0 * nA), chiAB, 1.0, "ABDSMC", new IDRangeRange(0, nA - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
+
+	      Sim->systems.push_back(shared_ptr<System>(new SysDSMCSpheres(Sim, sizeRatio * particleDiam, tBB / (2.0 * (latticeSites.size() - nA)), chiBB, 1.0, "BBDSMC", new IDRangeRange(nA, latticeSites.size() - 1), new IDRangeRange(nA, latticeSites.size() - 1))));
+	    }
 
 
 	  Sim->addSpecies(shared_ptr<Species>(new SpPoint(Sim, new IDRangeRange(0, nA - 1), 1.0, "A", 0, "AAInt")));
@@ -20,18 +20,14 @@
 #include <dynamo/particle.hpp>
 #include <dynamo/interactions/interaction.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/memUsage.hpp>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 
 namespace dynamo {
   namespace detail {
-    namespace {
-      ::std::size_t
-      hash_combine(const ::std::size_t hash1, const ::std::size_t hash2)
-      {
-	return hash1 ^ (hash2 + 0x9e3779b9 + (hash1 << 6) + (hash1 >> 2));
-      }
-    }
-
     /*! \brief A key used to represent a pair of two particles.
       
       This key sorts the particle ID's into ascending order. This way
@@ -73,34 +69,54 @@ namespace dynamo {
        access operator is overloaded to automatically return a size_t
        0 for any entry which is missing. It also returns a proxy which
        deletes entries when they are set to 0.
+
+       The CaptureMap also maintains a Zobrist hash of its contents,
+       which is the exclusive or of a hash of every stored (pair,
+       state) entry. As the exclusive or is its own inverse, the hash
+       is updated in O(1) whenever an entry is changed, instead of
+       being recalculated from the whole map (see hash()). For this to
+       remain valid, the map must only be altered through the array
+       access operator or clear().
     */
     class CaptureMap: public std::map<PairKey, size_t>
     {
       typedef std::map<PairKey, size_t> Container;
     public:
+      CaptureMap(): _hash(0) {}
+
       /*!\brief This proxy is used to double check if an assignment of
          zero is done, and delete the entry if it is. */
       struct EntryProxy {
       public:
-	EntryProxy(Container& container, const PairKey& key):
+	EntryProxy(CaptureMap& container, const PairKey& key):
 	  _container(container), _key(key) {}
 
 	operator const size_t() const {
-	  Container::const_iterator it = _container.find(_key);
-	  return (it == _container.end()) ? 0 : (it->second);
+	  Container::const_iterator it = _container.Container::find(_key);
+	  return (it == _container.Container::end()) ? 0 : (it->second);
 	}
 	
 	EntryProxy& operator=(size_t newval) {
-	  if (newval == 0)
-	    _container.erase(_key);
-	  else
-	    _container[_key] = newval;
+	  Container::iterator it = _container.Container::find(_key);
+	  if (it != _container.Container::end())
+	    {
+	      _container._hash ^= entryHash(_key, it->second);
+	      if (newval == 0)
+		_container.Container::erase(it);
+	      else
+		it->second = newval;
+	    }
+	  else if (newval != 0)
+	    _container.Container::insert(Container::value_type(_key, newval));
+
+	  if (newval != 0)
+	    _container._hash ^= entryHash(_key, newval);
 
 	  return *this;
 	}
 	
       private:
-	Container& _container;
+	CaptureMap& _container;
 	const PairKey _key;
       };
       
@@ -116,21 +132,58 @@ namespace dynamo {
 	Container::const_iterator it = Container::find(key);
 	return (it == Container::end()) ? 0 : (it->second); 
       }
+
+      //! \brief Remove all entries from the map.
+      void clear() { Container::clear(); _hash = 0; }
+
+      /*! \brief The Zobrist hash of the current contents of the map.
+
+	Two equal maps always have the same hash, independent of the
+	order in which their entries were added.
+       */
+      std::size_t hash() const { return _hash; }
+
+      //! \brief The contribution of a single entry to the hash().
+      static std::size_t entryHash(const PairKey& key, const size_t state) {
+	return mix(mix(mix(key.first) + key.second) + state);
+      }
+
+    private:
+      //! \brief The 64-bit finaliser of the splitmix64 generator.
+      static std::size_t mix(uint64_t x) {
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+      }
+
+      std::size_t _hash;
     };
 
+    /*! \brief A copy of the contents of a CaptureMap, stored in a
+        sorted vector.
+
+	This is a compact representation of a CaptureMap, used to
+	store many different maps (e.g., the visited contact maps of a
+	simulation). The hash of the original map is also stored.
+     */
     struct CaptureMapKey: public std::vector<CaptureMap::value_type>
     {
       typedef std::vector<CaptureMap::value_type> Container;
       CaptureMapKey(const CaptureMap& map):
-	Container(map.begin(), map.end())
+	Container(map.begin(), map.end()),
+	_hash(map.hash())
       {}
 
-      std::size_t hash() const {
-	std::size_t hash(0);
-	for (const Container::value_type& val : *this)
-	  hash = hash_combine(hash, hash_combine(val.first.first, hash_combine(val.first.second, val.second)));
-	return hash;
+      std::size_t hash() const { return _hash; }
+
+      //! \brief Compare the entries against those of a CaptureMap.
+      bool operator==(const CaptureMap& map) const {
+	return (size() == map.size()) && std::equal(begin(), end(), map.begin());
       }
+
+    private:
+      std::size_t _hash;
     };
 
     /*! \brief A functor to allow the storage of CaptureMapKey types
@@ -176,6 +229,8 @@ namespace dynamo {
 
     virtual size_t captureTest(const Particle&, const Particle&) const = 0;
 
+    virtual size_t getMemoryUsage() const { return magnet::container_mem_usage(static_cast<const Map&>(*this)); }
+
   protected:  
     bool noXmlLoad;
 
@@ -282,8 +282,7 @@ namespace dynamo {
     
     Sim->ptrScheduler->fullUpdate(p1, p2);
     
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, retval);
+    Sim->outputPluginBus.eventUpdate(iEvent, retval);
   }
    
   void 
@@ -106,6 +106,18 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
+    switch (_kernel.get(Sim))
+      {
+      case PairKernel::NEWTONIAN_NONE:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCNone>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_PERIODIC:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCPeriodic>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_LEESEDWARDS:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCLeesEdwards>(Sim, _kernel));
+      default:
+	break;
+      }
+
     double d = (_diameter->getProperty(p1.getID())
 		 + _diameter->getProperty(p2.getID())) * 0.5;
 
@@ -119,6 +131,75 @@ namespace dynamo {
     return IntEvent(p1,p2,HUGE_VAL, NONE, *this);  
   }
 
+  template<class Kernel>
+  IntEvent
+  IHardSphere::getKernelEvent(const Particle& p1, const Particle& p2, const Kernel& kernel) const
+  {
+    const double d = (_diameter->getProperty(p1.getID())
+		      + _diameter->getProperty(p2.getID())) * 0.5;
+
+    Vector r12, v12;
+    kernel.separation(p1, p2, r12, v12);
+
+    if (kernel.sphereOverlap(r12, d)) ++_overlapped_tests;
+
+    const double dt = kernel.sphereInRoot(r12, v12, d);
+    if (dt != HUGE_VAL)
+      return IntEvent(p1, p2, dt, CORE, *this);
+  
+    return IntEvent(p1, p2, HUGE_VAL, NONE, *this);  
+  }
+
+  template<class Kernel>
+  void
+  IHardSphere::getKernelEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events, const Kernel& kernel) const
+  {
+    const double d1 = _diameter->getProperty(p1.getID());
+    for (const size_t id2 : ids)
+      {
+	const Particle& p2 = Sim->particles[id2];
+	const double d = (d1 + _diameter->getProperty(id2)) * 0.5;
+
+	Vector r12, v12;
+	kernel.separation(p1, p2, r12, v12);
+
+	if (kernel.sphereOverlap(r12, d)) ++_overlapped_tests;
+
+	const double dt = kernel.sphereInRoot(r12, v12, d);
+	if (dt != HUGE_VAL)
+	  events.push_back(IntEvent(p1, p2, dt, CORE, *this));
+      }
+  }
+
+  void
+  IHardSphere::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    switch (_kernel.get(Sim))
+      {
+      case PairKernel::NEWTONIAN_NONE:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCNone>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_PERIODIC:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCPeriodic>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_LEESEDWARDS:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCLeesEdwards>(Sim, _kernel));
+      default:
+	break;
+      }
+
+    Sim->dynamics->getPairBatch(p1, ids, _batch);
+
+    const double d1 = _diameter->getProperty(p1.getID());
+    for (size_t i(0); i < _batch.size(); ++i)
+      _batch.inner_d[i] = (d1 + _diameter->getProperty(_batch.IDs[i])) * 0.5;
+
+    Sim->dynamics->SphereSphereInRoot(_batch, _batch.inner_d, _batch.inner_dt);
+    _overlapped_tests += Sim->dynamics->sphereOverlaps(_batch, _batch.inner_d);
+
+    for (size_t i(0); i < _batch.size(); ++i)
+      if (_batch.inner_dt[i] != HUGE_VAL)
+	events.push_back(IntEvent(p1, Sim->particles[_batch.IDs[i]], _batch.inner_dt[i], CORE, *this));
+  }
+
   void
   IHardSphere::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -154,8 +235,7 @@ namespace dynamo {
     //Now we're past the event, update the scheduler and plugins
     Sim->ptrScheduler->fullUpdate(p1, p2);
   
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent,EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent,EDat);
   }
    
   void 
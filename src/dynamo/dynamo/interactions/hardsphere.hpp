@@ -20,6 +20,8 @@
 #include <dynamo/interactions/interaction.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/interactions/glyphrepresentation.hpp>
+#include <dynamo/dynamics/pairbatch.hpp>
+#include <dynamo/dynamics/pairkernel.hpp>
 
 namespace dynamo {
   class IHardSphere: public GlyphRepresentation, public Interaction
@@ -70,6 +72,8 @@ namespace dynamo {
     virtual void rescaleLengths(double) {}
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
  
     virtual void runEvent(Particle&, Particle&, const IntEvent&);
    
@@ -80,6 +84,14 @@ namespace dynamo {
     void outputData(magnet::xml::XmlStream& XML) const;
 
   protected:
+    //! \brief getEvent() for the pair test kernel selected by _kernel.
+    template<class Kernel>
+    IntEvent getKernelEvent(const Particle&, const Particle&, const Kernel&) const;
+
+    //! \brief getEvents() for the pair test kernel selected by _kernel.
+    template<class Kernel>
+    void getKernelEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&, const Kernel&) const;
+
     shared_ptr<Property> _diameter;
     shared_ptr<Property> _e;
     shared_ptr<Property> _et;
@@ -88,5 +100,8 @@ namespace dynamo {
     mutable size_t _post_event_overlap;
     mutable double _accum_overlap_magnitude;
     mutable size_t _overlapped_tests;
+
+    mutable PairBatch _batch;
+    PairKernel _kernel;
   };
 }
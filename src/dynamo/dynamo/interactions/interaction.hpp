@@ -19,8 +19,10 @@
 
 #include <dynamo/base.hpp>
 #include <dynamo/ranges/IDPairRange.hpp>
+#include <dynamo/eventtypes.hpp>
 #include <string>
 #include <limits>
+#include <vector>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -72,10 +74,42 @@ namespace dynamo {
      */
     virtual IntEvent getEvent(const Particle &, const Particle &) const = 0;
 
+    /*! \brief Calculate the events between a particle and a batch
+        of its neighbours.
+
+	This is used by the Scheduler to predict the events of a
+	particle against its whole neighbourhood at once. The default
+	implementation simply calls getEvent for each neighbour, but
+	the common Interactions override it to use the batched
+	primitives of the Dynamics (e.g.,
+	Dynamics::SphereSphereInRoot(const PairBatch&, ...)).
+
+	\param p1 The particle to predict events for.
+	\param ids The IDs of the neighbours, which must all use this
+	Interaction with p1 and be up to date.
+	\param events Any valid events (i.e., not of type NONE) are
+	appended to this container.
+     */
+    virtual void getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const;
+
     /*! \brief Run the dynamics of an event which is occuring now.
      */
     virtual void runEvent(Particle&, Particle&, const IntEvent&) = 0;
 
+    /*! \brief Update the state of the Interaction for an event
+        which is being replayed from a trajectory (see EReplay).
+
+	The particle velocities have already been set by the replay,
+	so only the internal state (e.g., the capture map) needs to
+	be updated. The default implementation does nothing, which is
+	correct for all stateless Interactions.
+
+	\param eType The type of the IntEvent which was executed.
+	\param resultType The type of the resulting PairEventData
+	(e.g., BOUNCE if a well event failed).
+     */
+    virtual void replayEvent(const Particle&, const Particle&, EEventType eType, EEventType resultType) {}
+
     /*! \brief Return the maximum distance at which two particles may interact using this Interaction.
     
       This value is used in GNeighbourList's to make sure a certain
@@ -173,6 +207,11 @@ namespace dynamo {
 
     virtual void outputData(magnet::xml::XmlStream&) const {}
 
+    /*! \brief Returns the bytes of memory held by the data
+        structures of this Interaction (e.g., its capture map).
+     */
+    virtual size_t getMemoryUsage() const { return 0; }
+
   protected:
     /*! \brief This constructor is only to be used when using virtual
      inheritance, the bottom derived class must explicitly call the
@@ -108,8 +108,7 @@ namespace dynamo {
     //Now we're past the event, update the scheduler and plugins
     Sim->ptrScheduler->fullUpdate(p1, p2);
   
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent,EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent,EDat);
   }
    
   void 
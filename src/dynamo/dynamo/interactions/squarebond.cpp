@@ -191,8 +191,7 @@ namespace dynamo {
 
     Sim->_sigParticleUpdate(EDat);
     Sim->ptrScheduler->fullUpdate(p1, p2);
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent,EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent,EDat);
   }
     
   void 
@@ -122,6 +122,18 @@ namespace dynamo {
       M_throw() << "You shouldn't pass p1==p2 events to the interactions!";
 #endif 
 
+    switch (_kernel.get(Sim))
+      {
+      case PairKernel::NEWTONIAN_NONE:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCNone>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_PERIODIC:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCPeriodic>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_LEESEDWARDS:
+	return getKernelEvent(p1, p2, NewtonianPairKernel<BCLeesEdwards>(Sim, _kernel));
+      default:
+	break;
+      }
+
     double d = (_diameter->getProperty(p1.getID())
 		+ _diameter->getProperty(p2.getID())) * 0.5;
 
@@ -151,6 +163,100 @@ namespace dynamo {
     return retval;
   }
 
+  template<class Kernel>
+  IntEvent
+  ISquareWell::getKernelEvent(const Particle& p1, const Particle& p2, const Kernel& kernel) const
+  {
+    const double d = (_diameter->getProperty(p1.getID())
+		      + _diameter->getProperty(p2.getID())) * 0.5;
+
+    const double l = (_lambda->getProperty(p1.getID())
+		      + _lambda->getProperty(p2.getID())) * 0.5;
+
+    Vector r12, v12;
+    kernel.separation(p1, p2, r12, v12);
+
+    if (isCaptured(p1, p2))
+      {
+	const double dt_core = kernel.sphereInRoot(r12, v12, d);
+	const double dt_out = kernel.sphereOutRoot(r12, v12, l * d);
+
+	if (dt_out < dt_core)
+	  return IntEvent(p1, p2, dt_out, STEP_OUT, *this);
+	if (dt_core != HUGE_VAL)
+	  return IntEvent(p1, p2, dt_core, CORE, *this);
+      }
+    else
+      {
+	const double dt = kernel.sphereInRoot(r12, v12, l * d);
+	if (dt != HUGE_VAL)
+	  return IntEvent(p1, p2, dt, STEP_IN, *this);
+      }
+
+    return IntEvent(p1, p2, HUGE_VAL, NONE, *this);
+  }
+
+  template<class Kernel>
+  void
+  ISquareWell::getKernelEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events, const Kernel& kernel) const
+  {
+    for (const size_t id2 : ids)
+      {
+	const IntEvent event = getKernelEvent(p1, Sim->particles[id2], kernel);
+	if (event.getType() != NONE)
+	  events.push_back(event);
+      }
+  }
+
+  void
+  ISquareWell::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    switch (_kernel.get(Sim))
+      {
+      case PairKernel::NEWTONIAN_NONE:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCNone>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_PERIODIC:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCPeriodic>(Sim, _kernel));
+      case PairKernel::NEWTONIAN_LEESEDWARDS:
+	return getKernelEvents(p1, ids, events, NewtonianPairKernel<BCLeesEdwards>(Sim, _kernel));
+      default:
+	break;
+      }
+
+    Sim->dynamics->getPairBatch(p1, ids, _batch);
+
+    const double d1 = _diameter->getProperty(p1.getID());
+    const double l1 = _lambda->getProperty(p1.getID());
+    for (size_t i(0); i < _batch.size(); ++i)
+      {
+	const size_t id2 = _batch.IDs[i];
+	const double d = (d1 + _diameter->getProperty(id2)) * 0.5;
+	const double l = (l1 + _lambda->getProperty(id2)) * 0.5;
+	_batch.state[i] = isCaptured(p1.getID(), id2);
+	_batch.inner_d[i] = _batch.state[i] ? d : l * d;
+	_batch.outer_d[i] = l * d;
+      }
+
+    //Both roots are calculated for every pair, as this is cheaper
+    //than splitting the batch into captured and uncaptured pairs.
+    Sim->dynamics->SphereSphereInRoot(_batch, _batch.inner_d, _batch.inner_dt);
+    Sim->dynamics->SphereSphereOutRoot(_batch, _batch.outer_d, _batch.outer_dt);
+
+    for (size_t i(0); i < _batch.size(); ++i)
+      {
+	const Particle& p2 = Sim->particles[_batch.IDs[i]];
+	if (_batch.state[i])
+	  {
+	    if (_batch.outer_dt[i] < _batch.inner_dt[i])
+	      events.push_back(IntEvent(p1, p2, _batch.outer_dt[i], STEP_OUT, *this));
+	    else if (_batch.inner_dt[i] != HUGE_VAL)
+	      events.push_back(IntEvent(p1, p2, _batch.inner_dt[i], CORE, *this));
+	  }
+	else if (_batch.inner_dt[i] != HUGE_VAL)
+	  events.push_back(IntEvent(p1, p2, _batch.inner_dt[i], STEP_IN, *this));
+      }
+  }
+
   void
   ISquareWell::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -176,8 +282,7 @@ namespace dynamo {
 	  PairEventData retVal(Sim->dynamics->SmoothSpheresColl(iEvent, e, d2, CORE));
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 	  break;
 	}
       case STEP_IN:
@@ -186,8 +291,7 @@ namespace dynamo {
 	  if (retVal.getType() != BOUNCE) ICapture::add(p1, p2);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
 	  Sim->_sigParticleUpdate(retVal);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 	  break;
 	}
       case STEP_OUT:
@@ -196,8 +300,7 @@ namespace dynamo {
 	  if (retVal.getType() != BOUNCE) ICapture::remove(p1, p2);
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 	  break;
 	}
       default:
@@ -205,6 +308,24 @@ namespace dynamo {
       } 
   }
 
+  void
+  ISquareWell::replayEvent(const Particle& p1, const Particle& p2, EEventType eType, EEventType resultType)
+  {
+    if (resultType == BOUNCE) return;
+
+    switch (eType)
+      {
+      case STEP_IN:
+	ICapture::add(p1, p2);
+	break;
+      case STEP_OUT:
+	ICapture::remove(p1, p2);
+	break;
+      default:
+	break;
+      }
+  }
+
   bool
   ISquareWell::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
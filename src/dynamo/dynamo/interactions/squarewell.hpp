@@ -19,6 +19,8 @@
 
 #include <dynamo/interactions/captures.hpp>
 #include <dynamo/interactions/glyphrepresentation.hpp>
+#include <dynamo/dynamics/pairbatch.hpp>
+#include <dynamo/dynamics/pairkernel.hpp>
 #include <dynamo/simulation.hpp>
 
 namespace dynamo {
@@ -56,8 +58,12 @@ namespace dynamo {
     virtual void initialise(size_t);
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
   
     virtual void runEvent(Particle&, Particle&, const IntEvent&);
+
+    virtual void replayEvent(const Particle&, const Particle&, EEventType, EEventType);
   
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
@@ -69,9 +75,20 @@ namespace dynamo {
     ISquareWell(dynamo::Simulation* tmp, IDPairRange* nR):
       ICapture(tmp,nR) {}
 
+    //! \brief getEvent() for the pair test kernel selected by _kernel.
+    template<class Kernel>
+    IntEvent getKernelEvent(const Particle&, const Particle&, const Kernel&) const;
+
+    //! \brief getEvents() for the pair test kernel selected by _kernel.
+    template<class Kernel>
+    void getKernelEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&, const Kernel&) const;
+
     shared_ptr<Property> _diameter;
     shared_ptr<Property> _lambda;
     shared_ptr<Property> _wellDepth;
     shared_ptr<Property> _e;
+
+    mutable PairBatch _batch;
+    PairKernel _kernel;
   };
 }
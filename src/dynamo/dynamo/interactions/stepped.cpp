@@ -154,6 +154,48 @@ namespace dynamo {
     return retval;
   }
 
+  void
+  IStepped::getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+  {
+    Sim->dynamics->getPairBatch(p1, ids, _batch);
+
+    const double l1 = _lengthScale->getProperty(p1.getID());
+    for (size_t i(0); i < _batch.size(); ++i)
+      {
+	ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1.getID(), _batch.IDs[i]));
+	_batch.state[i] = (capstat == ICapture::end()) ? 0 : capstat->second;
+	const std::pair<double, double> step_bounds = _potential->getStepBounds(_batch.state[i]);
+	const double length_scale = 0.5 * (l1 + _lengthScale->getProperty(_batch.IDs[i]));
+	_batch.inner_d[i] = step_bounds.first * length_scale;
+	_batch.outer_d[i] = step_bounds.second * length_scale;
+      }
+
+    //Pairs without an inner or outer step still pass through the
+    //batched root searches, and their results are discarded below.
+    Sim->dynamics->SphereSphereInRoot(_batch, _batch.inner_d, _batch.inner_dt);
+    Sim->dynamics->SphereSphereOutRoot(_batch, _batch.outer_d, _batch.outer_dt);
+
+    for (size_t i(0); i < _batch.size(); ++i)
+      {
+	double dt = HUGE_VAL;
+	EEventType type = NONE;
+	if ((_batch.inner_d[i] != 0) && (_batch.inner_dt[i] != HUGE_VAL))
+	  {
+	    dt = _batch.inner_dt[i];
+	    type = STEP_IN;
+	  }
+
+	if (!std::isinf(_batch.outer_d[i]) && (dt > _batch.outer_dt[i]))
+	  {
+	    dt = _batch.outer_dt[i];
+	    type = STEP_OUT;
+	  }
+
+	if (type != NONE)
+	  events.push_back(IntEvent(p1, Sim->particles[_batch.IDs[i]], dt, type, *this));
+      }
+  }
+
   void
   IStepped::runEvent(Particle& p1, Particle& p2, const IntEvent& iEvent)
   {
@@ -197,8 +239,28 @@ namespace dynamo {
     if (retVal.getType() != BOUNCE) ICapture::operator[](ICapture::key_type(p1, p2)) = new_step_ID;
     Sim->_sigParticleUpdate(retVal);
     Sim->ptrScheduler->fullUpdate(p1, p2);
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, retVal);
+    Sim->outputPluginBus.eventUpdate(iEvent, retVal);
+  }
+
+  void
+  IStepped::replayEvent(const Particle& p1, const Particle& p2, EEventType eType, EEventType resultType)
+  {
+    if (resultType == BOUNCE) return;
+
+    ICapture::const_iterator capstat = ICapture::find(ICapture::key_type(p1, p2));
+    const size_t old_step_ID = (capstat == ICapture::end()) ? 0 : capstat->second;
+
+    switch (eType)
+      {
+      case STEP_OUT:
+	ICapture::operator[](ICapture::key_type(p1, p2)) = _potential->outer_step_ID(old_step_ID);
+	break;
+      case STEP_IN:
+	ICapture::operator[](ICapture::key_type(p1, p2)) = _potential->inner_step_ID(old_step_ID);
+	break;
+      default:
+	M_throw() << "Unknown event type";
+      }
   }
 
   bool
@@ -358,7 +420,7 @@ namespace dynamo {
 	      }
 	    else
 	      {
-		for (EEventType etype: {EEventType:STEP_OUT, EEventType:BOUNCE, EEventType:STEP_IN})
+		for (EEventType etype: {EEventType::STEP_OUT, EEventType::BOUNCE, EEventType::STEP_IN})
 		  for (const auto& data: _edgedata)
 		    if ((data.first.first == potential_step) && (data.first.second == etype))
 		      {
@@ -19,6 +19,7 @@
 
 #include <dynamo/interactions/captures.hpp>
 #include <dynamo/interactions/glyphrepresentation.hpp>
+#include <dynamo/dynamics/pairbatch.hpp>
 #include <dynamo/interactions/potentials/potential.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/eventtypes.hpp>
@@ -53,8 +54,12 @@ namespace dynamo {
     virtual void initialise(size_t);
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle&, const std::vector<size_t>&, std::vector<IntEvent>&) const;
   
     virtual void runEvent(Particle&, Particle&, const IntEvent&);
+
+    virtual void replayEvent(const Particle&, const Particle&, EEventType, EEventType);
   
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
@@ -66,6 +71,14 @@ namespace dynamo {
 
     virtual void outputData(magnet::xml::XmlStream&) const;
 
+    const shared_ptr<Potential>& getPotential() const { return _potential; }
+
+    /*! \brief Replace the Potential of this Interaction with an
+        identical one (e.g., a Potential shared between several
+        Simulations).
+     */
+    void setPotential(const shared_ptr<Potential>& potential) { _potential = potential; }
+
   protected:
     //!This class is used to track how the length scale changes in the system
     shared_ptr<Property> _lengthScale;
@@ -80,5 +93,7 @@ namespace dynamo {
       double rdotv_sum;
     };
     std::map<std::pair<size_t, EEventType>, EdgeData> _edgedata;
+
+    mutable PairBatch _batch;
   };
 }
@@ -285,8 +285,7 @@ namespace dynamo {
 	
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 
 	  break;
 	}
@@ -296,8 +295,7 @@ namespace dynamo {
 	  if (retVal.getType() != BOUNCE) ICapture::add(p1, p2);      
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 
 	  break;
 	}
@@ -307,8 +305,7 @@ namespace dynamo {
 	  if (retVal.getType() != BOUNCE) ICapture::remove(p1, p2);
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 	  break;
 	}
       default:
@@ -316,6 +313,24 @@ namespace dynamo {
       }
   }
 
+  void
+  ISWSequence::replayEvent(const Particle& p1, const Particle& p2, EEventType eType, EEventType resultType)
+  {
+    if (resultType == BOUNCE) return;
+
+    switch (eType)
+      {
+      case STEP_IN:
+	ICapture::add(p1, p2);
+	break;
+      case STEP_OUT:
+	ICapture::remove(p1, p2);
+	break;
+      default:
+	break;
+      }
+  }
+
   bool
   ISWSequence::validateState(const Particle& p1, const Particle& p2, bool textoutput) const
   {
@@ -76,6 +76,8 @@ namespace dynamo {
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
   
     virtual void runEvent(Particle&, Particle&, const IntEvent&);
+
+    virtual void replayEvent(const Particle&, const Particle&, EEventType, EEventType);
   
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
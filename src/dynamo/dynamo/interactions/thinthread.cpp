@@ -136,8 +136,7 @@ namespace dynamo {
 	  
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(event, retVal);
+	  Sim->outputPluginBus.eventUpdate(event, retVal);
 	  break;
 	}
       case STEP_OUT:
@@ -146,8 +145,7 @@ namespace dynamo {
 	  if (retVal.getType() != BOUNCE) ICapture::remove(p1, p2);
 	  Sim->_sigParticleUpdate(retVal);
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
-	  for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-	    Ptr->eventUpdate(iEvent, retVal);
+	  Sim->outputPluginBus.eventUpdate(iEvent, retVal);
 	  break;
 	}
       default:
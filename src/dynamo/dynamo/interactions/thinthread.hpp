@@ -34,6 +34,9 @@ namespace dynamo {
     virtual size_t captureTest(const Particle&, const Particle&) const { return false; }
 
     virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+    virtual void getEvents(const Particle& p1, const std::vector<size_t>& ids, std::vector<IntEvent>& events) const
+    { Interaction::getEvents(p1, ids, events); }
   
     virtual void runEvent(Particle&, Particle&, const IntEvent&);
   
@@ -93,8 +93,7 @@ namespace dynamo {
     //else
     Sim->ptrScheduler->rebuildList();
 
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent, EDat);
   }
 
   void 
@@ -18,18 +18,150 @@
 #include <dynamo/locals/trianglemesh.hpp>
 #include <dynamo/BC/BC.hpp>
 #include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/dynamics/multicanonical.hpp>
+#include <dynamo/dynamics/multicanonical_contactmap.hpp>
 #include <dynamo/locals/localEvent.hpp>
 #include <dynamo/NparticleEventData.hpp>
 #include <dynamo/units/units.hpp>
 #include <dynamo/schedulers/scheduler.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
-
+#include <dynamo/BC/LEBC.hpp>
+#include <algorithm>
+#include <typeinfo>
 
 namespace dynamo {
   LTriangleMesh::LTriangleMesh(const magnet::xml::Node& XML, dynamo::Simulation* tmp):
     Local(tmp, "LocalWall")
   { operator<<(XML); }
 
+  namespace {
+    /*! \brief The time when a ray enters an axis aligned box.
+      
+      \return Zero if the ray starts inside the box, or HUGE_VAL if it
+      never enters the box.
+     */
+    inline double rayBoxEntry(const Vector& origin, const Vector& vel, 
+			      const Vector& min, const Vector& max)
+    {
+      double tin = 0, tout = HUGE_VAL;
+      for (size_t i(0); i < NDIM; ++i)
+	if (vel[i] == 0)
+	  {
+	    if ((origin[i] < min[i]) || (origin[i] > max[i]))
+	      return HUGE_VAL;
+	  }
+	else
+	  {
+	    double t1 = (min[i] - origin[i]) / vel[i];
+	    double t2 = (max[i] - origin[i]) / vel[i];
+	    if (t1 > t2) std::swap(t1, t2);
+	    tin = std::max(tin, t1);
+	    tout = std::min(tout, t2);
+	    if (tin > tout) return HUGE_VAL;
+	  }
+
+      return tin;
+    }
+  }
+
+  void
+  LTriangleMesh::initialise(size_t nID)
+  {
+    Local::initialise(nID);
+    buildBVH();
+  }
+
+  void
+  LTriangleMesh::buildBVH()
+  {
+    _bvh.clear();
+    _bvhTriangles.resize(_elements.size());
+    for (size_t id(0); id < _elements.size(); ++id)
+      _bvhTriangles[id] = id;
+
+    if (_elements.empty()) return;
+
+    _bvh.reserve(2 * _elements.size() / 4 + 1);
+    buildBVHNode(0, _elements.size());
+  }
+
+  void
+  LTriangleMesh::buildBVHNode(size_t begin, size_t end)
+  {
+    //The number of triangles in each leaf of the tree
+    static const size_t leafSize = 4;
+
+    const size_t nodeID = _bvh.size();
+    _bvh.push_back(BVHNode());
+
+    //Find the bounds of the triangles and of their centroids
+    Vector min(HUGE_VAL, HUGE_VAL, HUGE_VAL), max(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+    Vector cmin = min, cmax = max;
+    for (size_t i(begin); i < end; ++i)
+      {
+	const TriangleElements& elem = _elements[_bvhTriangles[i]];
+	const Vector centroid = (_vertices[std::get<0>(elem)] + _vertices[std::get<1>(elem)] + _vertices[std::get<2>(elem)]) / 3;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    for (const size_t vertex : {std::get<0>(elem), std::get<1>(elem), std::get<2>(elem)})
+	      {
+		min[iDim] = std::min(min[iDim], _vertices[vertex][iDim]);
+		max[iDim] = std::max(max[iDim], _vertices[vertex][iDim]);
+	      }
+	    cmin[iDim] = std::min(cmin[iDim], centroid[iDim]);
+	    cmax[iDim] = std::max(cmax[iDim], centroid[iDim]);
+	  }
+      }
+
+    _bvh[nodeID].min = min;
+    _bvh[nodeID].max = max;
+
+    if (end - begin <= leafSize)
+      {
+	_bvh[nodeID].first = begin;
+	_bvh[nodeID].count = end - begin;
+	return;
+      }
+
+    //Split the triangles at the median centroid along the widest axis
+    size_t axis = 0;
+    for (size_t iDim(1); iDim < NDIM; ++iDim)
+      if ((cmax[iDim] - cmin[iDim]) > (cmax[axis] - cmin[axis]))
+	axis = iDim;
+
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(_bvhTriangles.begin() + begin, _bvhTriangles.begin() + mid, _bvhTriangles.begin() + end,
+		     [&](const size_t a, const size_t b)
+		     {
+		       const TriangleElements& ea = _elements[a];
+		       const TriangleElements& eb = _elements[b];
+		       return (_vertices[std::get<0>(ea)][axis] + _vertices[std::get<1>(ea)][axis] + _vertices[std::get<2>(ea)][axis])
+			 < (_vertices[std::get<0>(eb)][axis] + _vertices[std::get<1>(eb)][axis] + _vertices[std::get<2>(eb)][axis]);
+		     });
+
+    buildBVHNode(begin, mid);
+    _bvh[nodeID].first = _bvh.size();
+    _bvh[nodeID].count = 0;
+    buildBVHNode(mid, end);
+  }
+
+  void
+  LTriangleMesh::testTriangle(const Particle& part, double radius, size_t id, 
+			      std::pair<double, size_t>& tmin, size_t& triangleid) const
+  {
+    std::pair<double, size_t> t 
+      = Sim->dynamics->getSphereTriangleEvent(part,
+					      _vertices[std::get<0>(_elements[id])],
+					      _vertices[std::get<1>(_elements[id])],
+					      _vertices[std::get<2>(_elements[id])],
+					      radius);
+
+    //Ties are given to the lowest triangle ID, so the event does not
+    //depend on the order the triangles are tested in
+    if ((t < tmin) || ((t == tmin) && (id < triangleid))) 
+      { tmin = t; triangleid = id; }
+  }
+
   LocalEvent 
   LTriangleMesh::getEvent(const Particle& part) const
   {
@@ -43,17 +175,96 @@ namespace dynamo {
 
     std::pair<double, size_t> tmin(HUGE_VAL, 0); //Default to no collision
 
-    for (size_t id(0); id < _elements.size(); ++id)
+    //The BVH assumes the particles travel in straight lines and the
+    //boundary conditions only translate them. The Dynamics type must
+    //match exactly, as derived classes (e.g., DynGravity) may
+    //follow curved paths. The multicanonical Dynamics only change
+    //how the events are run.
+    const std::type_info& dynamics = typeid(*Sim->dynamics);
+    const bool straightPaths = (dynamics == typeid(DynNewtonian))
+      || (dynamics == typeid(DynNewtonianMC))
+      || (dynamics == typeid(DynNewtonianMCCMap));
+
+    if (_bvh.empty() || !straightPaths || std::dynamic_pointer_cast<BCLeesEdwards>(Sim->BCs))
       {
-	std::pair<double, size_t> t 
-	  = Sim->dynamics->getSphereTriangleEvent(part,
-						  _vertices[std::get<0>(_elements[id])],
-						  _vertices[std::get<1>(_elements[id])],
-						  _vertices[std::get<2>(_elements[id])],
-						  diam);
-	if (t < tmin) { tmin = t; triangleid = id; }
+	for (size_t id(0); id < _elements.size(); ++id)
+	  testTriangle(part, diam, id, tmin, triangleid);
+
+	return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
       }
 
+    //Each triangle is tested against the periodic image of the
+    //particle which is nearest to its first vertex. The range of
+    //these images over the bounds of the mesh is found, and the tree
+    //is searched once for each image.
+    const Vector& pos = part.getPosition();
+    Vector shiftLow = pos - _bvh[0].min;
+    Sim->BCs->applyBC(shiftLow);
+    shiftLow -= pos - _bvh[0].min;
+
+    Vector shiftHigh = pos - _bvh[0].max;
+    Sim->BCs->applyBC(shiftHigh);
+    shiftHigh -= pos - _bvh[0].max;
+
+    size_t images[NDIM];
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      images[iDim] = (shiftHigh[iDim] == shiftLow[iDim]) ? 1 
+	: 1 + lrint((shiftHigh[iDim] - shiftLow[iDim]) / Sim->primaryCellSize[iDim]);
+
+    //The boxes are enlarged by the particle radius, and a little
+    //more for the rounding errors of the event tests.
+    const double pad = diam * (1 + 1e-10) + 1e-10 * (_bvh[0].max - _bvh[0].min).nrm();
+
+    const Vector padding(pad, pad, pad);
+
+    //The nodes still to visit, with the time the particle enters
+    //them. The depth of the tree is logarithmic in the triangle
+    //count.
+    std::pair<size_t, double> stack[128];
+
+    for (size_t ix(0); ix < images[0]; ++ix)
+      for (size_t iy(0); iy < images[1]; ++iy)
+	for (size_t iz(0); iz < images[2]; ++iz)
+	  {
+	    Vector origin = pos + shiftLow;
+	    origin[0] += ix * Sim->primaryCellSize[0];
+	    origin[1] += iy * Sim->primaryCellSize[1];
+	    origin[2] += iz * Sim->primaryCellSize[2];
+
+	    const double rootEntry = rayBoxEntry(origin, part.getVelocity(), _bvh[0].min - padding, _bvh[0].max + padding);
+	    if (rootEntry == HUGE_VAL) continue;
+
+	    size_t depth = 0;
+	    stack[depth++] = std::make_pair(0, rootEntry);
+	    while (depth)
+	      {
+		--depth;
+		//Skip nodes entered after the earliest event found so far
+		if (stack[depth].second > tmin.first) continue;
+
+		const size_t nodeID = stack[depth].first;
+		const BVHNode& node = _bvh[nodeID];
+		if (node.count)
+		  {
+		    for (size_t i(node.first); i < node.first + node.count; ++i)
+		      testTriangle(part, diam, _bvhTriangles[i], tmin, triangleid);
+		    continue;
+		  }
+
+		//Push the nearest child last, so it is visited first and
+		//the other child is more likely to be culled
+		std::pair<size_t, double> nearChild(nodeID + 1, rayBoxEntry(origin, part.getVelocity(), _bvh[nodeID + 1].min - padding, _bvh[nodeID + 1].max + padding));
+		std::pair<size_t, double> farChild(node.first, rayBoxEntry(origin, part.getVelocity(), _bvh[node.first].min - padding, _bvh[node.first].max + padding));
+		if (farChild.second < nearChild.second) std::swap(nearChild, farChild);
+
+		//Boxes the particle never enters have an entry time of
+		//HUGE_VAL, which must be tested for separately as tmin
+		//is also HUGE_VAL until an event is found
+		if ((farChild.second != HUGE_VAL) && (farChild.second <= tmin.first)) stack[depth++] = farChild;
+		if ((nearChild.second != HUGE_VAL) && (nearChild.second <= tmin.first)) stack[depth++] = nearChild;
+	      }
+	  }
+
     return LocalEvent(part, tmin.first, WALL, *this, 8 * triangleid + tmin.second);
   }
 
@@ -146,8 +357,7 @@ namespace dynamo {
     //Now we're past the event update the scheduler and plugins
     Sim->ptrScheduler->fullUpdate(part);
   
-    for (shared_ptr<OutputPlugin> & Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(iEvent, EDat);
+    Sim->outputPluginBus.eventUpdate(iEvent, EDat);
   }
 
   void 
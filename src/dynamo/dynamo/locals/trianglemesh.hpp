@@ -27,6 +27,23 @@
 #endif
 
 namespace dynamo {
+  /*! \brief A wall made of a mesh of triangles.
+
+    Each particle only tests the triangles which it could reach,
+    using a bounding volume hierarchy (BVH) of the triangles. The
+    hierarchy is a binary tree of axis aligned boxes, where each box
+    bounds the triangles below it. A particle's path is traced
+    through the tree, nearest boxes first, and any box which the
+    particle does not enter before the earliest event found so far is
+    skipped. This makes the cost of an event prediction roughly
+    logarithmic in the number of triangles, so meshes may be much
+    larger than the number of particles.
+
+    The path is traced as a straight line, so the BVH is only used
+    with Newtonian dynamics. Other Dynamics (e.g., gravity, where the
+    paths are parabolas) and sheared boundary conditions test every
+    triangle.
+   */
   class LTriangleMesh: public Local, public CoilRenderObj
   {
   public:
@@ -45,6 +62,8 @@ namespace dynamo {
 
     virtual LocalEvent getEvent(const Particle&) const;
 
+    virtual void initialise(size_t);
+
     virtual void runEvent(Particle&, const LocalEvent&) const;
   
     virtual void operator<<(const magnet::xml::Node&);
@@ -68,6 +87,34 @@ namespace dynamo {
     typedef std::tuple<size_t, size_t, size_t> TriangleElements;
     std::vector<TriangleElements> _elements;
 
+    /*! \brief A node of the bounding volume hierarchy.
+
+      The left child of an internal node directly follows it in the
+      _bvh container, and the right child is at the index stored in
+      first. Leaf nodes instead hold count triangles, which start at
+      first in the _bvhTriangles container.
+     */
+    struct BVHNode
+    {
+      Vector min;
+      Vector max;
+      size_t first;
+      size_t count;
+    };
+
+    std::vector<BVHNode> _bvh;
+    std::vector<size_t> _bvhTriangles;
+
+    //! \brief Build the BVH over the triangles of the mesh.
+    void buildBVH();
+
+    //! \brief Build the BVH node for a range of the _bvhTriangles.
+    void buildBVHNode(size_t begin, size_t end);
+
+    //! \brief Test a triangle for an event, keeping the earliest event.
+    void testTriangle(const Particle& part, double radius, size_t id,
+		      std::pair<double, size_t>& tmin, size_t& triangleid) const;
+
     shared_ptr<Property> _e;
     shared_ptr<Property> _diameter;
   };
@@ -0,0 +1,296 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/globals/globEvent.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <dynamo/systems/system.hpp>
+#include <dynamo/species/species.hpp>
+#include <dynamo/interactions/captures.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/simulation.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <cstring>
+
+namespace dynamo {
+  static_assert(sizeof(BinaryTrajectoryHeader) == 64, "The binary trajectory header has an unexpected layout");
+  static_assert(sizeof(BinaryTrajectoryRecord) == 80, "The binary trajectory record has an unexpected layout");
+  static_assert(sizeof(BinaryCheckpointHeader) == 64, "The binary checkpoint header has an unexpected layout");
+
+  OPBinaryTrajectory::OPBinaryTrajectory(const dynamo::Simulation* t1, const magnet::xml::Node& XML):
+    OutputPlugin(t1, "BinaryTrajectory"),
+    _filename("trajectory.bin"),
+    _bufferSize(65536),
+    _recordCount(0),
+    _sequence(0),
+    _checkpointInterval(0),
+    _nextCheckpoint(0)
+  { operator<<(XML); }
+
+  OPBinaryTrajectory::~OPBinaryTrajectory()
+  {
+    try { flush(); } catch (...) {}
+  }
+
+  void
+  OPBinaryTrajectory::operator<<(const magnet::xml::Node& XML)
+  {
+    if (XML.hasAttribute("FileName"))
+      _filename = XML.getAttribute("FileName").as<std::string>();
+
+    if (XML.hasAttribute("BufferSize"))
+      _bufferSize = XML.getAttribute("BufferSize").as<size_t>();
+
+    if (XML.hasAttribute("CheckpointInterval"))
+      _checkpointInterval = XML.getAttribute("CheckpointInterval").as<size_t>();
+
+    if (_bufferSize == 0)
+      M_throw() << "BufferSize must be greater than zero";
+  }
+
+  void
+  OPBinaryTrajectory::initialise()
+  {
+    namespace io = boost::iostreams;
+
+    _file.reset();
+    _buffer.clear();
+    _buffer.reserve(_bufferSize);
+    _recordCount = 0;
+    _sequence = 0;
+    _nextCheckpoint = Sim->eventCount + _checkpointInterval;
+
+    if ((_filename.size() > 4) && (std::string(_filename.end() - 4, _filename.end()) == ".bz2"))
+      _file.push(io::bzip2_compressor());
+    else if ((_filename.size() > 3) && (std::string(_filename.end() - 3, _filename.end()) == ".gz"))
+      _file.push(io::gzip_compressor());
+
+    _file.push(io::file_sink(_filename, std::ios::out | std::ios::trunc | std::ios::binary));
+
+    BinaryTrajectoryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "DYNAMOTR", 8);
+    header.version = BinaryTrajectoryHeader::currentVersion;
+    header.dimensions = NDIM;
+    header.recordSize = sizeof(BinaryTrajectoryRecord);
+    header.N = Sim->N;
+    header.startTime = Sim->systemTime / Sim->units.unitTime();
+    header.startEventCount = Sim->eventCount;
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    dout << "Writing a binary trajectory to " << _filename << std::endl;
+  }
+
+  void
+  OPBinaryTrajectory::flush()
+  {
+    if (_file.empty()) return;
+
+    if (!_buffer.empty())
+      _file.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size() * sizeof(BinaryTrajectoryRecord));
+    _buffer.clear();
+    _file.flush();
+  }
+
+  void
+  OPBinaryTrajectory::checkpoint()
+  {
+    _nextCheckpoint = Sim->eventCount + _checkpointInterval;
+
+    std::string basename = _filename;
+    if ((basename.size() > 4) && (std::string(basename.end() - 4, basename.end()) == ".bz2"))
+      basename.erase(basename.size() - 4);
+    else if ((basename.size() > 3) && (std::string(basename.end() - 3, basename.end()) == ".gz"))
+      basename.erase(basename.size() - 3);
+
+    const std::string filename = basename + "." + boost::lexical_cast<std::string>(Sim->eventCount) + ".chk";
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file)
+      M_throw() << "Failed to open the checkpoint file " << filename;
+
+    BinaryCheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "DYNAMOCP", 8);
+    header.version = BinaryCheckpointHeader::currentVersion;
+    header.dimensions = NDIM;
+    header.N = Sim->N;
+    header.interactions = Sim->interactions.size();
+    header.eventCount = Sim->eventCount;
+    header.recordCount = _recordCount;
+    header.time = Sim->systemTime / Sim->units.unitTime();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    //The particles are streamed as copies so that the delayed
+    //states, and hence the trajectory, of the simulation are not
+    //perturbed by taking a checkpoint.
+    std::vector<double> data;
+    data.reserve(2 * NDIM * Sim->N);
+    for (const Particle& part : Sim->particles)
+      {
+	Particle copy(part);
+	Sim->dynamics->updateParticle(copy);
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  data.push_back(copy.getPosition()[iDim]);
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  data.push_back(copy.getVelocity()[iDim]);
+      }
+    file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+
+    std::vector<uint32_t> states;
+    states.reserve(Sim->N);
+    for (const Particle& part : Sim->particles)
+      states.push_back(part.getStates());
+    file.write(reinterpret_cast<const char*>(states.data()), states.size() * sizeof(uint32_t));
+
+    for (const shared_ptr<Interaction>& interaction : Sim->interactions)
+      {
+	std::vector<uint64_t> entries;
+	const ICapture* capture = dynamic_cast<const ICapture*>(interaction.get());
+	if (capture)
+	  for (const detail::CaptureMap::value_type& entry : *capture)
+	    {
+	      entries.push_back(entry.first.first);
+	      entries.push_back(entry.first.second);
+	      entries.push_back(entry.second);
+	    }
+	
+	const uint64_t count = entries.size() / 3;
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+	file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(uint64_t));
+      }
+
+    if (!file)
+      M_throw() << "Failed to write the checkpoint file " << filename;
+  }
+
+  BinaryTrajectoryRecord&
+  OPBinaryTrajectory::newRecord(EEventType eventClass, EEventType eventType, EEventType resultType, uint32_t sourceID)
+  {
+    if (_buffer.size() == _bufferSize)
+      {
+	_file.write(reinterpret_cast<const char*>(_buffer.data()), _buffer.size() * sizeof(BinaryTrajectoryRecord));
+	_buffer.clear();
+      }
+
+    ++_recordCount;
+    _buffer.push_back(BinaryTrajectoryRecord());
+    BinaryTrajectoryRecord& record = _buffer.back();
+    record.eventCount = Sim->eventCount;
+    record.sequence = _sequence;
+    record.time = Sim->systemTime / Sim->units.unitTime();
+    record.p1 = BinaryTrajectoryRecord::noParticle;
+    record.p2 = BinaryTrajectoryRecord::noParticle;
+    record.eventClass = eventClass;
+    record.eventType = eventType;
+    record.resultType = resultType;
+    record.sourceID = sourceID;
+    record.deltaU = 0;
+    record.state1 = 0;
+    record.state2 = 0;
+    return record;
+  }
+
+  void
+  OPBinaryTrajectory::addPairRecord(const PairEventData& pData, EEventType eventClass, EEventType eventType, uint32_t sourceID)
+  {
+    BinaryTrajectoryRecord& record = newRecord(eventClass, eventType, pData.getType(), sourceID);
+    record.p1 = pData.particle1_.getParticleID();
+    record.p2 = pData.particle2_.getParticleID();
+    record.state1 = Sim->particles[record.p1].getStates();
+    record.state2 = Sim->particles[record.p2].getStates();
+    //The impulse is removed from particle 1 and added to particle 2
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      record.deltaP[iDim] = - pData.impulse[iDim] / Sim->units.unitMomentum();
+    record.deltaU = (pData.particle1_.getDeltaU() + pData.particle2_.getDeltaU()) / Sim->units.unitEnergy();
+  }
+
+  void
+  OPBinaryTrajectory::addRecords(const NEventData& SDat, EEventType eventClass, EEventType eventType, uint32_t sourceID)
+  {
+    for (const ParticleEventData& pData : SDat.L1partChanges)
+      {
+	const Particle& part = Sim->particles[pData.getParticleID()];
+	const Vector delP = Sim->species.getMass(part) * (part.getVelocity() - pData.getOldVel()) / Sim->units.unitMomentum();
+
+	BinaryTrajectoryRecord& record = newRecord(eventClass, eventType, pData.getType(), sourceID);
+	record.p1 = part.getID();
+	record.state1 = part.getStates();
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  record.deltaP[iDim] = delP[iDim];
+	record.deltaU = pData.getDeltaU() / Sim->units.unitEnergy();
+      }
+
+    for (const PairEventData& pData : SDat.L2partChanges)
+      addPairRecord(pData, eventClass, eventType, sourceID);
+
+    //Events which do not change any particles (e.g., ticker events)
+    //still get a record to mark their time.
+    if (SDat.L1partChanges.empty() && SDat.L2partChanges.empty())
+      {
+	BinaryTrajectoryRecord& record = newRecord(eventClass, eventType, eventType, sourceID);
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  record.deltaP[iDim] = 0;
+      }
+
+    ++_sequence;
+
+    if (_checkpointInterval && (Sim->eventCount >= _nextCheckpoint))
+      checkpoint();
+  }
+
+  void
+  OPBinaryTrajectory::eventUpdate(const IntEvent& eevent, const PairEventData& pdat)
+  {
+    addPairRecord(pdat, INTERACTION, eevent.getType(), eevent.getInteractionID());
+    ++_sequence;
+
+    if (_checkpointInterval && (Sim->eventCount >= _nextCheckpoint))
+      checkpoint();
+  }
+
+  void
+  OPBinaryTrajectory::eventUpdate(const GlobalEvent& eevent, const NEventData& SDat)
+  { addRecords(SDat, GLOBAL, eevent.getType(), eevent.getGlobalID()); }
+
+  void
+  OPBinaryTrajectory::eventUpdate(const LocalEvent& eevent, const NEventData& SDat)
+  { addRecords(SDat, LOCAL, eevent.getType(), eevent.getLocalID()); }
+
+  void
+  OPBinaryTrajectory::eventUpdate(const System& sys, const NEventData& SDat, const double&)
+  { addRecords(SDat, SYSTEM, sys.getType(), sys.getID()); }
+
+  void
+  OPBinaryTrajectory::output(magnet::xml::XmlStream& XML)
+  {
+    flush();
+
+    XML << magnet::xml::tag("BinaryTrajectory")
+	<< magnet::xml::attr("FileName") << _filename
+	<< magnet::xml::attr("Records") << _recordCount
+	<< magnet::xml::endtag("BinaryTrajectory");
+  }
+}
@@ -0,0 +1,202 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/eventtypes.hpp>
+#include <magnet/math/vector.hpp>
+#include <magnet/memUsage.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <cstdint>
+#include <vector>
+#include <string>
+
+namespace dynamo {
+  /*! \brief The header at the start of every binary trajectory file.
+
+    The file is a BinaryTrajectoryHeader followed by a stream of
+    BinaryTrajectoryRecord entries. All values are written in the
+    native byte order of the machine which ran the simulation.
+   */
+  struct BinaryTrajectoryHeader
+  {
+    //! The magic string "DYNAMOTR" identifying the file type.
+    char magic[8];
+    //! The version of the record format.
+    uint32_t version;
+    //! The dimensionality of the simulation.
+    uint32_t dimensions;
+    //! The size of each record in bytes, to check the layout.
+    uint32_t recordSize;
+    //! The number of particles in the simulation.
+    uint32_t N;
+    //! The simulation time when the trajectory started.
+    double startTime;
+    //! The event count when the trajectory started.
+    uint64_t startEventCount;
+    uint64_t _padding[3];
+
+    static const uint32_t currentVersion = 3;
+  };
+
+  /*! \brief A single, fixed width, record of a binary trajectory.
+
+    Every particle change of an event generates one record, so events
+    which affect several particles (e.g., System events) are stored
+    as several consecutive records sharing the same sequence
+    number. Some events (e.g., sleep or sentinel events) do not
+    increment Simulation::eventCount, so the eventCount alone cannot
+    separate the events. All quantities are in the reduced units of
+    the simulation output.
+   */
+  struct BinaryTrajectoryRecord
+  {
+    //! The value of Simulation::eventCount after the event.
+    uint64_t eventCount;
+    //! The number of the event in the trajectory, counting from zero.
+    uint64_t sequence;
+    //! The simulation time of the event.
+    double time;
+    //! The particle affected by the event.
+    uint32_t p1;
+    //! The partner particle of a pair change, or noParticle.
+    uint32_t p2;
+    //! The class of the event (INTERACTION, GLOBAL, LOCAL or SYSTEM).
+    uint8_t eventClass;
+    //! The EEventType of the event.
+    uint8_t eventType;
+    //! The EEventType of the particle change (e.g., BOUNCE for a failed well event).
+    uint16_t resultType;
+    //! The ID of the Interaction, Global, Local or System which ran the event.
+    uint32_t sourceID;
+    //! The change in momentum of particle p1 (p2 receives the opposite).
+    double deltaP[NDIM];
+    //! The change in the internal energy due to this change.
+    double deltaU;
+    //! The Particle::getStates() flags of particle p1 after the event.
+    uint32_t state1;
+    //! The Particle::getStates() flags of particle p2 after the event.
+    uint32_t state2;
+
+    static const uint32_t noParticle = 0xFFFFFFFF;
+  };
+
+  /*! \brief The header of a binary checkpoint written by
+    OPBinaryTrajectory.
+
+    A checkpoint is the exact state of the particles after a certain
+    number of trajectory records have been written, which allows the
+    EReplay engine to start replaying a trajectory part way
+    through. The header is followed by N pairs of position and
+    velocity vectors and N uint32_t Particle::getStates() flags,
+    then, for every Interaction, a uint64_t count
+    of capture map entries followed by that many (ID1, ID2, value)
+    uint64_t triplets. Unlike the trajectory records, the particle
+    data is stored in simulation units, so a checkpoint may only be
+    used with the configuration that generated it.
+   */
+  struct BinaryCheckpointHeader
+  {
+    //! The magic string "DYNAMOCP" identifying the file type.
+    char magic[8];
+    //! The version of the checkpoint format.
+    uint32_t version;
+    //! The dimensionality of the simulation.
+    uint32_t dimensions;
+    //! The number of particles in the simulation.
+    uint32_t N;
+    //! The number of Interaction capture maps which follow the particle data.
+    uint32_t interactions;
+    //! The value of Simulation::eventCount at the checkpoint.
+    uint64_t eventCount;
+    //! The number of trajectory records written before the checkpoint.
+    uint64_t recordCount;
+    //! The simulation time of the checkpoint (in reduced units).
+    double time;
+    uint64_t _padding[2];
+
+    static const uint32_t currentVersion = 2;
+  };
+
+  /*! \brief An OutputPlugin which writes a compact binary stream of
+    every event executed.
+
+    This is a replacement for OPTrajectory for production runs. Each
+    particle change is stored as a fixed width
+    BinaryTrajectoryRecord, which are collected in a buffer and
+    written out in large blocks. If the file name ends in ".bz2" or
+    ".gz" the stream is compressed on the fly. The dynatraj program
+    converts these files back into text.
+
+    Options are:
+    - FileName: The file to write to (default "trajectory.bin").
+    - BufferSize: The number of records to buffer before writing
+      (default 65536).
+    - CheckpointInterval: If non-zero, a BinaryCheckpointHeader
+      checkpoint is written every time this many events have
+      passed. Checkpoints are named after the trajectory with the
+      event count and ".chk" appended (e.g.,
+      "trajectory.bin.100000.chk") and allow the EReplay engine to
+      start from part way through the trajectory (default 0).
+   */
+  class OPBinaryTrajectory: public OutputPlugin
+  {
+  public:
+    OPBinaryTrajectory(const dynamo::Simulation*, const magnet::xml::Node&);
+
+    ~OPBinaryTrajectory();
+
+    virtual void eventUpdate(const IntEvent&, const PairEventData&);
+
+    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
+
+    virtual void eventUpdate(const LocalEvent&, const NEventData&);
+
+    virtual void eventUpdate(const System&, const NEventData&, const double&);
+
+    virtual void replicaExchange(OutputPlugin&)
+    { M_throw() << "This output plugin hasn't been prepared for changes of system"; }
+
+    virtual void initialise();
+
+    virtual void output(magnet::xml::XmlStream&);
+
+    virtual size_t getMemoryUsage() const { return magnet::container_mem_usage(_buffer); }
+
+    void operator<<(const magnet::xml::Node&);
+
+  private:
+    void addRecords(const NEventData&, EEventType eventClass, EEventType eventType, uint32_t sourceID);
+
+    void addPairRecord(const PairEventData&, EEventType eventClass, EEventType eventType, uint32_t sourceID);
+
+    BinaryTrajectoryRecord& newRecord(EEventType eventClass, EEventType eventType, EEventType resultType, uint32_t sourceID);
+
+    void flush();
+
+    void checkpoint();
+
+    std::string _filename;
+    std::vector<BinaryTrajectoryRecord> _buffer;
+    size_t _bufferSize;
+    uint64_t _recordCount;
+    uint64_t _sequence;
+    size_t _checkpointInterval;
+    size_t _nextCheckpoint;
+    boost::iostreams::filtering_ostream _file;
+  };
+}
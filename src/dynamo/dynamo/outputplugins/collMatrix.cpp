@@ -16,6 +16,7 @@
 */
 
 #include <dynamo/outputplugins/collMatrix.hpp>
+#include <dynamo/outputplugins/eventrecord.hpp>
 #include <dynamo/simulation.hpp>
 #include <dynamo/include.hpp>
 #include <dynamo/interactions/include.hpp>
@@ -38,82 +39,33 @@ namespace dynamo {
   {}
 
   void 
-  OPCollMatrix::eventUpdate(const IntEvent& iEvent, const PairEventData&)
+  OPCollMatrix::eventUpdate(const EventRecord& record)
   {
-    newEvent(iEvent.getParticle1ID(), iEvent.getType(), 
-	     getClassKey(iEvent));
-
-    newEvent(iEvent.getParticle2ID(), iEvent.getType(), 
-	     getClassKey(iEvent));
-  }
-
-
-  void 
-  OPCollMatrix::eventUpdate(const GlobalEvent& globEvent, const NEventData& SDat)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), pData.getType(), 
-	       getClassKey(globEvent));  
+    for (const EventRecord::ParticleChange& pData : record._particles)
+      newEvent(pData._ID, pData._type, record._source, record._systemTime);
   
-    for (const PairEventData& pData : SDat.L2partChanges)
+    for (const EventRecord::PairChange& pData : record._pairs)
       {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(globEvent));
-
-	newEvent(pData.particle2_.getParticleID(), 
-		 pData.getType(), getClassKey(globEvent));
+	newEvent(pData._particle1._ID, pData._type, record._source, record._systemTime);
+	newEvent(pData._particle2._ID, pData._type, record._source, record._systemTime);
       }
   }
 
   void 
-  OPCollMatrix::eventUpdate(const LocalEvent& localEvent, const NEventData& SDat)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), 
-	       pData.getType(), getClassKey(localEvent));  
-  
-    for (const PairEventData& pData : SDat.L2partChanges)
-      {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(localEvent));
-
-	newEvent(pData.particle2_.getParticleID(),
-		 pData.getType(), getClassKey(localEvent));
-      }
-  }
-
-  void 
-  OPCollMatrix::eventUpdate(const System& sysEvent, const NEventData& SDat, const double&)
-  {
-    for (const ParticleEventData& pData : SDat.L1partChanges)
-      newEvent(pData.getParticleID(), pData.getType(), getClassKey(sysEvent));
-  
-    for (const PairEventData& pData : SDat.L2partChanges)
-      {
-	newEvent(pData.particle1_.getParticleID(), 
-		 pData.getType(), getClassKey(sysEvent));
-
-	newEvent(pData.particle2_.getParticleID(), 
-		 pData.getType(), getClassKey(sysEvent));  
-      } 
-  }
-
-
-  void 
-  OPCollMatrix::newEvent(const size_t& part, const EEventType& etype, const classKey& ck)
+  OPCollMatrix::newEvent(const size_t& part, const EEventType& etype, const classKey& ck, const long double& systemTime)
   {
     if (lastEvent[part].second.first.second != NONE)
       {
 	counterData& refCount = counters[counterKey(eventKey(ck,etype), lastEvent[part].second)];
       
-	refCount.totalTime += Sim->systemTime - lastEvent[part].first;
+	refCount.totalTime += systemTime - lastEvent[part].first;
 	++(refCount.count);
 	++(totalCount);
       }
     else
       ++initialCounter[eventKey(ck,etype)];
 
-    lastEvent[part].first = Sim->systemTime;
+    lastEvent[part].first = systemTime;
     lastEvent[part].second = eventKey(ck, etype);
   }
 
@@ -19,6 +19,7 @@
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <dynamo/eventtypes.hpp>
 #include <dynamo/outputplugins/eventtypetracking.hpp>
+#include <magnet/memUsage.hpp>
 #include <map>
 #include <vector>
 
@@ -37,21 +38,24 @@ namespace dynamo {
 
     virtual void initialise();
 
-    virtual void eventUpdate(const IntEvent&, const PairEventData&);
+    virtual void eventUpdate(const EventRecord&);
 
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const LocalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const System&, const NEventData&, const double&);
+    //! \brief This plugin only uses the EventRecords, so it may run on an analysis thread.
+    virtual EventSubscription getEventSubscription() const { return EventSubscription().recorded(); }
 
     void output(magnet::xml::XmlStream &);
 
     //This is fine to replica exchange as the interaction, global and system lookups are done using names
     virtual void replicaExchange(OutputPlugin& plug) { std::swap(Sim, static_cast<OPCollMatrix&>(plug).Sim); }
+
+    virtual size_t getMemoryUsage() const
+    { 
+      return magnet::container_mem_usage(counters) + magnet::container_mem_usage(initialCounter)
+	+ magnet::container_mem_usage(lastEvent);
+    }
   
   protected:
-    void newEvent(const size_t&, const EEventType&, const classKey&);
+    void newEvent(const size_t&, const EEventType&, const classKey&, const long double&);
   
     struct counterData
     {
@@ -21,6 +21,7 @@
 #include <dynamo/include.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/memUsage.hpp>
 
 namespace {
   ::std::size_t
@@ -49,7 +50,7 @@ namespace dynamo {
     _collected_maps.clear();
     _map_links.clear();
     _next_map_id = 0;
-    _weight = 0;
+    _lastTime = Sim->systemTime;
     _total_weight = 0;
   
     _interaction = std::dynamic_pointer_cast<ICapture>(Sim->interactions[_interaction_name]);
@@ -57,19 +58,44 @@ namespace dynamo {
     if (!_interaction)
       M_throw() << "Could not cast \"" << _interaction_name << "\" to an ICapture type to build the contact map";
     
-    _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->calcInternalEnergy(), _next_map_id++))).first;
+    findCurrentMap(Sim->calcInternalEnergy());
   }
 
-  void OPContactMap::stream(double dt) { _weight += dt; }
+  void
+  OPContactMap::findCurrentMap(double energy)
+  {
+    const detail::CaptureMap& map = *_interaction;
+    std::pair<CollectedMapType::iterator, CollectedMapType::iterator> range = _collected_maps.equal_range(map.hash());
+
+    //Maps with the same hash are compared in full, so a hash
+    //collision can never merge two different maps. This only costs
+    //O(contacts) when a map with a matching hash exists.
+    for (CollectedMapType::iterator it = range.first; it != range.second; ++it)
+      if (it->second._map == map)
+	{
+	  _current_map = it;
+	  return;
+	}
+
+    _current_map = _collected_maps.insert(CollectedMapType::value_type(map.hash(), MapData(map, energy, _next_map_id++)));
+  }
+
+  EventSubscription
+  OPContactMap::getEventSubscription() const
+  {
+    return EventSubscription(EventSubscription::INTERACTION_EVENTS)
+      .onlyTypes({STEP_IN, STEP_OUT})
+      .onlyInteraction(_interaction->getID());
+  }
 
   void 
   OPContactMap::flush()
   {
     //Cannot create new maps here, as flush may happen when the output plugins are invalid
-    MapData& data = _current_map->second;
-    data._weight += _weight;
-    _total_weight += _weight;
-    _weight = 0;
+    const double weight = Sim->systemTime - _lastTime;
+    _current_map->second._weight += weight;
+    _total_weight += weight;
+    _lastTime = Sim->systemTime;
   }
 
   void 
@@ -81,25 +107,16 @@ namespace dynamo {
   }
 
   void 
-  OPContactMap::eventUpdate(const IntEvent &event, const PairEventData &eventdata) 
-  {
-    stream(event.getdt());
-
-    if (event.getInteractionID() == _interaction->getID())
-      if ((event.getType() == STEP_IN) || (event.getType() == STEP_OUT))
-	mapChanged(true);
-  }
+  OPContactMap::eventUpdate(const IntEvent&, const PairEventData&) 
+  { mapChanged(true); }
 
   void 
   OPContactMap::mapChanged(bool addLink) {
     flush();
     size_t oldMapID(_current_map->second._id);
     
-    //Try and find the current map in the collected maps
-    _current_map = _collected_maps.find(*_interaction);
-    if (_current_map == _collected_maps.end())
-      //Insert the new map
-      _current_map = _collected_maps.insert(CollectedMapType::value_type(*_interaction, MapData(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU(), _next_map_id++))).first;
+    //Try and find the current map in the collected maps, or insert it
+    findCurrentMap(Sim->getOutputPlugin<OPMisc>()->getConfigurationalU());
     
     //Add the link	    
     if (addLink)
@@ -111,26 +128,30 @@ namespace dynamo {
   {
     OPContactMap& other_map = static_cast<OPContactMap&>(otherplugin);
 
+    //Add the time spent in the current maps before the Simulations
+    //(and their system times) are swapped
+    flush();
+    other_map.flush();
+
     //Swap over the sim pointers
     std::swap(Sim, other_map.Sim);
     std::swap(_interaction, other_map._interaction);
+    _lastTime = Sim->systemTime;
+    other_map._lastTime = other_map.Sim->systemTime;
 
     //Now let each plugin know the map has changed
     mapChanged(false);
     other_map.mapChanged(false);
   }
 
-  void 
-  OPContactMap::eventUpdate(const GlobalEvent &event, const NEventData&) 
-  { stream(event.getdt()); }
-
-  void 
-  OPContactMap::eventUpdate(const LocalEvent &event, const NEventData&) 
-  { stream(event.getdt()); }
-
-  void 
-  OPContactMap::eventUpdate(const System&, const NEventData&, const double& dt)
-  { stream(dt); }
+  size_t
+  OPContactMap::getMemoryUsage() const
+  {
+    size_t bytes = magnet::container_mem_usage(_collected_maps) + magnet::container_mem_usage(_map_links);
+    for (const CollectedMapType::value_type& entry : _collected_maps)
+      bytes += magnet::container_mem_usage(entry.second._map);
+    return bytes;
+  }
 
   void
   OPContactMap::periodicOutput()
@@ -141,6 +162,9 @@ namespace dynamo {
   void 
   OPContactMap::output(magnet::xml::XmlStream& XML)
   {
+    //Add the time spent in the current map since the last change
+    flush();
+
     dout << "Writing out " << _collected_maps.size() << " Contact maps with "
 	 << _map_links.size() << " links" << std::endl;
 
@@ -156,7 +180,7 @@ namespace dynamo {
 	    << magnet::xml::attr("Energy") << entry.second._energy / Sim->units.unitEnergy()
 	    << magnet::xml::attr("Weight") << entry.second._weight / _total_weight;
 	
-	for (const ICapture::value_type& ids : entry.first)
+	for (const ICapture::value_type& ids : entry.second._map)
 	  XML << magnet::xml::tag("Contact")
 	      << magnet::xml::attr("ID1") << ids.first.first
 	      << magnet::xml::attr("ID2") << ids.first.second
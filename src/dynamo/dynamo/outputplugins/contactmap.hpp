@@ -37,9 +37,14 @@ namespace dynamo {
     ~OPContactMap() {}
 
     virtual void eventUpdate(const IntEvent&, const PairEventData&);
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
-    virtual void eventUpdate(const LocalEvent&, const NEventData&);
-    virtual void eventUpdate(const System&, const NEventData&, const double&);
+
+    /*! \brief Only the events which capture or release a pair of the
+        tracked Interaction are received.
+
+      The time spent in each map is measured from the system time of
+      these events, so the other events are not needed.
+     */
+    virtual EventSubscription getEventSubscription() const;
 
     virtual void initialise();
 
@@ -49,15 +54,20 @@ namespace dynamo {
 
     virtual void replicaExchange(OutputPlugin&);
 
+    virtual size_t getMemoryUsage() const;
+
     void periodicOutput();
 
   private:
-    void stream(double);
     void flush();
     
     void mapChanged(bool addLink);
 
-    double _weight;
+    //! \brief Find the current map of the interaction, adding it if it is new.
+    void findCurrentMap(double energy);
+
+    //! \brief The system time when the current map was last flushed.
+    long double _lastTime;
     double _total_weight;
     /*! \brief A sorted listing of all the captured pairs in the
      system
@@ -66,19 +76,23 @@ namespace dynamo {
 
     struct MapData
     {
-      MapData(double energy=0, size_t id = 0): _weight(0), _energy(energy), _id(id) {}
+      MapData(const detail::CaptureMap& map, double energy, size_t id):
+	_map(map), _weight(0), _energy(energy), _id(id) {}
+      detail::CaptureMapKey _map;
       double _weight;
       double _energy;
       size_t _id;
     };
 
-    typedef std::unordered_map<detail::CaptureMapKey, MapData,  detail::CaptureMapKeyHash> CollectedMapType;
+    typedef std::unordered_multimap<std::size_t, MapData> CollectedMapType;
     typedef std::unordered_map<std::pair<size_t, size_t>, size_t, detail::OPContactMapPairHash> LinksMapType;
     /*! \brief A hash table storing the histogram of the contact maps.
       
-      The key of this map is a sorted list of the captured pairs in
-      the system. This sorting is implicitly carried out by the
-      _current_map.
+      The key of this map is the hash of the contact map, which the
+      ICapture updates as each pair is captured or released, so
+      looking up the current map does not require copying or hashing
+      all of its contacts. The contacts are only compared in full
+      against the collected maps with the same hash.
      */
     CollectedMapType _collected_maps;
     CollectedMapType::iterator _current_map;
@@ -35,13 +35,10 @@ namespace dynamo {
 
     virtual void initialise();
 
-    virtual void eventUpdate(const IntEvent&, const PairEventData&);
+    virtual void eventUpdate(const EventRecord&);
 
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const LocalEvent&, const NEventData&);
-
-    virtual void eventUpdate(const System&, const NEventData&, const double&);
+    //! \brief This plugin only uses the EventRecords, so it may run on an analysis thread.
+    virtual EventSubscription getEventSubscription() const { return EventSubscription().recorded(); }
 
     void output(magnet::xml::XmlStream &);
 
@@ -0,0 +1,344 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/outputplugins/eventbus.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/globals/globEvent.hpp>
+#include <dynamo/locals/localEvent.hpp>
+#include <dynamo/systems/system.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <magnet/thread/ringbuffer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <exception>
+
+namespace dynamo {
+  /*! \brief The analysis threads and the ring buffer of
+      EventRecords they process.
+   */
+  class OPEventBus::Pipeline
+  {
+  public:
+    Pipeline(const std::vector<std::vector<RecordSubscriber> >& groups):
+      _buffer(4096, groups.size()),
+      _groups(groups),
+      _stop(false)
+    {
+      for (size_t i(0); i < _groups.size(); ++i)
+	_threads.push_back(std::thread(&Pipeline::consume, this, i));
+    }
+
+    ~Pipeline()
+    {
+      _stop.store(true, std::memory_order_release);
+      for (std::thread& thread : _threads)
+	thread.join();
+    }
+
+    EventRecord& claim() { return _buffer.claim(); }
+
+    void publish() { _buffer.publish(); }
+
+    void synchronise()
+    {
+      while (!_buffer.drained())
+	std::this_thread::yield();
+
+      std::lock_guard<std::mutex> lock(_errorLock);
+      if (_error)
+	{
+	  std::exception_ptr error = _error;
+	  _error = std::exception_ptr();
+	  std::rethrow_exception(error);
+	}
+    }
+
+  private:
+    void consume(size_t consumer)
+    {
+      size_t idle = 0;
+      for (;;)
+	{
+	  const EventRecord* record = _buffer.front(consumer);
+	  if (!record)
+	    {
+	      //The stop flag is only set once the Simulation has
+	      //finished publishing
+	      if (_stop.load(std::memory_order_acquire) && !_buffer.front(consumer))
+		return;
+
+	      //Spin briefly before sleeping, as the next record
+	      //usually arrives quickly
+	      if (++idle < 1000)
+		std::this_thread::yield();
+	      else
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	      continue;
+	    }
+
+	  idle = 0;
+	  try
+	    {
+	      for (const RecordSubscriber& subscriber : _groups[consumer])
+		if (subscriber.subscribes(*record))
+		  subscriber._plugin->eventUpdate(*record);
+	    }
+	  catch (...)
+	    {
+	      std::lock_guard<std::mutex> lock(_errorLock);
+	      if (!_error) _error = std::current_exception();
+	    }
+
+	  _buffer.release(consumer);
+	}
+    }
+
+    magnet::thread::BroadcastRingBuffer<EventRecord> _buffer;
+    const std::vector<std::vector<RecordSubscriber> > _groups;
+    std::vector<std::thread> _threads;
+    std::atomic<bool> _stop;
+    std::mutex _errorLock;
+    std::exception_ptr _error;
+  };
+
+  bool
+  OPEventBus::RecordSubscriber::subscribes(EventSubscription::Category category, EEventType type, size_t sourceID) const
+  {
+    if (!_subscription.subscribes(category) || !_subscription.subscribes(type))
+      return false;
+
+    const std::vector<size_t>& IDs = _subscription._interactionIDs;
+    return (category != EventSubscription::INTERACTION_EVENTS) || IDs.empty()
+      || (std::find(IDs.begin(), IDs.end(), sourceID) != IDs.end());
+  }
+
+  OPEventBus::OPEventBus():
+    _sim(NULL),
+    _analysisThreads(0)
+  {}
+
+  OPEventBus::~OPEventBus()
+  {}
+
+  void
+  OPEventBus::build(const Simulation* sim)
+  {
+    //Stop any running analysis threads
+    if (_pipeline) _pipeline->synchronise();
+    _pipeline.reset();
+
+    _sim = sim;
+    const size_t interactionCount = _sim->interactions.size();
+    _interactionSubscribers.assign(interactionCount, SubscriberList());
+    _anyInteractionSubscribers.clear();
+    _globalSubscribers.clear();
+    _localSubscribers.clear();
+    _systemSubscribers.clear();
+    _recordSubscribers.clear();
+
+    for (const shared_ptr<OutputPlugin>& plugin : _sim->outputPlugins)
+      {
+	const EventSubscription sub = plugin->getEventSubscription();
+	if (sub._recorded)
+	  {
+	    if (sub._categories != EventSubscription::NO_EVENTS)
+	      _recordSubscribers.push_back(RecordSubscriber(plugin.get(), sub));
+	    continue;
+	  }
+
+	const Subscriber subscriber(plugin.get(), sub._types);
+
+	if (sub.subscribes(EventSubscription::INTERACTION_EVENTS))
+	  {
+	    const bool allInteractions = sub._interactionIDs.empty();
+	    if (allInteractions)
+	      _anyInteractionSubscribers.push_back(subscriber);
+
+	    for (size_t ID(0); ID < interactionCount; ++ID)
+	      if (allInteractions || (std::find(sub._interactionIDs.begin(), sub._interactionIDs.end(), ID) != sub._interactionIDs.end()))
+		_interactionSubscribers[ID].push_back(subscriber);
+	  }
+
+	if (sub.subscribes(EventSubscription::GLOBAL_EVENTS))
+	  _globalSubscribers.push_back(subscriber);
+
+	if (sub.subscribes(EventSubscription::LOCAL_EVENTS))
+	  _localSubscribers.push_back(subscriber);
+
+	if (sub.subscribes(EventSubscription::SYSTEM_EVENTS))
+	  _systemSubscribers.push_back(subscriber);
+      }
+
+    if (_analysisThreads && !_recordSubscribers.empty())
+      {
+	//Share the plugins between the threads
+	std::vector<std::vector<RecordSubscriber> > groups(std::min(_analysisThreads, _recordSubscribers.size()));
+	for (size_t i(0); i < _recordSubscribers.size(); ++i)
+	  groups[i % groups.size()].push_back(_recordSubscribers[i]);
+
+	_pipeline.reset(new Pipeline(groups));
+      }
+  }
+
+  void
+  OPEventBus::synchronise()
+  {
+    if (_pipeline) _pipeline->synchronise();
+  }
+
+  EventRecord*
+  OPEventBus::claimRecord(EventSubscription::Category category, EEventType type, const EventTypeTracking::classKey& source, double dt)
+  {
+    bool subscribed = false;
+    for (const RecordSubscriber& subscriber : _recordSubscribers)
+      if (subscriber.subscribes(category, type, source.first))
+	{
+	  subscribed = true;
+	  break;
+	}
+
+    if (!subscribed) return NULL;
+
+    //The records are reused, so their vectors keep their capacity
+    EventRecord& record = _pipeline ? _pipeline->claim() : _record;
+    record._category = category;
+    record._source = source;
+    record._type = type;
+    record._dt = dt;
+    record._systemTime = _sim->systemTime;
+    record._particles.clear();
+    record._pairs.clear();
+    return &record;
+  }
+
+  void
+  OPEventBus::publishRecord()
+  {
+    if (_pipeline)
+      _pipeline->publish();
+    else
+      for (const RecordSubscriber& subscriber : _recordSubscribers)
+	if (subscriber.subscribes(_record))
+	  subscriber._plugin->eventUpdate(_record);
+  }
+
+  EventRecord::ParticleChange
+  OPEventBus::recordChange(const ParticleEventData& data) const
+  {
+    const Particle& particle = _sim->particles[data.getParticleID()];
+    EventRecord::ParticleChange change;
+    change._ID = data.getParticleID();
+    change._speciesID = data.getSpeciesID();
+    change._mass = _sim->species.getMass(particle);
+    change._type = data.getType();
+    change._oldVel = data.getOldVel();
+    change._newVel = particle.getVelocity();
+    change._deltaU = data.getDeltaU();
+    return change;
+  }
+
+  EventRecord::PairChange
+  OPEventBus::recordChange(const PairEventData& data, EEventType type) const
+  {
+    EventRecord::PairChange change;
+    change._particle1 = recordChange(data.particle1_);
+    change._particle2 = recordChange(data.particle2_);
+    change._impulse = data.impulse;
+    change._type = type;
+    return change;
+  }
+
+  void
+  OPEventBus::recordChanges(EventRecord& record, const NEventData& data) const
+  {
+    for (const ParticleEventData& pData : data.L1partChanges)
+      record._particles.push_back(recordChange(pData));
+
+    for (const PairEventData& pData : data.L2partChanges)
+      record._pairs.push_back(recordChange(pData, pData.getType()));
+  }
+
+  void
+  OPEventBus::eventUpdate(const IntEvent& event, const PairEventData& data)
+  {
+    //Events of Interactions added after the lists were built only go
+    //to the plugins receiving every Interaction.
+    const size_t ID = event.getInteractionID();
+    const SubscriberList& subscribers = (ID < _interactionSubscribers.size())
+      ? _interactionSubscribers[ID] : _anyInteractionSubscribers;
+
+    for (const Subscriber& subscriber : subscribers)
+      if (subscriber.subscribes(event.getType()))
+	subscriber._plugin->eventUpdate(event, data);
+
+    if (_recordSubscribers.empty()) return;
+
+    EventRecord* record = claimRecord(EventSubscription::INTERACTION_EVENTS, event.getType(), EventTypeTracking::getClassKey(event), event.getdt());
+    if (!record) return;
+    record->_pairs.push_back(recordChange(data, event.getType()));
+    publishRecord();
+  }
+
+  void
+  OPEventBus::eventUpdate(const GlobalEvent& event, const NEventData& data)
+  {
+    for (const Subscriber& subscriber : _globalSubscribers)
+      if (subscriber.subscribes(event.getType()))
+	subscriber._plugin->eventUpdate(event, data);
+
+    if (_recordSubscribers.empty()) return;
+
+    EventRecord* record = claimRecord(EventSubscription::GLOBAL_EVENTS, event.getType(), EventTypeTracking::getClassKey(event), event.getdt());
+    if (!record) return;
+    recordChanges(*record, data);
+    publishRecord();
+  }
+
+  void
+  OPEventBus::eventUpdate(const LocalEvent& event, const NEventData& data)
+  {
+    for (const Subscriber& subscriber : _localSubscribers)
+      if (subscriber.subscribes(event.getType()))
+	subscriber._plugin->eventUpdate(event, data);
+
+    if (_recordSubscribers.empty()) return;
+
+    EventRecord* record = claimRecord(EventSubscription::LOCAL_EVENTS, event.getType(), EventTypeTracking::getClassKey(event), event.getdt());
+    if (!record) return;
+    recordChanges(*record, data);
+    publishRecord();
+  }
+
+  void
+  OPEventBus::eventUpdate(const System& event, const NEventData& data, const double& dt)
+  {
+    for (const Subscriber& subscriber : _systemSubscribers)
+      if (subscriber.subscribes(event.getType()))
+	subscriber._plugin->eventUpdate(event, data, dt);
+
+    if (_recordSubscribers.empty()) return;
+
+    EventRecord* record = claimRecord(EventSubscription::SYSTEM_EVENTS, event.getType(), EventTypeTracking::getClassKey(event), dt);
+    if (!record) return;
+    recordChanges(*record, data);
+    publishRecord();
+  }
+}
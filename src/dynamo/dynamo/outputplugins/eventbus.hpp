@@ -0,0 +1,146 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/outputplugins/eventrecord.hpp>
+#include <memory>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief Passes the events of a Simulation to the OutputPlugins
+      which subscribe to them.
+
+      Instead of calling all four eventUpdate functions of every
+      OutputPlugin, a list of subscribers is built for each category
+      of event (and for each Interaction) from the
+      OutputPlugin::getEventSubscription() of each plugin. Events
+      are then only passed to the plugins in the matching list, in
+      the update order of the plugins.
+
+      Plugins subscribing to EventSubscription::recorded() events are
+      passed an EventRecord of each event instead. If analysis
+      threads are enabled (see setAnalysisThreads()), the records are
+      published into a BroadcastRingBuffer and processed by the
+      analysis threads, which each process the records for a share
+      of these plugins. The Simulation only waits for the analysis
+      threads when the buffer is full, or when it must synchronise()
+      before calling any other function of the plugins.
+   */
+  class OPEventBus
+  {
+  public:
+    OPEventBus();
+
+    ~OPEventBus();
+
+    /*! \brief Set the number of threads used to process the
+        EventRecords.
+
+      If this is zero, the records are processed immediately by the
+      calling thread. This takes effect the next time build() is
+      called.
+     */
+    void setAnalysisThreads(size_t threads) { _analysisThreads = threads; }
+
+    /*! \brief Build the subscriber lists from the sorted
+        Simulation::outputPlugins, and start any analysis threads.
+     */
+    void build(const Simulation* sim);
+
+    /*! \brief Wait until every EventRecord has been processed by
+        the analysis threads.
+
+      This must be called before any function (other than
+      eventUpdate) of an OutputPlugin subscribed to recorded events
+      is called, and rethrows any exception raised while the records
+      were processed.
+     */
+    void synchronise();
+
+    void eventUpdate(const IntEvent&, const PairEventData&);
+
+    void eventUpdate(const GlobalEvent&, const NEventData&);
+
+    void eventUpdate(const LocalEvent&, const NEventData&);
+
+    void eventUpdate(const System&, const NEventData&, const double&);
+
+  private:
+    OPEventBus(const OPEventBus&);
+    OPEventBus& operator=(const OPEventBus&);
+
+    struct Subscriber
+    {
+      Subscriber(OutputPlugin* plugin, uint64_t types): _plugin(plugin), _types(types) {}
+
+      bool subscribes(EEventType type) const { return (_types >> type) & 1; }
+
+      OutputPlugin* _plugin;
+      uint64_t _types;
+    };
+
+    typedef std::vector<Subscriber> SubscriberList;
+
+    //! \brief A plugin subscribing to recorded events.
+    struct RecordSubscriber
+    {
+      RecordSubscriber(OutputPlugin* plugin, const EventSubscription& subscription):
+	_plugin(plugin), _subscription(subscription) {}
+
+      bool subscribes(EventSubscription::Category category, EEventType type, size_t sourceID) const;
+
+      bool subscribes(const EventRecord& record) const
+      { return subscribes(record._category, record._type, record._source.first); }
+
+      OutputPlugin* _plugin;
+      EventSubscription _subscription;
+    };
+
+    class Pipeline;
+
+    /*! \brief Returns the EventRecord to fill for an event, or NULL
+        if no plugin subscribes to recorded events of this kind.
+     */
+    EventRecord* claimRecord(EventSubscription::Category category, EEventType type, const EventTypeTracking::classKey& source, double dt);
+
+    //! \brief Process or publish the record returned by claimRecord().
+    void publishRecord();
+
+    EventRecord::ParticleChange recordChange(const ParticleEventData&) const;
+
+    EventRecord::PairChange recordChange(const PairEventData&, EEventType) const;
+
+    void recordChanges(EventRecord&, const NEventData&) const;
+
+    const Simulation* _sim;
+
+    //! \brief The subscribers to the IntEvents of each Interaction.
+    std::vector<SubscriberList> _interactionSubscribers;
+    //! \brief The subscribers to the IntEvents of every Interaction.
+    SubscriberList _anyInteractionSubscribers;
+    SubscriberList _globalSubscribers;
+    SubscriberList _localSubscribers;
+    SubscriberList _systemSubscribers;
+
+    std::vector<RecordSubscriber> _recordSubscribers;
+    size_t _analysisThreads;
+    //! \brief The record used if there are no analysis threads.
+    EventRecord _record;
+    std::unique_ptr<Pipeline> _pipeline;
+  };
+}
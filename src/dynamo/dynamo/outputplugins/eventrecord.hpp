@@ -0,0 +1,73 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/outputplugins/eventtypetracking.hpp>
+#include <magnet/math/vector.hpp>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A self-contained copy of an executed event.
+
+    The eventUpdate functions of an OutputPlugin are passed the event
+    itself, and may read the current state of the Simulation (e.g.,
+    the new velocities of the particles) to process it. An
+    EventRecord instead holds everything needed to process the
+    event, so it may be processed later, and on another thread, while
+    the Simulation continues. See EventSubscription::recorded().
+   */
+  struct EventRecord
+  {
+    //! \brief The change of a single particle.
+    struct ParticleChange
+    {
+      size_t _ID;
+      size_t _speciesID;
+      double _mass;
+      EEventType _type;
+      Vector _oldVel;
+      Vector _newVel;
+      double _deltaU;
+    };
+
+    //! \brief The change of a pair of particles.
+    struct PairChange
+    {
+      ParticleChange _particle1;
+      ParticleChange _particle2;
+      //! \brief The impulse on the second particle (the first particle receives -_impulse).
+      Vector _impulse;
+      //! \brief The type of the pair change (for an IntEvent, this is the event type).
+      EEventType _type;
+    };
+
+    //! \brief Which eventUpdate overload the event was passed to.
+    EventSubscription::Category _category;
+    //! \brief The ID and class of the Interaction, Global, Local or System which caused the event.
+    EventTypeTracking::classKey _source;
+    EEventType _type;
+    //! \brief The time between the previous event and this event.
+    double _dt;
+    //! \brief The system time after the event.
+    long double _systemTime;
+    //! \brief The changes of single particles (from an NEventData).
+    std::vector<ParticleChange> _particles;
+    //! \brief The changes of particle pairs.
+    std::vector<PairChange> _pairs;
+  };
+}
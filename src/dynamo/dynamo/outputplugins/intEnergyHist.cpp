@@ -79,7 +79,7 @@ namespace dynamo {
     std::swap(Sim, static_cast<OPIntEnergyHist&>(EHist2).Sim);
   }
 
-  std::unordered_map<int, double>
+  magnet::containers::OffsetArray<double>
   OPIntEnergyHist::getImprovedW() const
   {
     if (!std::dynamic_pointer_cast<const DynNewtonianMC>(Sim->dynamics))
@@ -91,9 +91,10 @@ namespace dynamo {
       M_throw() << "Cannot improve the W potential when there is a mismatch between the"
 		<< " internal energy histogram and MC potential bin widths.";
 
-    std::unordered_map<int, double> retval;
+    magnet::containers::OffsetArray<double> retval;
+    std::vector<long> bins;
 
-    typedef std::pair<const int, double> lv1pair;
+    typedef std::pair<const long, double> lv1pair;
     for (const lv1pair &p1 : intEnergyHist)
       {
 	double E = p1.first * intEnergyHist.getBinWidth();
@@ -105,20 +106,21 @@ namespace dynamo {
 	//We only try to optimize parts of the histogram with greater
 	//than 1% probability
 	if (Pc > 0.01)
-	  retval[lrint(E / intEnergyHist.getBinWidth())]
-	    = dynamics.W(E) + std::log(Pc);
+	  {
+	    bins.push_back(lrint(E / intEnergyHist.getBinWidth()));
+	    retval[bins.back()] = dynamics.W(E) + std::log(Pc);
+	  }
       }
   
     //Now center the energy warps about 0 to not cause funny changes in the tails.
-    typedef std::pair<const int, double> locpair;
     double avg = 0;
-    for (const locpair& p : retval)
-      avg += p.second;
+    for (const long i : bins)
+      avg += retval(i);
 
-    avg /= retval.size();
+    avg /= bins.size();
 
-    for (locpair& p : retval)
-      p.second -= avg;
+    for (const long i : bins)
+      retval[i] -= avg;
 
     return retval;
   }
@@ -145,13 +147,14 @@ namespace dynamo {
 	    << magnet::xml::attr("EnergyStep")
 	    << dynamics.getEnergyStep() * Sim->units.unitEnergy();
 	
-	typedef std::pair<const int, double> locpair;
-	for (const locpair& p1 : dynamics.getMap())
-	  XML << magnet::xml::tag("W")
-	      << magnet::xml::attr("Energy")
-	      << p1.first * dynamics.getEnergyStep() * Sim->units.unitEnergy()
-	      << magnet::xml::attr("Value") << p1.second
-	      << magnet::xml::endtag("W");
+	const magnet::containers::OffsetArray<double>& W = dynamics.getMap();
+	for (long i(W.begin_index()); i < W.end_index(); ++i)
+	  if (W(i))
+	    XML << magnet::xml::tag("W")
+		<< magnet::xml::attr("Energy")
+		<< i * dynamics.getEnergyStep() * Sim->units.unitEnergy()
+		<< magnet::xml::attr("Value") << W(i)
+		<< magnet::xml::endtag("W");
 	
 	XML << magnet::xml::endtag("PotentialDeformation");
       
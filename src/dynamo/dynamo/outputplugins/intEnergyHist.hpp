@@ -18,7 +18,7 @@
 #pragma once
 #include <dynamo/outputplugins/outputplugin.hpp>
 #include <magnet/math/histogram.hpp>
-#include <unordered_map>
+#include <magnet/containers/offset_array.hpp>
 
 namespace dynamo {
   class OPMisc;
@@ -44,7 +44,7 @@ namespace dynamo {
   
     void operator<<(const magnet::xml::Node&);
 
-    std::unordered_map<int, double> getImprovedW() const;
+    magnet::containers::OffsetArray<double> getImprovedW() const;
     inline double getBinWidth() const { return intEnergyHist.getBinWidth(); }
   protected:
     magnet::math::HistogramWeighted<> intEnergyHist;
@@ -42,6 +42,22 @@ namespace dynamo {
     std::swap(Sim, op.Sim);
   }
 
+  size_t
+  OPMisc::getMemoryUsage() const
+  {
+    size_t bytes = _thermalConductivity.getMemoryUsage() + _viscosity.getMemoryUsage()
+      + magnet::container_mem_usage(_thermalDiffusion) + magnet::container_mem_usage(_mutualDiffusion)
+      + magnet::container_mem_usage(_counters) + magnet::container_mem_usage(_internalEnergy);
+
+    for (const magnet::math::LogarithmicTimeCorrelator<Vector>& correlator : _thermalDiffusion)
+      bytes += correlator.getMemoryUsage();
+
+    for (const magnet::math::LogarithmicTimeCorrelator<Vector>& correlator : _mutualDiffusion)
+      bytes += correlator.getMemoryUsage();
+
+    return bytes;
+  }
+
   void
   OPMisc::temperatureRescale(const double& scale)
   { 
@@ -187,7 +203,7 @@ namespace dynamo {
     CounterData& counterdata = _counters[CounterKey(getClassKey(eevent), eevent.getType())];
     counterdata.count += NDat.L1partChanges.size() + NDat.L2partChanges.size();
     for (const ParticleEventData& pData : NDat.L1partChanges)
-      counterdata.netimpulse += Sim->species[pData.getSpeciesID()]->getMass(pData.getParticleID()) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
+      counterdata.netimpulse += Sim->species.getMass(Sim->particles[pData.getParticleID()]) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
   }
 
   void
@@ -198,7 +214,7 @@ namespace dynamo {
     CounterData& counterdata = _counters[CounterKey(getClassKey(eevent), eevent.getType())];
     counterdata.count += NDat.L1partChanges.size() + NDat.L2partChanges.size();
     for (const ParticleEventData& pData : NDat.L1partChanges)
-      counterdata.netimpulse += Sim->species[pData.getSpeciesID()]->getMass(pData.getParticleID()) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
+      counterdata.netimpulse += Sim->species.getMass(Sim->particles[pData.getParticleID()]) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
   }
 
   void
@@ -209,7 +225,7 @@ namespace dynamo {
     CounterData& counterdata = _counters[CounterKey(getClassKey(eevent), eevent.getType())];
     counterdata.count += NDat.L1partChanges.size() + NDat.L2partChanges.size();
     for (const ParticleEventData& pData : NDat.L1partChanges)
-      counterdata.netimpulse += Sim->species[pData.getSpeciesID()]->getMass(pData.getParticleID()) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
+      counterdata.netimpulse += Sim->species.getMass(Sim->particles[pData.getParticleID()]) * (Sim->particles[pData.getParticleID()].getVelocity() -  pData.getOldVel());
   }
 
   void
@@ -482,8 +498,24 @@ namespace dynamo {
 	<< endtag("NegativeTimeEvents")
 
 	<< tag("Memusage")
-	<< attr("MaxKiloBytes") << magnet::process_mem_usage()
-	<< endtag("Memusage")
+	<< attr("MaxKiloBytes") << magnet::process_mem_usage();
+
+    {
+      //The memory held by each of the data structures of the Simulation
+      size_t total(0);
+      for (const Simulation::MemoryUsage& entry : Sim->getMemoryUsage())
+	{
+	  XML << tag("Subsystem")
+	      << attr("Type") << entry._subsystem
+	      << attr("Name") << entry._name
+	      << attr("Bytes") << entry._bytes
+	      << endtag("Subsystem");
+	  total += entry._bytes;
+	}
+      XML << tag("Accounted") << attr("Bytes") << total << endtag("Accounted");
+    }
+
+    XML << endtag("Memusage")
 
 	<< tag("ThermalConductivity")
 	<< tag("Correlator")
@@ -52,6 +52,8 @@ namespace dynamo {
   
     void replicaExchange(OutputPlugin&);
 
+    virtual size_t getMemoryUsage() const;
+
     double getDuration() const;
     double getEventsPerSecond() const;
     double getSimTimePerSecond() const;
@@ -105,7 +105,7 @@ namespace dynamo {
 	double totmass = 0.0;
 	for (const unsigned long& ID : *molRange)
 	  {
-	    double pmass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	    double pmass = Sim->species.getMass(Sim->particles[ID]);
 
 	    totmass += pmass;
 	    currPos += Sim->particles[ID].getPosition() * pmass;
@@ -19,6 +19,7 @@
 #include <vector>
 #include <magnet/math/vector.hpp>
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <magnet/memUsage.hpp>
 
 namespace dynamo {
   class Topology;
@@ -39,6 +40,8 @@ namespace dynamo {
 
     virtual void eventUpdate(const System&, const NEventData&, const double&) {}
 
+    virtual EventSubscription getEventSubscription() const { return EventSubscription::NO_EVENTS; }
+
     void output(magnet::xml::XmlStream &); 
 
     double calcMSD(const IDRange& range) const;
@@ -47,6 +50,8 @@ namespace dynamo {
 
     virtual void replicaExchange(OutputPlugin&)
     { M_throw() << "This plugin hasn't been prepared for changes of system"; }
+
+    virtual size_t getMemoryUsage() const { return magnet::container_mem_usage(initPos); }
   
   protected:
   
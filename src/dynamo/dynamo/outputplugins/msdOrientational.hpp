@@ -17,6 +17,7 @@
 
 #pragma once
 #include <dynamo/outputplugins/outputplugin.hpp>
+#include <magnet/memUsage.hpp>
 #include <magnet/math/vector.hpp>
 #include <vector>
 
@@ -35,6 +36,8 @@ namespace dynamo {
     virtual void eventUpdate(const LocalEvent&, const NEventData&) {}
     virtual void eventUpdate(const System&, const NEventData&, const double&) {}
 
+    virtual EventSubscription getEventSubscription() const { return EventSubscription::NO_EVENTS; }
+
     void output(magnet::xml::XmlStream &);
 
     struct msdCalcReturn
@@ -52,6 +55,8 @@ namespace dynamo {
     virtual void replicaExchange(OutputPlugin&)
     { M_throw() << "This output plugin hasn't been prepared for changes of system"; }
 
+    virtual size_t getMemoryUsage() const { return magnet::container_mem_usage(initialConfiguration); }
+
   protected:
 
     std::vector<RUpair> initialConfiguration;
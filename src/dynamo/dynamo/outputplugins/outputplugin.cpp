@@ -28,7 +28,8 @@
 namespace dynamo {
   OutputPlugin::OutputPlugin(const dynamo::Simulation* tmp, const char *aName, unsigned char order):
     SimBase_const(tmp, aName),
-    updateOrder(order)
+    updateOrder(order),
+    _name(aName)
   {
     dout << "Loaded" << std::endl;
   }
@@ -37,6 +38,26 @@ namespace dynamo {
   OutputPlugin::output(magnet::xml::XmlStream&)
   {}
 
+  void
+  OutputPlugin::eventUpdate(const IntEvent&, const PairEventData&)
+  { M_throw() << "This plugin has not subscribed to Interaction events"; }
+
+  void
+  OutputPlugin::eventUpdate(const GlobalEvent&, const NEventData&)
+  { M_throw() << "This plugin has not subscribed to Global events"; }
+
+  void
+  OutputPlugin::eventUpdate(const LocalEvent&, const NEventData&)
+  { M_throw() << "This plugin has not subscribed to Local events"; }
+
+  void
+  OutputPlugin::eventUpdate(const System&, const NEventData&, const double&)
+  { M_throw() << "This plugin has not subscribed to System events"; }
+
+  void
+  OutputPlugin::eventUpdate(const EventRecord&)
+  { M_throw() << "This plugin has not subscribed to recorded events"; }
+
   void
   OutputPlugin::periodicOutput()
   {}
@@ -140,6 +161,8 @@ namespace dynamo {
       return testGeneratePlugin<OPChainBondAngles>(Sim, XML);
     else if (!Name.compare("Trajectory"))
       return testGeneratePlugin<OPTrajectory>(Sim, XML);
+    else if (!Name.compare("BinaryTrajectory"))
+      return testGeneratePlugin<OPBinaryTrajectory>(Sim, XML);
     else if (!Name.compare("ChainBondLength"))
       return testGeneratePlugin<OPChainBondLength>(Sim, XML);
     else if (!Name.compare("VelDist"))
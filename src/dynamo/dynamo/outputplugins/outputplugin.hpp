@@ -17,6 +17,11 @@
 
 #pragma once
 #include <dynamo/base.hpp>
+#include <dynamo/eventtypes.hpp>
+#include <vector>
+#include <string>
+#include <initializer_list>
+#include <cstdint>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 
@@ -30,6 +35,84 @@ namespace dynamo {
   class System;
   class LocalEvent;
   class IDRange;
+  struct EventRecord;
+
+  /*! \brief A description of the events an OutputPlugin receives
+      through its eventUpdate functions.
+
+      Events are only passed to the plugins which subscribe to them
+      (see OPEventBus). By default, a plugin subscribes to every event.
+   */
+  struct EventSubscription
+  {
+    //! \brief The categories of event, one for each eventUpdate overload.
+    enum Category
+      {
+	NO_EVENTS = 0,
+	INTERACTION_EVENTS = 1 << 0,
+	GLOBAL_EVENTS = 1 << 1,
+	LOCAL_EVENTS = 1 << 2,
+	SYSTEM_EVENTS = 1 << 3,
+	ALL_EVENTS = INTERACTION_EVENTS | GLOBAL_EVENTS | LOCAL_EVENTS | SYSTEM_EVENTS
+      };
+
+    EventSubscription(unsigned int categories = ALL_EVENTS):
+      _categories(categories),
+      _types(~uint64_t(0)),
+      _recorded(false)
+    {}
+
+    /*! \brief Receive the events as EventRecords, through
+        OutputPlugin::eventUpdate(const EventRecord&).
+
+      A plugin subscribing to recorded events must only use the
+      EventRecord (and not the current state of the Simulation) to
+      process an event, as the records may be processed on a separate
+      analysis thread, while the Simulation continues. The
+      Simulation waits for the records to be processed before any
+      other function of the plugin is called.
+     */
+    EventSubscription& recorded()
+    {
+      _recorded = true;
+      return *this;
+    }
+
+    /*! \brief Only receive events of the listed types.
+
+      This may be called multiple times to add more types.
+     */
+    EventSubscription& onlyTypes(std::initializer_list<EEventType> types)
+    {
+      if (_types == ~uint64_t(0)) _types = 0;
+      for (EEventType type : types)
+	_types |= uint64_t(1) << type;
+      return *this;
+    }
+
+    /*! \brief Only receive the IntEvents of the Interaction with the
+        passed ID.
+
+      This may be called multiple times to add more Interactions.
+     */
+    EventSubscription& onlyInteraction(size_t ID)
+    {
+      _interactionIDs.push_back(ID);
+      return *this;
+    }
+
+    bool subscribes(Category category) const { return _categories & category; }
+
+    bool subscribes(EEventType type) const { return (_types >> type) & 1; }
+
+    unsigned int _categories;
+    //! \brief A bitmask of the EEventType values received.
+    uint64_t _types;
+    //! \brief The IDs of the Interactions received, or empty for all.
+    std::vector<size_t> _interactionIDs;
+    //! \brief If the events are received as EventRecords.
+    bool _recorded;
+  };
 
   class OutputPlugin: public dynamo::SimBase_const
   {
@@ -40,13 +123,26 @@ namespace dynamo {
   
     virtual void initialise() = 0;
   
-    virtual void eventUpdate(const IntEvent&, const PairEventData&) = 0;
+    virtual void eventUpdate(const IntEvent&, const PairEventData&);
   
-    virtual void eventUpdate(const GlobalEvent&, const NEventData&) = 0;
+    virtual void eventUpdate(const GlobalEvent&, const NEventData&);
+
+    virtual void eventUpdate(const LocalEvent&, const NEventData&);
+
+    virtual void eventUpdate(const System&, const NEventData&, const double&);
 
-    virtual void eventUpdate(const LocalEvent&, const NEventData&) = 0;
+    //! \brief Process an event, for plugins subscribing to EventSubscription::recorded() events.
+    virtual void eventUpdate(const EventRecord&);
 
-    virtual void eventUpdate(const System&, const NEventData&, const double&) = 0;
+    /*! \brief The events which this plugin should receive.
+
+      This is called by the Simulation after the plugin has been
+      initialised. Plugins which do not use the eventUpdate
+      functions should override this to return
+      EventSubscription::NO_EVENTS, so that they are not called at
+      all.
+     */
+    virtual EventSubscription getEventSubscription() const { return EventSubscription(); }
   
     virtual void output(magnet::xml::XmlStream&);
   
@@ -64,6 +160,17 @@ namespace dynamo {
     virtual void replicaExchange(OutputPlugin&) = 0;
   
     virtual void temperatureRescale(const double&) {}
+
+    /*! \brief Returns the bytes of memory held by the data
+        collected by this plugin.
+
+	Plugins which collect per-particle data or long histories
+	(e.g., correlators) should override this.
+     */
+    virtual size_t getMemoryUsage() const { return 0; }
+
+    //! \brief The name of the plugin.
+    const std::string& getPluginName() const { return _name; }
   
   protected:
     std::ostream& I_Pcout() const;
@@ -75,5 +182,8 @@ namespace dynamo {
     //
     // Lets other plugins take data from plugins before/after they are updated
     unsigned char updateOrder;
+
+  private:
+    std::string _name;
   };
 }
@@ -35,6 +35,8 @@ namespace dynamo {
 
     void eventUpdate(const System&, const NEventData&, const double&) {}
 
+    virtual EventSubscription getEventSubscription() const { return EventSubscription::NO_EVENTS; }
+
     virtual void initialise() { addPoint(); }
 
     virtual void output(magnet::xml::XmlStream&);
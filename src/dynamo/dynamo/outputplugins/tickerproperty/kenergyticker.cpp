@@ -54,7 +54,7 @@ namespace dynamo {
       for (size_t iDim = 0; iDim < NDIM; ++iDim)
 	for (size_t jDim = 0; jDim < NDIM; ++jDim)
 	  localE[iDim][jDim] += part.getVelocity()[iDim] * part.getVelocity()[jDim]
-	    * Sim->species[part]->getMass(part.getID());
+	    * Sim->species.getMass(part);
 
     //Try and stop round off error this way
     for (size_t iDim = 0; iDim < NDIM; ++iDim)
@@ -96,7 +96,7 @@ namespace dynamo {
 
 	for (const size_t& ID : *range)
 	  {
-	    double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	    double mass = Sim->species.getMass(Sim->particles[ID]);
 	    molCOM += posHistory[ID][0] * mass;
 	    molMass += mass;
 	  }
@@ -109,7 +109,7 @@ namespace dynamo {
 	  
 	    for (const size_t& ID : *range)
 	      molCOM2 += posHistory[ID][step] 
-	      * Sim->species[Sim->particles[ID]]->getMass(ID);
+	      * Sim->species.getMass(Sim->particles[ID]);
 	  
 	    molCOM2 /= molMass;
 	  
@@ -112,7 +112,7 @@ namespace dynamo {
 	  
 	    sumrij += rij;
 	  
-	    double pmass = Sim->species[part]->getMass(pid);
+	    double pmass = Sim->species.getMass(part);
 	    sysMass += pmass;
 	    masspos += sumrij * pmass;
 	  
@@ -37,6 +37,8 @@ namespace dynamo {
     void eventUpdate(const LocalEvent&, const NEventData&) {}
     void eventUpdate(const System&, const NEventData&, const double&) {}
 
+    virtual EventSubscription getEventSubscription() const { return EventSubscription::NO_EVENTS; }
+
     virtual void output(magnet::xml::XmlStream&) {}
 
     virtual void ticker() = 0;
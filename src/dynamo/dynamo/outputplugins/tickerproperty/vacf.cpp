@@ -91,7 +91,7 @@ namespace dynamo {
 	  
 	  for (const size_t& ID : *range)
 	    {
-	      double mass = Sim->species[Sim->particles[ID]]->getMass(ID);
+	      double mass = Sim->species.getMass(Sim->particles[ID]);
 	      COMvelocity += velHistory[ID][0] * mass;
 	      molMass += mass;
 	    }
@@ -103,7 +103,7 @@ namespace dynamo {
 	      Vector COMvelocity2(0,0,0);
 	      
 	      for (const size_t& ID : *range)
-		COMvelocity2 += velHistory[ID][step] * Sim->species[Sim->particles[ID]]->getMass(ID);
+		COMvelocity2 += velHistory[ID][step] * Sim->species.getMass(Sim->particles[ID]);
 	      COMvelocity2 /= molMass;
 	      structData[topo->getID()][step] += COMvelocity | COMvelocity2;
 	    }
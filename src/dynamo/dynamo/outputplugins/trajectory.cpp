@@ -125,7 +125,7 @@ namespace dynamo {
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
 	logfile << "    1PEvent p1 " << part.getID();
-	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
+	Vector delP = Sim->species.getMass(part) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();
 	Vector oldv = pData.getOldVel() / Sim->units.unitVelocity();
@@ -159,7 +159,7 @@ namespace dynamo {
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
 	logfile << "    1PEvent p1 " << part.getID();
-	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
+	Vector delP = Sim->species.getMass(part) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();
 	Vector oldv = pData.getOldVel() / Sim->units.unitVelocity();
@@ -193,7 +193,7 @@ namespace dynamo {
       {
 	const Particle& part = Sim->particles[pData.getParticleID()];
 	logfile << "    1PEvent p1 " << part.getID();
-	Vector delP = Sim->species[pData.getSpeciesID()]->getMass(part.getID()) * (part.getVelocity() - pData.getOldVel());
+	Vector delP = Sim->species.getMass(part) * (part.getVelocity() - pData.getOldVel());
 	delP /= Sim->units.unitMomentum();
 	Vector pos = part.getPosition() / Sim->units.unitLength();	
 	Vector oldv = pData.getOldVel() / Sim->units.unitVelocity();
@@ -121,6 +121,13 @@ namespace dynamo {
     //! \param nState The State flag to clear.
     inline void clearState(State nState) { _state &= (~nState); }  
 
+    //! \brief Returns all of the State flags of the Particle combined.
+    inline int getStates() const { return _state; }
+
+    //! \brief Replaces all of the State flags of the Particle.
+    //! \param nStates The combined State flags (see getStates()).
+    inline void setStates(int nStates) { _state = nStates; }
+
   private:
     Vector _pos;
     Vector _vel;
@@ -18,6 +18,7 @@
 #include <magnet/exception.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/xmlstreamreader.hpp>
 #include <magnet/units.hpp>
 #include <vector>
 #include <string>
@@ -72,6 +73,9 @@ namespace dynamo {
     //! Fetch the units of this property
     inline const Units& getUnits() const { return _units; }
 
+    //! The bytes of memory held by the values of this property
+    inline virtual size_t getMemoryUsage() const { return 0; }
+
     //! Helper to write out derived classes
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const Property& prop)
     { prop.outputXML(XML); return XML; }
@@ -152,16 +156,17 @@ namespace dynamo {
       Property(units), _name(name),
       _values(N, initalval) {}
   
-    inline ParticleProperty(const magnet::xml::Node& node):
+    /*! \brief Load the property from its XML tag and the
+        attributes of the particle records.
+     
+      \param node The Property tag of this property.
+      \param particles The attributes of the Pt tags in the ParticleData.
+     */
+    inline ParticleProperty(const magnet::xml::Node& node, const magnet::xml::RecordTable& particles):
       Property(Property::Units(node.getAttribute("Units").getValue())),
-      _name(node.getAttribute("Name").getValue())
-    {
-      //Move up to the particles nodes, and start loading the property values
-      for (magnet::xml::Node pNode = node.getParent().getParent()
-	     .getNode("ParticleData").fastGetNode("Pt");
-	   pNode.valid(); ++pNode)
-	_values.push_back(pNode.getAttribute(_name).as<double>());
-    }
+      _name(node.getAttribute("Name").getValue()),
+      _values(particles.getColumn(_name))
+    {}
   
     inline virtual const double& getProperty(size_t ID) const 
     { 
@@ -190,6 +195,9 @@ namespace dynamo {
 
     inline virtual const double& getMinValue() const 
     { return *std::min_element(_values.begin(), _values.end()); }
+
+    inline virtual size_t getMemoryUsage() const 
+    { return _values.capacity() * sizeof(double); }
   
     //! \sa Property::rescaleUnit
     inline virtual const void rescaleUnit(const Units::Dimension dim, 
@@ -293,20 +301,19 @@ namespace dynamo {
 
     /*! \brief Method which loads the properties from the XML configuration file.
       \param node A xml Node at the root dynamoconfig Node of the config file.
+      \param particles The attributes of the Pt tags in the ParticleData.
     */
-    inline PropertyStore& operator<<(const magnet::xml::Node& node)
+    inline void load(const magnet::xml::Node& node, const magnet::xml::RecordTable& particles)
     {
       if (node.hasNode("Properties"))
 	for (magnet::xml::Node propNode = node.getNode("Properties").fastGetNode("Property");
 	     propNode.valid(); ++propNode)
 	  {
 	    if (!std::string("PerParticle").compare(propNode.getAttribute("Type")))
-	      _namedProperties.push_back(Value(new ParticleProperty(propNode)));
+	      _namedProperties.push_back(Value(new ParticleProperty(propNode, particles)));
 	    else
 	      M_throw() << "Unsupported Property type, " << propNode.getAttribute("Type").getValue();
 	  }
-    
-      return *this;
     }
 
     inline friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const PropertyStore& propStore)
@@ -335,6 +342,10 @@ namespace dynamo {
 	property->rescaleUnit(dim, rescale);
     }
 
+    //! \brief Iterators over the per-particle (named) Property-s.
+    inline const_iterator begin() const { return _namedProperties.begin(); }
+    inline const_iterator end() const { return _namedProperties.end(); }
+
     /*! \brief Write any XML attributes relevent to Property-s for a
       single particle.
     
@@ -0,0 +1,113 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/math/philox.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <cstdint>
+
+namespace dynamo {
+  /*! \brief A family of independent, counter-based random number
+    streams.
+
+    Unlike the Simulation::ranGenerator, which has a single sequence
+    that must be shared by everything that draws from it, the
+    generators handed out by this class are pure functions of the
+    family key and the ID numbers of the stream. Any number of
+    threads may create and draw from streams at once, and a stream
+    gives the same numbers whatever order the work is done in.
+
+    There are three ways to obtain random numbers:
+
+    - getStream() returns the stream identified by one or two ID
+      numbers, e.g., a particle ID and the event count. These are
+      used when the random numbers are naturally keyed by the work.
+
+    - split() creates a child family, e.g., for each System or each
+      replica (keyed by the Simulation::simID), so that the streams
+      of independent parts of the code never overlap.
+
+    - next() returns a fresh child family each time it is called,
+      e.g., once per step of a System. The counter of these calls is
+      saved with the key in the configuration file, so a run
+      continued from its output configuration never reuses streams.
+
+    The generators are magnet::math::Philox4x32 instances, which
+    may be used with the standard distributions.
+   */
+  class RandomStreams
+  {
+  public:
+    typedef magnet::math::Philox4x32 Generator;
+
+    RandomStreams(uint64_t key = 0, uint64_t counter = 0):
+      _key(key), _counter(counter) {}
+
+    //! \brief Reset the family to a new key.
+    void seed(uint64_t key) { _key = key; _counter = 0; }
+
+    uint64_t getKey() const { return _key; }
+
+    uint64_t getCounter() const { return _counter; }
+
+    /*! \brief The stream identified by the passed ID numbers.
+      \param id1 The first ID of the stream, e.g., a particle ID.
+      \param id2 The second ID of the stream, e.g., an event count.
+     */
+    Generator getStream(uint64_t id1, uint64_t id2 = 0) const
+    { return Generator(mix(id1, 0), id2); }
+
+    //! \brief A child family identified by the passed ID number.
+    RandomStreams split(uint64_t id) const
+    { return RandomStreams(mix(id, 1)); }
+
+    //! \brief A new child family, distinct from all previous calls.
+    RandomStreams next()
+    { return RandomStreams(mix(_counter++, 2)); }
+
+    //! \brief Load the state of the family from a RandomStreams tag.
+    void operator<<(const magnet::xml::Node& XML)
+    {
+      _key = XML.getAttribute("Key").as<uint64_t>();
+      _counter = XML.getAttribute("Counter").as<uint64_t>();
+    }
+
+    friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const RandomStreams& streams)
+    {
+      XML << magnet::xml::tag("RandomStreams")
+	  << magnet::xml::attr("Key") << streams._key
+	  << magnet::xml::attr("Counter") << streams._counter
+	  << magnet::xml::endtag("RandomStreams");
+      return XML;
+    }
+
+  private:
+    /*! \brief Hash an ID number into a new key, using the Philox
+      bijection under the family key. The domain separates the keys
+      used by the different methods.
+     */
+    uint64_t mix(uint64_t id, uint64_t domain) const
+    {
+      const Generator::Block block = Generator::generate(_key, domain, id);
+      return (uint64_t(block[1]) << 32) | block[0];
+    }
+
+    uint64_t _key;
+    uint64_t _counter;
+  };
+}
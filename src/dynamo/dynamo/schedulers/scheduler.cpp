@@ -31,6 +31,7 @@
 #endif
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <magnet/memUsage.hpp>
 
 namespace dynamo {
   Scheduler::Scheduler(dynamo::Simulation* const tmp, const char * aName,
@@ -90,6 +91,7 @@ namespace dynamo {
     sorter->resize(Sim->N+1);
     eventCount.clear();
     eventCount.resize(Sim->N+1, 0);
+    _neighbourBatches.resize(Sim->interactions.size());
 
     for (Particle& part : Sim->particles)
       addEvents(part);
@@ -116,10 +118,29 @@ namespace dynamo {
     for (const size_t id2 : *ids)
       addLocalEvent(part, id2);
 
-    //Now add the interaction events
+    //Now add the interaction events. The neighbours are brought up
+    //to date and sorted by Interaction, so that each Interaction can
+    //test its part of the neighbourhood as a single batch.
+    for (std::vector<size_t>& batch : _neighbourBatches)
+      batch.clear();
+
     ids = getParticleNeighbours(part);
     for (const size_t id2 : *ids)
-      addInteractionEvent(part, id2);
+      {
+	if (id2 == part.getID()) continue;
+	Particle& part2(Sim->particles[id2]);
+	Sim->dynamics->updateParticle(part2);
+	_neighbourBatches[Sim->getInteraction(part, part2)->getID()].push_back(id2);
+      }
+
+    for (size_t intID(0); intID < _neighbourBatches.size(); ++intID)
+      if (!_neighbourBatches[intID].empty())
+	{
+	  _batchEvents.clear();
+	  Sim->interactions[intID]->getEvents(part, _neighbourBatches[intID], _batchEvents);
+	  for (const IntEvent& event : _batchEvents)
+	    sorter->push(Event(event, eventCount[event.getParticle2ID()]), part.getID());
+	}
   }
 
   shared_ptr<Scheduler>
@@ -154,6 +175,18 @@ namespace dynamo {
     sorter->update(Sim->N);
   }
 
+  size_t
+  Scheduler::getMemoryUsage() const
+  {
+    size_t bytes = magnet::container_mem_usage(eventCount) + magnet::container_mem_usage(_batchEvents)
+      + magnet::container_mem_usage(_neighbourBatches);
+    for (const std::vector<size_t>& batch : _neighbourBatches)
+      bytes += magnet::container_mem_usage(batch);
+
+    if (sorter) bytes += sorter->getMemoryUsage();
+    return bytes;
+  }
+
   void Scheduler::popNextEvent() { sorter->popNextEvent(); }
 
   void 
@@ -429,7 +462,8 @@ namespace dynamo {
   Scheduler::lazyDeletionCleanup()
   {
     std::pair<size_t, Event> next_event = sorter->next();
-    while ((next_event.second.type == INTERACTION) && (next_event.second.collCounter2 != eventCount[next_event.second.particle2ID]))
+    while (((next_event.second.type == INTERACTION) && (next_event.second.collCounter2 != eventCount[next_event.second.particle2ID]))
+	   || ((next_event.second.type == GLOBAL) && (next_event.second.collCounter2 != Sim->globals[next_event.second.globalID]->getEventGeneration())))
       {
 	//Not valid, update the list
 	sorter->popNextEvent();
@@ -108,13 +108,19 @@ namespace dynamo {
     
     const std::vector<size_t>& getEventCounts() const { return eventCount; }
 
+    /*! \brief The bytes of memory held by the Scheduler, including
+        the event lists of its sorter. */
+    size_t getMemoryUsage() const;
+
   protected:
     /*! \brief Performs the lazy deletion algorithm to find the next
       valid event in the queue.
      
       This is the lazy deletion scheme for interaction events. Any
       event whose event counter mismatches the particles current event
-      counter is out of date and should be deleted.
+      counter is out of date and should be deleted. Global events are
+      deleted in the same way once their Global has moved on to a new
+      event generation (see Global::getEventGeneration()).
      */
     void lazyDeletionCleanup();
 
@@ -124,6 +130,16 @@ namespace dynamo {
     size_t _interactionRejectionCounter;
     size_t _localRejectionCounter;
 
+    /*! \brief Scratch space for the batched event prediction in
+        addEvents. 
+
+	The neighbours of a particle are sorted into a list for each
+	Interaction, and each Interaction then calculates the events
+	of its list in a single call to Interaction::getEvents.
+     */
+    std::vector<std::vector<size_t> > _neighbourBatches;
+    std::vector<IntEvent> _batchEvents;
+
     virtual void outputXML(magnet::xml::XmlStream&) const = 0;
   };
 }
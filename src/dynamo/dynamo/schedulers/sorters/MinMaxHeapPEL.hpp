@@ -84,6 +84,9 @@ namespace dynamo {
     inline void swap(PELMinMax& rhs) {
       Base::swap(rhs);
     }
+
+    //! \brief The events are stored in place, so the PEL holds no heap memory.
+    inline size_t getMemoryUsage() const { return 0; }
   };
 }
 
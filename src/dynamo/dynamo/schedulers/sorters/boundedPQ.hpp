@@ -22,6 +22,7 @@
 #include <dynamo/units/units.hpp>
 #include <dynamo/simulation.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/memUsage.hpp>
 #include <string>
 #include <vector>
 #include <cmath>
@@ -269,6 +270,15 @@ namespace dynamo {
 
     }
 
+    size_t getMemoryUsage() const
+    {
+      size_t bytes = magnet::container_mem_usage(linearLists) + magnet::container_mem_usage(CBT) 
+	+ magnet::container_mem_usage(Leaf) + magnet::container_mem_usage(Min);
+      for (const eventQEntry& dat : Min)
+	bytes += dat.data.getMemoryUsage();
+      return bytes;
+    }
+
   private:
     ///////////////////////////BOUNDED QUEUE IMPLEMENTATION
     inline void insertInEventQ(int p)
@@ -20,6 +20,7 @@
 #include <dynamo/schedulers/sorters/heapPEL.hpp>
 #include <dynamo/schedulers/sorters/sorter.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/memUsage.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <vector>
 #include <cmath>
@@ -115,6 +116,15 @@ namespace dynamo {
       pecTime *= factor;
     }
 
+    size_t getMemoryUsage() const
+    {
+      size_t bytes = magnet::container_mem_usage(CBT) + magnet::container_mem_usage(Leaf) 
+	+ magnet::container_mem_usage(Min);
+      for (const PELHeap& pDat : Min)
+	bytes += pDat.getMemoryUsage();
+      return bytes;
+    }
+
     inline void sort() {}
 
   private:
@@ -67,6 +67,7 @@ namespace dynamo {
 
     inline Event(const GlobalEvent& coll) throw():
       dt(coll.getdt()),
+      collCounter2(coll.getGeneration()),
       type(GLOBAL)
     {
       globalID = coll.getGlobalID();
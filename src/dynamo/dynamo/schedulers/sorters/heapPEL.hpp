@@ -56,6 +56,11 @@ namespace dynamo {
     inline void swap(PELHeap& rhs) {
       std::swap(c, rhs.c);
     }
+
+    //! \brief The bytes of heap memory held by the PEL.
+    inline size_t getMemoryUsage() const {
+      return c.capacity() * sizeof(Event);
+    }
   };
 }
 
@@ -74,6 +74,9 @@ namespace dynamo {
 
     inline void swap(PELSingleEvent& rhs)
     { std::swap(_event, rhs._event); }
+
+    //! \brief The PEL holds no heap memory.
+    inline size_t getMemoryUsage() const { return 0; }
   };
 }
 
@@ -50,6 +50,9 @@ namespace dynamo {
     virtual void   popNextPELEvent(const size_t&) = 0;
     virtual void   popNextEvent() = 0;
 
+    //! \brief The bytes of memory held by the event lists.
+    virtual size_t getMemoryUsage() const = 0;
+
     static shared_ptr<FEL> getClass(const magnet::xml::Node&);
 
     friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const FEL&);
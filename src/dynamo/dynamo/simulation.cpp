@@ -34,9 +34,10 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/chain.hpp>
-#include <boost/iostreams/device/back_inserter.hpp>
-#include <boost/iostreams/copy.hpp>
 #include <dynamo/BC/BC.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/stream/parallelbzip2.hpp>
+#include <magnet/memUsage.hpp>
 #include <iomanip>
 
 //! The configuration file version, a version mismatch prevents an XML file load.
@@ -54,6 +55,8 @@ namespace dynamo
     N(0),
     primaryCellSize(1,1,1),
     ranGenerator(std::random_device()()),
+    randomStreams((uint64_t(std::random_device()()) << 32) | std::random_device()()),
+    threads(NULL),
     lastRunMFT(0.0),
     simID(0),
     replexExchangeNumber(0),
@@ -101,20 +104,9 @@ namespace dynamo
     for (shared_ptr<Species>& ptr : species)
       ptr->initialise();
 
-    unsigned int count = 0;
-    //Now confirm that every species has only one species type!
-    for (const Particle& part : particles)
-      {
-	for (shared_ptr<Species>& ptr : species)
-	  if (ptr->isSpecies(part)) { count++; break; }
-	
-	if (count < 1)
-	  M_throw() << "Particle ID=" << part.getID() << " has no species";
-	
-	if (count > 1)
-	  M_throw() << "Particle ID=" << part.getID() << " has more than one species";
-	count = 0;
-      }
+    //Build the species tables, this also confirms that every
+    //particle has exactly one species
+    species.updateTables(N);
     
     //Now confirm that there are not more counts from each species
     //than there are particles
@@ -215,6 +207,8 @@ namespace dynamo
     for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
       Ptr->initialise();
 
+    outputPluginBus.build(this);
+
     _nextPrint = eventCount + eventPrintInterval;
     status = INITIALISED;
   }
@@ -262,8 +256,52 @@ namespace dynamo
     M_throw() << "Could not find an Interaction between particles " << p1.getID() << " and " << p2.getID() << ". All particle pairings must have a corresponding Interaction defined.";
   }
 
+  void
+  Simulation::SpeciesContainer::updateTables(size_t N)
+  {
+    const unsigned int noSpecies = std::numeric_limits<unsigned int>::max();
+    std::vector<unsigned int> speciesIDs(N, noSpecies);
+
+    for (size_t i(0); i < size(); ++i)
+      for (const size_t& ID : *Base::operator[](i)->getRange())
+	{
+	  if (ID >= N)
+	    M_throw() << "Species \"" << Base::operator[](i)->getName() 
+		      << "\" contains the particle ID=" << ID << " but there are only " << N << " particles";
+
+	  if (speciesIDs[ID] != noSpecies)
+	    M_throw() << "Particle ID=" << ID << " has more than one species";
+
+	  speciesIDs[ID] = i;
+	}
+
+    for (size_t ID(0); ID < N; ++ID)
+      if (speciesIDs[ID] == noSpecies)
+	M_throw() << "Particle ID=" << ID << " has no species";
+
+    _speciesIDs.swap(speciesIDs);
+    updateMasses();
+  }
+
+  void
+  Simulation::SpeciesContainer::updateMasses()
+  {
+    _mass.resize(_speciesIDs.size());
+    _invMass.resize(_speciesIDs.size());
+
+    for (size_t ID(0); ID < _speciesIDs.size(); ++ID)
+      {
+	_mass[ID] = Base::operator[](_speciesIDs[ID])->getMass(ID);
+	_invMass[ID] = 1.0 / _mass[ID];
+      }
+  }
+
+  double
+  Simulation::SpeciesContainer::findMass(const Particle& p1) const
+  { return findSpecies(p1)->getMass(p1.getID()); }
+
   const shared_ptr<Species>& 
-  Simulation::SpeciesContainer::operator[](const Particle& p1) const 
+  Simulation::SpeciesContainer::findSpecies(const Particle& p1) const 
   {
     for (const shared_ptr<Species>& ptr : *this)
       if (ptr->isSpecies(p1)) return ptr;
@@ -298,18 +336,18 @@ namespace dynamo
       M_throw() << "Loading config at wrong time, status = " << status;
 
     using namespace magnet::xml;
-    Document doc;
+    StreamingDocument doc;
     
     namespace io = boost::iostreams;
     
-    dout << "Reading the XML input file, " << fileName << ", into memory" << std::endl;
+    dout << "Reading the XML input file, " << fileName << std::endl;
     if (!boost::filesystem::exists(fileName))
       M_throw() << "Could not find the XML file named " << fileName
 		<< "\nPlease check the file exists.";
     { //This scopes out the file objects
       
-      //We use the boost iostreams library to load the file into a
-      //string which may be compressed.
+      //We use the boost iostreams library to read the file, which
+      //may be compressed.
       
       //We make our filtering iostream
       io::filtering_istream inputFile;
@@ -322,18 +360,21 @@ namespace dynamo
 
       //Finally, add the file as a source
       inputFile.push(io::file_source(fileName));
-	  
-      io::copy(inputFile, io::back_inserter(doc.getStoredXMLData()));
-    }
 
-    dout << "Parsing the XML" << std::endl;
-    try {
-      doc.parseData();
-    } catch (std::exception& cep)
-      {
-	derr << "Failed to parse the XML" << std::endl;
-	throw;
-      }
+      //The particle data is parsed on the threads of the
+      //Simulation as the file is decompressed, the rest of the file
+      //is parsed as a normal document. An empty pool parses the
+      //particles on this thread.
+      magnet::thread::ThreadPool serial;
+
+      try {
+	doc.load(inputFile, "ParticleData", "Pt", threads ? *threads : serial);
+      } catch (std::exception& cep)
+	{
+	  derr << "Failed to parse the XML" << std::endl;
+	  throw;
+	}
+    }
 
     dout << "Loading tags from the XML" << std::endl;
     Node mainNode = doc.getNode("DynamOconfig");
@@ -356,7 +397,7 @@ namespace dynamo
     } catch (std::exception&)
       {}
 
-    _properties << mainNode;
+    _properties.load(mainNode, doc.getRecords());
 
     //Load the Primary cell's size
     primaryCellSize << simNode.getNode("SimulationSize");
@@ -373,6 +414,9 @@ namespace dynamo
 
     dynamics = Dynamics::getClass(simNode.getNode("Dynamics"), this);
 
+    if (simNode.hasNode("RandomStreams"))
+      randomStreams << simNode.getNode("RandomStreams");
+
     if (simNode.hasNode("Topology"))
       {
 	size_t i(0);
@@ -411,7 +455,7 @@ namespace dynamo
 
     ptrScheduler = Scheduler::getClass(simNode.getNode("Scheduler"), this);
 
-    dynamics->loadParticleXMLData(mainNode);
+    dynamics->loadParticleXMLData(mainNode, doc.getRecords());
   
     //Fixes or conversions once system is loaded
     lastRunMFT *= units.unitTime();
@@ -434,11 +478,16 @@ namespace dynamo
     if (status < INITIALISED || status == ERROR)
       M_throw() << "Cannot write out configuration in this state";
   
+    //The particle data is formatted and compressed on the threads
+    //of the Simulation, or on this thread if it has none
+    magnet::thread::ThreadPool serial;
+    magnet::thread::ThreadPool& pool = threads ? *threads : serial;
+
     namespace io = boost::iostreams;
     io::filtering_ostream coutputFile;
 
     if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
+      coutputFile.push(magnet::stream::ParallelBzip2Compressor(pool));
   
     coutputFile.push(io::file_sink(fileName));
   
@@ -530,10 +579,11 @@ namespace dynamo
       	<< magnet::xml::tag("Dynamics")
 	<< dynamics
 	<< magnet::xml::endtag("Dynamics")
+	<< randomStreams
 	<< magnet::xml::endtag("Simulation")
 	<< _properties;
 
-    dynamics->outputParticleXMLData(XML, applyBC);
+    dynamics->outputParticleXMLData(XML, applyBC, pool);
 
     XML << magnet::xml::endtag("DynamOconfig");
 
@@ -548,6 +598,9 @@ namespace dynamo
 
     _properties.rescaleUnit(Property::Units::M, 
 			    units.unitMass());
+
+    //The rescaling may not exactly restore the masses
+    species.updateMasses();
   }
   
   void 
@@ -580,6 +633,9 @@ namespace dynamo
     other.ptrScheduler->rebuildSystemEvents();    
 
     //Globals?
+    outputPluginBus.synchronise();
+    other.outputPluginBus.synchronise();
+
 #ifdef DYNAMO_DEBUG
     if (outputPlugins.size() != other.outputPlugins.size())
       std::cerr << "Error, could not swap output plugin lists as they are not equal in size";
@@ -600,6 +656,28 @@ namespace dynamo
     ensemble->swap(*other.ensemble);
   }
 
+  void
+  Simulation::replexerSetTemperature(double kT)
+  {
+    EnsembleNVT* NVT = dynamic_cast<EnsembleNVT*>(ensemble.get());
+    if (!NVT)
+      M_throw() << "Cannot change the temperature of a replica without an NVT Ensemble";
+
+    dynamics->updateAllParticles();
+
+    const double scale(std::sqrt(kT / ensemble->getEnsembleVals()[2]));
+    for (Particle& part : particles)
+      part.getVelocity() *= scale;
+    ptrScheduler->rescaleTimes(1.0 / scale);
+
+    NVT->setTemperature(kT);
+    ptrScheduler->rebuildSystemEvents();
+
+    outputPluginBus.synchronise();
+    for (shared_ptr<OutputPlugin>& Ptr : outputPlugins)
+      Ptr->temperatureRescale(scale * scale);
+  }
+
   double
   Simulation::calcInternalEnergy() const
   {
@@ -623,7 +701,7 @@ namespace dynamo
       {
 	Vector  pos(Part.getPosition()), vel(Part.getVelocity());
 	BCs->applyBC(pos,vel);
-	double mass = species[Part]->getMass(Part.getID());
+	double mass = species.getMass(Part);
 	//Note we sum the negatives!
 	sumMV -= vel * mass;
 	sumMass += mass;
@@ -715,6 +793,7 @@ namespace dynamo
 	<< magnet::xml::prolog() << magnet::xml::tag("OutputData");
   
     //Output the data and delete the outputplugins
+    outputPluginBus.synchronise();
     for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
       Ptr->output(XML);
   
@@ -729,6 +808,56 @@ namespace dynamo
     dout << "Output written to " << filename << std::endl;
   }
 
+  std::vector<Simulation::MemoryUsage>
+  Simulation::getMemoryUsage() const
+  {
+    std::vector<MemoryUsage> usage;
+    usage.push_back(MemoryUsage("Particles", "Particles", magnet::container_mem_usage(particles)));
+
+    if (ptrScheduler)
+      usage.push_back(MemoryUsage("Scheduler", "Scheduler", ptrScheduler->getMemoryUsage()));
+
+    for (const shared_ptr<Global>& ptr : globals)
+      if (ptr->getMemoryUsage())
+	usage.push_back(MemoryUsage("Global", ptr->getName(), ptr->getMemoryUsage()));
+
+    for (const shared_ptr<Interaction>& ptr : interactions)
+      if (ptr->getMemoryUsage())
+	usage.push_back(MemoryUsage("Interaction", ptr->getName(), ptr->getMemoryUsage()));
+
+    for (const shared_ptr<OutputPlugin>& ptr : outputPlugins)
+      if (ptr->getMemoryUsage())
+	usage.push_back(MemoryUsage("OutputPlugin", ptr->getPluginName(), ptr->getMemoryUsage()));
+
+    for (const shared_ptr<Property>& ptr : _properties)
+      if (ptr->getMemoryUsage())
+	usage.push_back(MemoryUsage("Property", ptr->getName(), ptr->getMemoryUsage()));
+
+    return usage;
+  }
+
+  void
+  Simulation::outputMemoryUsage(std::ostream& os)
+  {
+    outputPluginBus.synchronise();
+    const std::vector<MemoryUsage> usage = getMemoryUsage();
+
+    size_t total(0);
+    os << "\nMemory usage of the simulation (KiB):";
+    for (const MemoryUsage& entry : usage)
+      {
+	os << "\n  " << std::setw(14) << std::left << entry._subsystem 
+	   << std::setw(24) << std::left << entry._name 
+	   << std::setw(12) << std::right << entry._bytes / 1024;
+	total += entry._bytes;
+      }
+    os << "\n  " << std::setw(38) << std::left << "Total accounted" 
+       << std::setw(12) << std::right << total / 1024
+       << "\n  " << std::setw(38) << std::left << "Peak process size" 
+       << std::setw(12) << std::right << magnet::process_mem_usage()
+       << std::endl;
+  }
+
   void 
   Simulation::setTickerPeriod(double nP)
   {
@@ -781,6 +910,7 @@ namespace dynamo
 	if ((eventCount >= _nextPrint) && !silentMode && outputPlugins.size())
 	  {
 	    //Print the screen data plugins
+	    outputPluginBus.synchronise();
 	    for (shared_ptr<OutputPlugin> & Ptr : outputPlugins)
 	      Ptr->periodicOutput();
 	    
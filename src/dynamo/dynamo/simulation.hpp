@@ -21,10 +21,14 @@
 #include <dynamo/ensemble.hpp>
 #include <dynamo/property.hpp>
 #include <dynamo/units/units.hpp>
+#include <dynamo/randomstreams.hpp>
+#include <dynamo/outputplugins/eventbus.hpp>
 #include <magnet/function/delegate.hpp>
 #include <random>
 #include <vector>
 
+namespace magnet { namespace thread { class ThreadPool; } }
+
 namespace dynamo
 {  
   class Scheduler;
@@ -108,13 +112,69 @@ namespace dynamo
     };
 
     /*! \brief A class which allows easy selection of Species.
+
+      Once the Simulation is initialised, the species ID, mass and
+      inverse mass of every particle are cached in dense arrays, so
+      that looking up the Species or mass of a Particle is O(1)
+      and does not require a virtual call. Before then, the lookups
+      fall back to searching the Species.
     */
     struct SpeciesContainer: public Container<Species>
     {
       typedef Container<Species> Base;
       using Base::operator[];
 
-      const shared_ptr<Species>& operator[](const Particle& p1) const;
+      inline const shared_ptr<Species>& operator[](const Particle& p1) const
+      {
+	if (p1.getID() < _speciesIDs.size())
+	  return Base::operator[](_speciesIDs[p1.getID()]);
+	return findSpecies(p1);
+      }
+
+      /*! \brief The mass of a Particle, in simulation units. */
+      inline double getMass(const Particle& p1) const
+      {
+	if (p1.getID() < _mass.size())
+	  return _mass[p1.getID()];
+	return findMass(p1);
+      }
+
+      /*! \brief The inverse mass of a Particle, in simulation units.
+       
+	This is zero for particles of infinite mass.
+       */
+      inline double getInvMass(const Particle& p1) const
+      {
+	if (p1.getID() < _invMass.size())
+	  return _invMass[p1.getID()];
+	return 1.0 / findMass(p1);
+      }
+
+      /*! \brief Rebuild the species ID tables and the mass cache.
+       
+	This also checks that every particle belongs to exactly one
+	Species.
+
+	\param N The number of particles in the Simulation.
+       */
+      void updateTables(size_t N);
+
+      /*! \brief Reload the mass cache from the mass Property of each
+	  Species.
+
+	This must be called whenever the mass properties are
+	rescaled.
+       */
+      void updateMasses();
+
+    private:
+      const shared_ptr<Species>& findSpecies(const Particle& p1) const;
+      double findMass(const Particle& p1) const;
+
+      //! The index of the Species of each particle.
+      std::vector<unsigned int> _speciesIDs;
+      std::vector<double> _mass;
+      std::vector<double> _invMass;
     };
 
   public:
@@ -220,6 +280,41 @@ namespace dynamo
     */
     void outputData(std::string filename = "output.xml.bz2");
 
+    /*! \brief The memory held by one of the data structures of the
+        Simulation.
+     */
+    struct MemoryUsage
+    {
+      MemoryUsage(std::string subsystem, std::string name, size_t bytes):
+	_subsystem(subsystem), _name(name), _bytes(bytes) {}
+
+      //! \brief The type of the owner (e.g., "Interaction").
+      std::string _subsystem;
+      //! \brief The name of the owner.
+      std::string _name;
+      size_t _bytes;
+    };
+
+    /*! \brief Returns the bytes of memory held by the major data
+        structures of the Simulation.
+
+      This accounts for the Particle data, the Scheduler and its
+      event lists, the neighbour lists and other Global's, the capture
+      maps of the Interaction's, the data collected by the
+      OutputPlugin's and the per-particle Property's. Only the owners
+      holding memory are listed. The estimates do not include the
+      overheads of the memory allocator.
+
+      Any analysis threads of the outputPluginBus must be
+      synchronised before this is called.
+     */
+    std::vector<MemoryUsage> getMemoryUsage() const;
+
+    /*! \brief Writes a table of the getMemoryUsage() of the
+        Simulation to the passed stream.
+     */
+    void outputMemoryUsage(std::ostream&);
+
     /*! \brief Loads a Simulation from the passed XML file.
 
       \param filename The path to the XML file to load. The filename
@@ -324,11 +419,35 @@ namespace dynamo
 
     /*! \brief The random number generator of the system. */
     mutable baseRNG ranGenerator;
+
+    /*! \brief The counter-based random number streams of the system.
+
+      These should be used instead of the ranGenerator by anything
+      drawing random numbers in parallel. The state is saved in the
+      configuration file.
+     */
+    RandomStreams randomStreams;
     
+    /*! \brief The ThreadPool of the Engine running this Simulation.
+
+      This is used to parse and write the particle data of the
+      configuration files, and by Systems which process their events
+      in parallel. If it is NULL, these run on the calling thread.
+     */
+    magnet::thread::ThreadPool* threads;
+
     /*! \brief The collection of OutputPlugin's operating on this system.
      */
     std::vector<shared_ptr<OutputPlugin> > outputPlugins; 
 
+    /*! \brief Passes the events of the system to the OutputPlugin's
+        which subscribe to them.
+
+      Every executed event must be passed to this, instead of to the
+      eventUpdate functions of the outputPlugins directly.
+     */
+    OPEventBus outputPluginBus;
+
     /*! \brief The mean free time of the previous simulation run
      
       This is zero in the case that there is no previous simulation
@@ -357,6 +476,15 @@ namespace dynamo
     Units units;    
 
     void replexerSwap(Simulation&);
+
+    /*! \brief Change the temperature of this replica (in simulation
+      units), rescaling the velocities of the particles.
+
+      This is used by replica exchange moves which exchange the
+      temperatures of the replicas instead of their
+      configurations. It requires an NVT Ensemble.
+     */
+    void replexerSetTemperature(double kT);
     
     /*! \brief Signal on particle changes.
       
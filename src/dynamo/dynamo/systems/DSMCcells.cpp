@@ -0,0 +1,349 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/systems/DSMCcells.hpp>
+#include <dynamo/units/units.hpp>
+#include <dynamo/BC/BC.hpp>
+#include <dynamo/particle.hpp>
+#include <dynamo/NparticleEventData.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <dynamo/dynamics/dynamics.hpp>
+#include <dynamo/schedulers/scheduler.hpp>
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
+
+namespace dynamo {
+  SysDSMCCells::SysDSMCCells(const magnet::xml::Node& XML, dynamo::Simulation* tmp):
+    System(tmp),
+    maxprob(0.0)
+  {
+    dt = HUGE_VAL;
+    operator<<(XML);
+    type = DSMC;
+  }
+
+  SysDSMCCells::SysDSMCCells(dynamo::Simulation* nSim, double nd, double ntstp, double nChi,
+			     double ne, double nCellWidth, std::string nName, IDRange* r1, IDRange* r2):
+    System(nSim),
+    tstep(ntstp),
+    chi(nChi),
+    diameter(nd),
+    maxprob(0.0),
+    e(ne),
+    cellWidth(nCellWidth),
+    range1(r1),
+    range2(r2)
+  {
+    sysName = nName;
+    type = DSMC;
+  }
+
+  void
+  SysDSMCCells::binParticles() const
+  {
+    const size_t nCells = _cellStart1.size() - 1;
+
+    std::fill(_cellStart1.begin(), _cellStart1.end(), 0);
+    std::fill(_cellStart2.begin(), _cellStart2.end(), 0);
+    std::vector<size_t> cellIDs(Sim->N, nCells);
+
+    for (Particle& part : Sim->particles)
+      {
+	const bool in1 = range1->isInRange(part), in2 = range2->isInRange(part);
+	if (!in1 && !in2) continue;
+
+	Sim->dynamics->updateParticle(part);
+	Vector pos = part.getPosition();
+	Sim->BCs->applyBC(pos);
+
+	size_t cell = 0;
+	for (size_t iDim(NDIM); iDim != 0; --iDim)
+	  {
+	    const long coord = std::floor((pos[iDim - 1] / Sim->primaryCellSize[iDim - 1] + 0.5)
+					  * _cellCount[iDim - 1]);
+	    cell = cell * _cellCount[iDim - 1]
+	      + std::min(size_t(std::max(coord, 0l)), _cellCount[iDim - 1] - 1);
+	  }
+
+	cellIDs[part.getID()] = cell;
+	if (in1) ++_cellStart1[cell + 1];
+	if (in2) ++_cellStart2[cell + 1];
+      }
+
+    //Convert the counts to offsets, then fill the cells in ID order
+    for (size_t cell(0); cell < nCells; ++cell)
+      {
+	_cellStart1[cell + 1] += _cellStart1[cell];
+	_cellStart2[cell + 1] += _cellStart2[cell];
+      }
+
+    _cellParticles1.resize(_cellStart1.back());
+    _cellParticles2.resize(_cellStart2.back());
+    std::vector<size_t> fill1(_cellStart1.begin(), _cellStart1.end() - 1);
+    std::vector<size_t> fill2(_cellStart2.begin(), _cellStart2.end() - 1);
+
+    for (const Particle& part : Sim->particles)
+      {
+	const size_t cell = cellIDs[part.getID()];
+	if (cell == nCells) continue;
+	if (range1->isInRange(part)) _cellParticles1[fill1[cell]++] = part.getID();
+	if (range2->isInRange(part)) _cellParticles2[fill2[cell]++] = part.getID();
+      }
+  }
+
+  void
+  SysDSMCCells::runCell(size_t cell, const RandomStreams& streams, CellResult& result) const
+  {
+    result.events.clear();
+    result.maxprob = maxprob;
+
+    const size_t n1 = _cellStart1[cell + 1] - _cellStart1[cell];
+    const size_t n2 = _cellStart2[cell + 1] - _cellStart2[cell];
+    if (!n1 || !n2) return;
+
+    const size_t* const cell1 = &_cellParticles1[_cellStart1[cell]];
+    const size_t* const cell2 = &_cellParticles2[_cellStart2[cell]];
+
+    RandomStreams::Generator generator = streams.getStream(cell);
+    std::normal_distribution<> norm_sampler;
+    std::uniform_real_distribution<> uniform_sampler;
+    std::uniform_int_distribution<size_t> id1sampler(0, n1 - 1);
+    std::uniform_int_distribution<size_t> id2sampler(0, n2 - 1);
+
+    //The collision factor of SysDSMCSpheres, using the local density
+    //of the possible partners
+    const double factor = 4.0 * diameter * M_PI * chi * tstep / _cellVolume;
+
+    double Event;
+    const double fracpart = std::modf(0.5 * maxprob * n1, &Event);
+    size_t nmax = static_cast<size_t>(Event);
+    if (uniform_sampler(generator) < fracpart)
+      ++nmax;
+
+    for (size_t n = 0; n < nmax; ++n)
+      {
+	Particle& p1(Sim->particles[cell1[id1sampler(generator)]]);
+
+	//A particle cannot collide with itself
+	const size_t partners = n2 - range2->isInRange(p1);
+	if (!partners) continue;
+
+	size_t p2id = cell2[id2sampler(generator)];
+	while (p2id == p1.getID())
+	  p2id = cell2[id2sampler(generator)];
+
+	Particle& p2(Sim->particles[p2id]);
+
+	Vector rij;
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  rij[iDim] = norm_sampler(generator);
+
+	rij *= diameter / rij.nrm();
+
+	const double prob = Sim->dynamics->DSMCSpheresProbability(p1, p2, factor * partners, rij);
+	if (prob < 0) continue;
+
+	if (prob > result.maxprob)
+	  result.maxprob = prob;
+
+	if (prob > uniform_sampler(generator) * result.maxprob)
+	  {
+	    Collision collision;
+	    collision.data = Sim->dynamics->DSMCSpheresRun(p1, p2, e, rij);
+	    collision.v1 = p1.getVelocity();
+	    collision.v2 = p2.getVelocity();
+	    result.events.push_back(collision);
+	  }
+      }
+  }
+
+  void
+  SysDSMCCells::runEvent() const
+  {
+    double locdt = dt;
+
+#ifdef DYNAMO_DEBUG
+    if (std::isnan(locdt))
+      M_throw() << "A NAN system event time has been found";
+#endif
+
+    Sim->systemTime += locdt;
+
+    Sim->ptrScheduler->stream(locdt);
+
+    //dynamics must be updated first
+    Sim->stream(locdt);
+
+    dt = tstep;
+
+    Sim->outputPluginBus.eventUpdate(*this, NEventData(), locdt);
+
+    binParticles();
+
+    //Each step takes a new family of streams, one for each cell
+    const RandomStreams streams = Sim->randomStreams.next().split(ID);
+
+    const auto runCells = [&](size_t begin, size_t end)
+      {
+	for (size_t cell(begin); cell < end; ++cell)
+	  runCell(cell, streams, _results[cell]);
+      };
+
+    if (Sim->threads)
+      Sim->threads->parallel_for(0, _results.size(), runCells);
+    else
+      runCells(0, _results.size());
+
+    //Now process the events in cell order. The particles of each
+    //event are returned to their state just after it, as the output
+    //plugins take the change in velocity from the particles.
+    std::vector<size_t> updated;
+    for (const CellResult& result : _results)
+      {
+	maxprob = std::max(maxprob, result.maxprob);
+
+	for (const Collision& collision : result.events)
+	  {
+	    const PairEventData& SDat = collision.data;
+	    Sim->particles[SDat.particle1_.getParticleID()].getVelocity() = collision.v1;
+	    Sim->particles[SDat.particle2_.getParticleID()].getVelocity() = collision.v2;
+
+	    ++Sim->eventCount;
+
+	    Sim->_sigParticleUpdate(SDat);
+
+	    Sim->outputPluginBus.eventUpdate(*this, SDat, 0.0);
+
+	    for (size_t ID : {SDat.particle1_.getParticleID(), SDat.particle2_.getParticleID()})
+	      if (!_updated[ID])
+		{
+		  _updated[ID] = true;
+		  updated.push_back(ID);
+		}
+	  }
+      }
+
+    //Each particle's events are only recalculated once
+    for (size_t ID : updated)
+      {
+	Sim->ptrScheduler->fullUpdate(Sim->particles[ID]);
+	_updated[ID] = false;
+      }
+  }
+
+  void
+  SysDSMCCells::initialise(size_t nID)
+  {
+    ID = nID;
+    dt = tstep;
+
+    _cellVolume = 1;
+    size_t nCells = 1;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	_cellCount[iDim] = std::max(size_t(Sim->primaryCellSize[iDim] / cellWidth), size_t(1));
+	_cellVolume *= Sim->primaryCellSize[iDim] / _cellCount[iDim];
+	nCells *= _cellCount[iDim];
+      }
+
+    _cellStart1.resize(nCells + 1);
+    _cellStart2.resize(nCells + 1);
+    _results.resize(nCells);
+    _updated.assign(Sim->N, false);
+
+    binParticles();
+
+    if (maxprob == 0.0)
+      {
+	std::normal_distribution<> norm_sampler;
+	std::uniform_int_distribution<size_t> cellsampler(0, nCells - 1);
+
+	//Just do some quick testing to get an estimate
+	for (size_t n = 0; n < 1000; ++n)
+	  {
+	    const size_t cell = cellsampler(Sim->ranGenerator);
+	    const size_t n1 = _cellStart1[cell + 1] - _cellStart1[cell];
+	    const size_t n2 = _cellStart2[cell + 1] - _cellStart2[cell];
+	    if (!n1 || (n2 < 2)) continue;
+
+	    std::uniform_int_distribution<size_t> id1sampler(0, n1 - 1);
+	    std::uniform_int_distribution<size_t> id2sampler(0, n2 - 1);
+
+	    Particle& p1(Sim->particles[_cellParticles1[_cellStart1[cell] + id1sampler(Sim->ranGenerator)]]);
+	    const size_t partners = n2 - range2->isInRange(p1);
+	    size_t p2id = _cellParticles2[_cellStart2[cell] + id2sampler(Sim->ranGenerator)];
+	    while (p2id == p1.getID())
+	      p2id = _cellParticles2[_cellStart2[cell] + id2sampler(Sim->ranGenerator)];
+	    Particle& p2(Sim->particles[p2id]);
+
+	    Vector rij;
+	    for (size_t iDim(0); iDim < NDIM; ++iDim)
+	      rij[iDim] = norm_sampler(Sim->ranGenerator);
+
+	    rij *= diameter / rij.nrm();
+
+	    const double factor = 4.0 * partners * diameter * M_PI * chi * tstep / _cellVolume;
+	    maxprob = std::max(maxprob, Sim->dynamics->DSMCSpheresProbability(p1, p2, factor, rij));
+	  }
+      }
+
+    dout << "MaxProbability is " << maxprob
+	 << "\nNpairs per step is " << 0.5 * range1->size() * maxprob << std::endl;
+
+    dout << "Cells " << _cellCount[0] << "x" << _cellCount[1] << "x" << _cellCount[2]
+	 << ", average particles per cell " << double(range1->size()) / nCells << std::endl;
+
+    if (double(range1->size()) / nCells < 2.0)
+      derr << "There are less than two particles per cell on average" << std::endl;
+  }
+
+  void
+  SysDSMCCells::operator<<(const magnet::xml::Node& XML)
+  {
+    tstep = XML.getAttribute("tStep").as<double>() * Sim->units.unitTime();
+    chi = XML.getAttribute("Chi").as<double>();
+    sysName = XML.getAttribute("Name");
+    diameter = XML.getAttribute("Diameter").as<double>() * Sim->units.unitLength();
+    e = XML.getAttribute("Inelasticity").as<double>();
+    cellWidth = XML.getAttribute("CellWidth").as<double>() * Sim->units.unitLength();
+    magnet::xml::Node subRangeXML = XML.getNode("IDRange");
+    range1 = shared_ptr<IDRange>(IDRange::getClass(subRangeXML, Sim));
+    ++subRangeXML;
+    range2 = shared_ptr<IDRange>(IDRange::getClass(subRangeXML, Sim));
+    if (XML.hasAttribute("MaxProbability"))
+      maxprob = XML.getAttribute("MaxProbability").as<double>();
+  }
+
+  void
+  SysDSMCCells::outputXML(magnet::xml::XmlStream& XML) const
+  {
+    XML << magnet::xml::tag("System")
+	<< magnet::xml::attr("Type") << "DSMCCells"
+	<< magnet::xml::attr("tStep") << tstep / Sim->units.unitTime()
+	<< magnet::xml::attr("Chi") << chi
+	<< magnet::xml::attr("Diameter") << diameter / Sim->units.unitLength()
+	<< magnet::xml::attr("Inelasticity") << e
+	<< magnet::xml::attr("CellWidth") << cellWidth / Sim->units.unitLength()
+	<< magnet::xml::attr("Name") << sysName
+	<< magnet::xml::attr("MaxProbability") << maxprob
+	<< range1
+	<< range2
+	<< magnet::xml::endtag("System");
+  }
+}
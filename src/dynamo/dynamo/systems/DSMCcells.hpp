@@ -0,0 +1,102 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/systems/system.hpp>
+#include <dynamo/simulation.hpp>
+#include <dynamo/ranges/IDRange.hpp>
+#include <dynamo/2particleEventData.hpp>
+#include <vector>
+
+namespace dynamo {
+  /*! \brief A cell based form of the ESMC (Enskog DSMC) collisions
+    of SysDSMCSpheres.
+
+    Every tStep the particles are sorted into a grid of cells, and
+    the No Time Counter scheme is applied within each cell: pairs of
+    candidate particles are only drawn from the same cell, using the
+    local number density of the second range in the collision
+    factor. This keeps collisions local in space, and as the cells
+    are independent they are processed in parallel on the threads of
+    the Simulation (Simulation::threads).
+
+    Each cell draws its random numbers from its own counter-based
+    stream, taken from a new family of the Simulation::randomStreams
+    each step. The collisions therefore do not depend on the number
+    of threads or the order the cells are processed in. The collision
+    events are passed to the output plugins and scheduler in cell
+    order once all the cells are done.
+   */
+  class SysDSMCCells: public System
+  {
+  public:
+    SysDSMCCells(const magnet::xml::Node& XML, dynamo::Simulation*);
+
+    SysDSMCCells(dynamo::Simulation*, double diameter, double tstep, double chi, double e,
+		 double cellWidth, std::string name, IDRange*, IDRange*);
+
+    virtual void runEvent() const;
+
+    virtual void initialise(size_t);
+
+    virtual void operator<<(const magnet::xml::Node&);
+
+  protected:
+    virtual void outputXML(magnet::xml::XmlStream&) const;
+
+    //! \brief A collision and the velocities of the particles after it.
+    struct Collision
+    {
+      PairEventData data;
+      Vector v1, v2;
+    };
+
+    //! \brief The collisions and maximum probability found in a cell.
+    struct CellResult
+    {
+      std::vector<Collision> events;
+      double maxprob;
+    };
+
+    //! \brief Sort the particles of the ranges into the cells.
+    void binParticles() const;
+
+    //! \brief Perform the collisions of a single cell.
+    void runCell(size_t cell, const RandomStreams& streams, CellResult& result) const;
+
+    double tstep;
+    double chi;
+    double diameter;
+    mutable double maxprob;
+    double e;
+    double cellWidth;
+
+    shared_ptr<IDRange> range1;
+    shared_ptr<IDRange> range2;
+
+    size_t _cellCount[NDIM];
+    double _cellVolume;
+
+    //! \brief Particle IDs of the ranges sorted by cell, with the
+    //! offset of each cell's particles.
+    mutable std::vector<size_t> _cellStart1, _cellParticles1;
+    mutable std::vector<size_t> _cellStart2, _cellParticles2;
+
+    mutable std::vector<CellResult> _results;
+    mutable std::vector<char> _updated;
+  };
+}
@@ -85,8 +85,7 @@ namespace dynamo {
  
     size_t nmax = static_cast<size_t>(Event);
   
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, NEventData(), locdt);
+    Sim->outputPluginBus.eventUpdate(*this, NEventData(), locdt);
 
     if (uniform_sampler(Sim->ranGenerator) < fracpart)
       ++nmax;
@@ -122,8 +121,7 @@ namespace dynamo {
   
 	    Sim->ptrScheduler->fullUpdate(p1, p2);
 	  
-	    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-	      Ptr->eventUpdate(*this, SDat, 0.0);
+	    Sim->outputPluginBus.eventUpdate(*this, SDat, 0.0);
 	  }
       }
 
@@ -106,8 +106,7 @@ namespace dynamo {
 
     Sim->ptrScheduler->fullUpdate(part);
   
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt);
+    Sim->outputPluginBus.eventUpdate(*this, SDat, locdt);
   }
 
   void 
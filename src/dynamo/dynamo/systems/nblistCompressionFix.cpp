@@ -85,11 +85,13 @@ namespace dynamo {
     GNeighbourList& nblist(dynamic_cast<GNeighbourList&>
 			   (*Sim->globals[cellID]));
   
-    dout << "Rebuilding the neighbour list named " << nblist.getName()
+    dout << "Expanding the neighbour list named " << nblist.getName()
 	 << "\nNColl = " << Sim->eventCount
 	 << "\nSys t = " << Sim->systemTime / Sim->units.unitTime() << std::endl;
   
-    nblist.setMaxInteractionRange(nblist.getMaxSupportedInteractionLength() * 1.1);
+    //Only the events of the pairs which become neighbours are added,
+    //the rest of the events remain valid.
+    nblist.expandMaxInteractionRange(nblist.getMaxSupportedInteractionLength() * 1.1);
   
     dt = (nblist.getMaxSupportedInteractionLength()
 	  / initialSupportedRange - 1.0) / growthRate - Sim->systemTime;
@@ -98,8 +100,7 @@ namespace dynamo {
 
     Sim->_sigParticleUpdate(SDat);
     
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+    Sim->outputPluginBus.eventUpdate(*this, SDat, locdt);
   }
 
   void 
@@ -111,9 +111,9 @@ namespace dynamo {
     for (const ParticleEventData& PDat : SDat.L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
   
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+    Sim->outputPluginBus.eventUpdate(*this, SDat, locdt);
 
+    Sim->outputPluginBus.synchronise();
     for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
       Ptr->temperatureRescale(1.0/currentkT);
 
@@ -79,8 +79,7 @@ namespace dynamo {
     for (const ParticleEventData& PDat : SDat.L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
   
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+    Sim->outputPluginBus.eventUpdate(*this, SDat, locdt);
 
     dt = _timestep;
     Sim->ptrScheduler->rebuildList();
@@ -72,7 +72,7 @@ namespace dynamo {
     _sleepVelocity = XML.getAttribute("SleepV").as<double>() * Sim->units.unitVelocity();
     _sleepDistance = Sim->units.unitLength() * 0.01;
     _sleepTime = Sim->units.unitTime() * 0.0001;
-    _range = shared_ptr<IDRange>(IDRange::getClass(XML, Sim));
+    _range = shared_ptr<IDRange>(IDRange::getClass(XML.getNode("IDRange"), Sim));
   }
 
   void 
@@ -162,8 +162,8 @@ namespace dynamo {
 	//If the static particle sleeps
 	if ((sleepCondition(sp, g)))
 	  {
-	    double massRatio = Sim->species[sp]->getMass(sp.getID()) 
-	      / Sim->species[dp]->getMass(dp.getID());
+	    double massRatio = Sim->species.getMass(sp) 
+	      / Sim->species.getMass(dp);
 
 	    stateChange[sp.getID()] = Vector(0,0,0);
 	    stateChange[dp.getID()] = -sp.getVelocity() * massRatio;
@@ -183,7 +183,7 @@ namespace dynamo {
 	    //(in comparison to the other components). This means the
 	    //particle will just keep having an event, we sleep it
 	    //instead.
-	    if ((pdat.impulse.nrm() / Sim->species[dp]->getMass(dp.getID())) 
+	    if ((pdat.impulse.nrm() / Sim->species.getMass(dp)) 
 		< _sleepVelocity)
 	      {
 		stateChange[dp.getID()] = Vector(0,0,0);
@@ -295,7 +295,6 @@ namespace dynamo {
     for (const ParticleEventData& PDat : SDat.L1partChanges)
       Sim->ptrScheduler->fullUpdate(Sim->particles[PDat.getParticleID()]);
     
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, SDat, locdt); 
+    Sim->outputPluginBus.eventUpdate(*this, SDat, locdt);
   }
 }
@@ -37,11 +37,12 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    //! \brief Checks the particles of every event for sleep and wake up changes.
+    void particlesUpdated(const NEventData&);
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
-    void particlesUpdated(const NEventData&);
-
     void recalculateTime();
 
     bool sleepCondition(const Particle& part, const Vector& g, const Vector& vel = Vector(0,0,0));
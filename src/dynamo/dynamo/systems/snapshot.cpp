@@ -67,8 +67,7 @@ namespace dynamo {
     //This is done here as most ticker properties require it
     Sim->dynamics->updateAllParticles();
 
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, NEventData(), locdt);
+    Sim->outputPluginBus.eventUpdate(*this, NEventData(), locdt);
   
     std::string filename = magnet::string::search_replace("Snapshot."+_format+".xml.bz2", "%COUNT", boost::lexical_cast<std::string>(_saveCounter));
     filename = magnet::string::search_replace(filename, "%ID", boost::lexical_cast<std::string>(Sim->simID));
@@ -68,8 +68,7 @@ namespace dynamo {
 	if (ptr) ptr->ticker();
       }
 
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, NEventData(), locdt);
+    Sim->outputPluginBus.eventUpdate(*this, NEventData(), locdt);
   }
 
   void 
@@ -20,6 +20,7 @@
 #include <dynamo/systems/rescale.hpp>
 #include <dynamo/systems/rotateGravity.hpp>
 #include <dynamo/systems/DSMCspheres.hpp>
+#include <dynamo/systems/DSMCcells.hpp>
 #include <dynamo/systems/umbrella.hpp>
 #include <dynamo/systems/visualizer.hpp>
 #include <dynamo/systems/sleep.hpp>
@@ -72,6 +73,8 @@ namespace dynamo {
       return shared_ptr<System>(new SysAndersen(XML,Sim));
     else if (!XML.getAttribute("Type").getValue().compare("DSMCSpheres"))
       return shared_ptr<System>(new SysDSMCSpheres(XML, Sim));
+    else if (!XML.getAttribute("Type").getValue().compare("DSMCCells"))
+      return shared_ptr<System>(new SysDSMCCells(XML, Sim));
     else if (!XML.getAttribute("Type").getValue().compare("Rescale"))
       return shared_ptr<System>(new SysRescale(XML, Sim));
     else if (!XML.getAttribute("Type").getValue().compare("Umbrella"))
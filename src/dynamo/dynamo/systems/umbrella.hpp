@@ -33,11 +33,12 @@ namespace dynamo {
 
     virtual void operator<<(const magnet::xml::Node&);
 
+    //! \brief Tracks the umbrella potential step after every event.
+    void particlesUpdated(const NEventData&);
+
   protected:
     virtual void outputXML(magnet::xml::XmlStream&) const;
 
-    void particlesUpdated(const NEventData&);
-
     void recalculateTime();
 
     mutable std::size_t _stepID;
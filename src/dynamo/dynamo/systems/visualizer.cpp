@@ -37,7 +37,15 @@
 
 namespace dynamo {
   SVisualizer::SVisualizer(dynamo::Simulation* nSim, std::string nName, double tickFreq):
-    System(nSim)
+    System(nSim),
+    _positions(NULL),
+    _velocities(NULL),
+    _sizes(NULL),
+    _eventCounts(NULL),
+    _orientations(NULL),
+    _angularVelocities(NULL),
+    _fullUpdate(true),
+    _lastSizeFactor(0)
   {
     //Convert to output units of time
     tickFreq /= Sim->units.unitTime();
@@ -94,8 +102,7 @@ namespace dynamo {
     if (_window->dynamoParticleSync())
       Sim->dynamics->updateAllParticles();
 
-    for (shared_ptr<OutputPlugin>& Ptr : Sim->outputPlugins)
-      Ptr->eventUpdate(*this, NEventData(), dt);
+    Sim->outputPluginBus.eventUpdate(*this, NEventData(), dt);
   
     for (shared_ptr<System>& system : Sim->systems)
       {
@@ -123,8 +130,17 @@ namespace dynamo {
   }
 
   void
-  SVisualizer::particlesUpdated(const NEventData&)
+  SVisualizer::particlesUpdated(const NEventData& data)
   {
+    for (const ParticleEventData& pdat : data.L1partChanges)
+      markUpdated(pdat.getParticleID());
+
+    for (const PairEventData& pdat : data.L2partChanges)
+      {
+	markUpdated(pdat.particle1_.getParticleID());
+	markUpdated(pdat.particle2_.getParticleID());
+      }
+
     if ((boost::posix_time::microsec_clock::local_time() - _lastUpdate) 
 	> boost::posix_time::milliseconds(500))
       {
@@ -153,12 +169,26 @@ namespace dynamo {
 	_particleData->addAttribute("Angular Velocity", coil::Attribute::EXTENSIVE, 3);
       }
 
+    _positions = &(*_particleData)["Position"];
+    _velocities = &(*_particleData)["Velocity"];
+    _sizes = &(*_particleData)["Size"];
+    _eventCounts = &(*_particleData)["Event Count"];
+    if (Sim->dynamics->hasOrientationData())
+      {
+	_orientations = &(*_particleData)["Orientation"];
+	_angularVelocities = &(*_particleData)["Angular Velocity"];
+      }
+
+    _updated.assign(Sim->N, false);
+    _updatedIDs.clear();
+    _fullUpdate = true;
+
     std::vector<GLfloat>& masses = (*_particleData)["Mass"];
     std::vector<GLfloat>& IDs = (*_particleData)["ID"];
     for (const Particle& p : Sim->particles)
       {
 	IDs[p.getID()] = p.getID();
-	masses[p.getID()] = Sim->species[p]->getMass(p.getID()) / Sim->units.unitMass();
+	masses[p.getID()] = Sim->species.getMass(p) / Sim->units.unitMass();
       }
     (*_particleData)["Mass"].flagNewData();
     (*_particleData)["ID"].flagNewData();
@@ -173,6 +203,36 @@ namespace dynamo {
       }
   }
 
+  void
+  SVisualizer::copyParticleData(const Particle& p) const
+  {
+    Vector vel = p.getVelocity() / Sim->units.unitVelocity();
+    Vector pos = p.getPosition() / Sim->units.unitLength();
+    Sim->BCs->applyBC(pos, vel);
+
+    for (size_t i(0); i < NDIM; ++i)
+      {
+	(*_positions)[3 * p.getID() + i] = pos[i];
+	(*_velocities)[3 * p.getID() + i] = vel[i];
+      }
+
+    const std::vector<size_t>& simEventCounts = Sim->ptrScheduler->getEventCounts();
+    (*_eventCounts)[p.getID()] = 0;
+    if (!simEventCounts.empty()) 
+      (*_eventCounts)[p.getID()] = simEventCounts[p.getID()];
+
+    if (Sim->dynamics->hasOrientationData())
+      {
+	const Dynamics::rotData& data = Sim->dynamics->getRotData(p);
+	for (size_t i(0); i < NDIM; ++i)
+	  {
+	    (*_angularVelocities)[3 * p.getID() + i] = data.angularVelocity[i] * Sim->units.unitTime();
+	    (*_orientations)[4 * p.getID() + i] = data.orientation.imaginary()[i];
+	  }
+	(*_orientations)[4 * p.getID() + 3] = data.orientation.real();
+      }
+  }
+
   void
   SVisualizer::updateRenderData() const
   {
@@ -185,70 +245,73 @@ namespace dynamo {
 				      Vector(BC->getBoundaryDisplacement(), Sim->primaryCellSize[1], 0),
 				      Vector(0, 0, Sim->primaryCellSize[2]));
 
+    ///////////////////////PARTICLE DATA UPDATE
+    //Every particle is copied if they have all been moved to the
+    //current time, or if the boundary shifts them. If most particles
+    //have been updated, a single upload is cheaper than many small
+    //ones.
+    const bool fullUpdate = _fullUpdate || BC || _window->dynamoParticleSync()
+      || (2 * _updatedIDs.size() > Sim->N);
 
-    ///////////////////////POSITION DATA UPDATE
-    //Check if the system is compressing and adjust the radius scaling factor
-    std::vector<GLfloat>& posdata = (*_particleData)["Position"];
-    std::vector<GLfloat>& veldata = (*_particleData)["Velocity"];
-    std::vector<GLfloat>& sizes = (*_particleData)["Size"];
-    std::vector<GLfloat>& eventCounts = (*_particleData)["Event Count"];
-    const std::vector<size_t>& simEventCounts = Sim->ptrScheduler->getEventCounts();
-    
-    for (const Particle& p : Sim->particles)
+    if (fullUpdate)
       {
-	Vector vel = p.getVelocity() / Sim->units.unitVelocity();
-	Vector pos = p.getPosition() / Sim->units.unitLength();
-	Sim->BCs->applyBC(pos, vel);
-	  
-	for (size_t i(0); i < NDIM; ++i)
+	for (const Particle& p : Sim->particles)
+	  copyParticleData(p);
+
+	_positions->flagNewData();
+	_velocities->flagNewData();
+	_eventCounts->flagNewData();
+	if (Sim->dynamics->hasOrientationData())
 	  {
-	    posdata[3 * p.getID() + i] = pos[i];
-	    veldata[3 * p.getID() + i] = vel[i];
+	    _angularVelocities->flagNewData();
+	    _orientations->flagNewData();
+	  }
+      }
+    else if (!_updatedIDs.empty())
+      {
+	//Sorted, so the uploads are made in runs of neighbouring IDs
+	std::sort(_updatedIDs.begin(), _updatedIDs.end());
+	for (const size_t& ID : _updatedIDs)
+	  copyParticleData(Sim->particles[ID]);
+
+	_positions->flagNewData(_updatedIDs);
+	_velocities->flagNewData(_updatedIDs);
+	_eventCounts->flagNewData(_updatedIDs);
+	if (Sim->dynamics->hasOrientationData())
+	  {
+	    _angularVelocities->flagNewData(_updatedIDs);
+	    _orientations->flagNewData(_updatedIDs);
 	  }
-
-	eventCounts[p.getID()] = 0;
-	if (!simEventCounts.empty()) 
-	  eventCounts[p.getID()] = simEventCounts[p.getID()];
       }
 
+    for (const size_t& ID : _updatedIDs)
+      _updated[ID] = false;
+    _updatedIDs.clear();
+
+    ///////////////////////SIZE DATA UPDATE
+    //Check if the system is compressing and adjust the radius scaling factor
     float rfactor = 1.0;
     if (std::dynamic_pointer_cast<DynCompression>(Sim->dynamics))
       rfactor *= (1 + static_cast<const DynCompression&>(*Sim->dynamics).getGrowthRate() * Sim->systemTime);
     rfactor /= Sim->units.unitLength();
 
-    for (auto& species : Sim->species)
-      {
-	const GlyphRepresentation& data = dynamic_cast<const GlyphRepresentation&>(*species->getIntPtr());
-	for (auto ID : *species->getRange())
-	  {
-	    const auto& psize = data.getGlyphSize(ID);
-	    for (size_t i(0); i < 4; ++i)
-	      sizes[4 * ID + i] = rfactor * psize[i];
-	  }
-      }
-
-    if (Sim->dynamics->hasOrientationData())
+    if (_fullUpdate || (rfactor != _lastSizeFactor))
       {
-	std::vector<GLfloat>& orientationdata = (*_particleData)["Orientation"];
-	std::vector<GLfloat>& angularvdata = (*_particleData)["Angular Velocity"];
-	const std::vector<Dynamics::rotData>& data = Sim->dynamics->getCompleteRotData();
-	for (const Particle& p : Sim->particles)
+	for (auto& species : Sim->species)
 	  {
-	    for (size_t i(0); i < NDIM; ++i)
+	    const GlyphRepresentation& data = dynamic_cast<const GlyphRepresentation&>(*species->getIntPtr());
+	    for (auto ID : *species->getRange())
 	      {
-		angularvdata[3 * p.getID() + i] = data[p.getID()].angularVelocity[i] * Sim->units.unitTime();
-		orientationdata[4 * p.getID() + i] = data[p.getID()].orientation.imaginary()[i];
+		const auto& psize = data.getGlyphSize(ID);
+		for (size_t i(0); i < 4; ++i)
+		  (*_sizes)[4 * ID + i] = rfactor * psize[i];
 	      }
-	    orientationdata[4 * p.getID() + 3] = data[p.getID()].orientation.real();
 	  }
-	(*_particleData)["Angular Velocity"].flagNewData();
-	(*_particleData)["Orientation"].flagNewData();
+	_sizes->flagNewData();
+	_lastSizeFactor = rfactor;
       }
 
-    (*_particleData)["Position"].flagNewData();
-    (*_particleData)["Velocity"].flagNewData();
-    (*_particleData)["Size"].flagNewData();
-    (*_particleData)["Event Count"].flagNewData();
+    _fullUpdate = false;
   }
 }
 #endif
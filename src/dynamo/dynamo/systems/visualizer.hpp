@@ -21,9 +21,11 @@
 
 #include <coil/clWindow.hpp>
 #include <dynamo/systems/system.hpp>
+#include <dynamo/particle.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <vector>
 
-namespace coil { class DataSet; }
+namespace coil { class DataSet; class Attribute; }
 namespace dynamo {
   class SVisualizer: public System
   {
@@ -47,10 +49,45 @@ namespace dynamo {
     coil::CoilRegister _coil;
     
     void initDataSet() const;
+
+    /*! \brief Copy the particle data into the render data set.
+
+      Only the particles which have been updated by an event since
+      the last call are copied and uploaded, unless every particle
+      may have changed (i.e., the first update, when the particles
+      are synchronised to the current time, or under Lees-Edwards
+      boundary conditions). The particle sizes are only copied when
+      the scaling of the glyphs changes.
+     */
     void updateRenderData() const;
 
+    //! \brief Copy the data of a single particle into the data set.
+    void copyParticleData(const Particle&) const;
+
+    //! \brief Mark a particle as updated since the last render data update.
+    void markUpdated(size_t ID)
+    {
+      if (_updated[ID]) return;
+      _updated[ID] = true;
+      _updatedIDs.push_back(ID);
+    }
+
     mutable shared_ptr<coil::DataSet> _particleData;
 
+    //! \brief The particle attributes of the data set, to avoid
+    //! looking them up by name on every update.
+    mutable coil::Attribute* _positions;
+    mutable coil::Attribute* _velocities;
+    mutable coil::Attribute* _sizes;
+    mutable coil::Attribute* _eventCounts;
+    mutable coil::Attribute* _orientations;
+    mutable coil::Attribute* _angularVelocities;
+
+    mutable std::vector<char> _updated;
+    mutable std::vector<size_t> _updatedIDs;
+    mutable bool _fullUpdate;
+    mutable float _lastSizeFactor;
+
     mutable boost::posix_time::ptime _lastUpdate;
   };
 }
@@ -17,6 +17,8 @@
 
 #include <magnet/xmlreader.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/containers/offset_array.hpp>
 
 #include <boost/program_options.hpp>
 #include <boost/iostreams/device/file.hpp>
@@ -26,7 +28,6 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/filesystem.hpp>
-#include <unordered_map>
 
 #include <fenv.h>
 #include <iostream>
@@ -38,6 +39,10 @@
 #include <iomanip>
 #include <iosfwd>
 #include <array>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <functional>
 
 using namespace std;
 using namespace boost;
@@ -46,8 +51,17 @@ const size_t NGamma = 1;
 
 //Set in the main function
 static long double alpha;
-static long double minErr = 1e-16;
+static long double minErr = 1e-14;
 static size_t NStepsPerStep = 0;
+static size_t DIISHistory = 0;
+//! Stop iterating if the error has not improved after this many checks
+static const size_t maxStalledChecks = 20;
+static magnet::thread::ThreadPool threadPool;
+//! The number of histogram bins processed by each task of the WHAMWindow
+static const size_t blockSize = 256;
+//! Exponents are clamped to this value in the WHAMWindow to avoid
+//! underflow, which is trapped by this program
+static const double minExponent = -700;
 static boost::program_options::variables_map vm;
 
 long double betaMax;
@@ -122,9 +136,9 @@ struct SimulationData
       }
 
     std::cout << "W for file " << nfn;
-    for (std::unordered_map<int, double>::iterator iPtr = _W.begin();
-	 iPtr != _W.end(); ++iPtr)
-      std::cout << "\nE = " << iPtr->first * binWidth << ", W = " << iPtr->second;
+    for (long i(_W.begin_index()); i < _W.end_index(); ++i)
+      if (_W(i))
+	std::cout << "\nE = " << i * binWidth << ", W = " << _W(i);
     std::cout << std::endl;
 
     //Now navigate to the histogram and load the data
@@ -168,7 +182,7 @@ struct SimulationData
   };
   std::vector<histogramEntry> data;
 
-  std::unordered_map<int, double> _W;
+  magnet::containers::OffsetArray<double> _W;
 
 
   //Bottom and top contain the window of systems used for the calculation
@@ -236,13 +250,7 @@ struct SimulationData
   void iterate_logZ() { logZ = new_logZ; }
 
   inline double W(double E) const 
-  { 
-    std::unordered_map<int, double>::const_iterator 
-      iPtr = _W.find(lrint(E / binWidth));
-    if (iPtr != _W.end())
-      return -iPtr->second;
-    return 0;
-  }
+  { return -_W(lrint(E / binWidth)); }
 };
 
 struct ldbl 
@@ -261,43 +269,360 @@ typedef std::vector<densOStatesPair> densOStatesType;
 densOStatesType densOStates;
   
 
+/*! \brief The multiple histogram equations for a window of
+    simulations, rearranged for a fast iterative solution.
+
+    The self-consistent equation for the partition function of
+    simulation \f$k\f$ is
+    \f[ Z_k = \sum_i \sum_{E} \frac{H_i(E)}{\sum_j \exp[(\gamma_j -
+    \gamma_k) E + W_j(E) - W_k(E)] / Z_j} \f]
+
+    which only depends on the energy of each histogram bin. The
+    histograms of the window are merged onto a single grid of unique
+    energies and the denominator is factorised as
+    \f[ Z_k = \sum_E H(E) \exp[b_k(E)] / D(E) \qquad D(E) = \sum_j
+    \exp[b_j(E)] / Z_j \qquad b_k(E) = \gamma_k E + W_k(E)\f]
+
+    so an iteration costs \f$O(N_{sims} N_{bins})\f$ instead of
+    \f$O(N_{sims}^2 N_{bins})\f$ as in
+    SimulationData::calc_logZ. Both sums are evaluated as
+    log-sum-exp's, so every exponential is bounded by one and may be
+    safely evaluated in double precision. The \f$D(E)\f$ sums are
+    processed in cache sized blocks of bins and both stages are split
+    across the threads of the pool.
+ */
+struct WHAMWindow
+{
+  WHAMWindow(size_t nbottom, size_t ntop, magnet::thread::ThreadPool& pool):
+    bottom(nbottom), top(ntop), Nsims(ntop - nbottom + 1), _pool(pool)
+  {
+    if (NGamma != 1) 
+      M_throw() << "For multiple gamma reweighting, one must be designated as E and used in the W lookup";
+
+    //Merge the histograms of the window onto one grid
+    std::map<long double, long double> histogram;
+    for (size_t i(bottom); i <= top; ++i)
+      for (const SimulationData::histogramEntry& simdat : SimulationDataData[i].data)
+	histogram[simdat.X[0]] += simdat.Probability;
+
+    for (const std::pair<const long double, long double>& bin : histogram)
+      if (bin.second > 0)
+	{
+	  energy.push_back(bin.first);
+	  logH.push_back(std::log(bin.second));
+	}
+
+    Nbins = energy.size();
+    b.resize(Nsims * Nbins);
+    for (size_t k(0); k < Nsims; ++k)
+      {
+	const SimulationData& sim = SimulationDataData[bottom + k];
+	for (size_t n(0); n < Nbins; ++n)
+	  b[k * Nbins + n] = sim.gamma[0] * energy[n] + sim.W(energy[n]);
+      }
+
+    logD.resize(Nbins);
+  }
+
+  /*! \brief Evaluate the right hand side of the self-consistent
+      equations.
+
+      \param logZ The current values of \f$\ln Z\f$ for the window.
+      \param newLogZ The updated values of \f$\ln Z\f$.
+   */
+  void iterate(const std::vector<long double>& logZ, std::vector<long double>& newLogZ)
+  {
+    std::vector<double> dlogZ(logZ.begin(), logZ.end());
+    newLogZ.resize(Nsims);
+
+    for (size_t start(0); start < Nbins; start += blockSize)
+      _pool.queueTask(std::bind(&WHAMWindow::calcLogD, this, std::cref(dlogZ), start, std::min(start + blockSize, Nbins)));
+    _pool.wait();
+
+    for (size_t k(0); k < Nsims; ++k)
+      _pool.queueTask(std::bind(&WHAMWindow::calcLogZ, this, k, std::ref(newLogZ[k])));
+    _pool.wait();
+  }
+
+  size_t bottom, top, Nsims, Nbins;
+
+  //! The unique energies of the merged histograms.
+  std::vector<double> energy;
+  //! The log of the merged histogram at each energy.
+  std::vector<double> logH;
+  //! \f$b_k(E)\f$ stored as b[k * Nbins + n].
+  std::vector<double> b;
+  //! Scratch space for \f$\ln D(E)\f$.
+  std::vector<double> logD;
+
+private:
+  void calcLogD(const std::vector<double>& logZ, const size_t start, const size_t end)
+  {
+    double maxVal[blockSize];
+    long double sum[blockSize];
+    const size_t N = end - start;
+
+    for (size_t n(0); n < N; ++n)
+      {
+	maxVal[n] = -HUGE_VAL;
+	sum[n] = 0;
+      }
+
+    for (size_t j(0); j < Nsims; ++j)
+      {
+	const double* bj = &b[j * Nbins + start];
+	for (size_t n(0); n < N; ++n)
+	  maxVal[n] = std::max(maxVal[n], bj[n] - logZ[j]);
+      }
+
+    for (size_t j(0); j < Nsims; ++j)
+      {
+	const double* bj = &b[j * Nbins + start];
+	for (size_t n(0); n < N; ++n)
+	  sum[n] += std::exp(std::max(bj[n] - logZ[j] - maxVal[n], minExponent));
+      }
+
+    for (size_t n(0); n < N; ++n)
+      logD[start + n] = maxVal[n] + std::log(sum[n]);
+  }
+
+  void calcLogZ(const size_t k, long double& result)
+  {
+    const double* bk = &b[k * Nbins];
+    double maxVal = -HUGE_VAL;
+    for (size_t n(0); n < Nbins; ++n)
+      maxVal = std::max(maxVal, logH[n] + bk[n] - logD[n]);
+
+    long double sum = 0;
+    for (size_t n(0); n < Nbins; ++n)
+      sum += std::exp(std::max(logH[n] + bk[n] - logD[n] - maxVal, minExponent));
+
+    result = maxVal + std::log(sum);
+  }
+
+  magnet::thread::ThreadPool& _pool;
+};
+
+/*! \brief DIIS (Pulay/Anderson) acceleration of the fixed point
+    iteration \f$x \to g(x)\f$.
+
+    The last few iterates are stored and the next iterate is the
+    combination of their images \f$\sum_i c_i g(x_i)\f$ with the
+    coefficients (\f$\sum_i c_i = 1\f$) that minimise the norm of the
+    combined residual \f$\sum_i c_i (g(x_i) - x_i)\f$.
+ */
+struct DIIS
+{
+  DIIS(size_t nhistory): history(nhistory) {}
+
+  /*! \brief Add an iterate and its image, and return the
+      extrapolated next iterate.
+
+      \param free A mask of the components which are being solved
+      for, the other components are fixed.
+   */
+  std::vector<long double> step(const std::vector<long double>& x, std::vector<long double> gx, const std::vector<bool>& free)
+  {
+    std::vector<long double> r(x.size());
+    for (size_t i(0); i < x.size(); ++i)
+      {
+	if (!free[i]) gx[i] = x[i];
+	r[i] = gx[i] - x[i];
+      }
+
+    _residuals.push_back(r);
+    _images.push_back(gx);
+    if (_residuals.size() > history)
+      {
+	_residuals.erase(_residuals.begin());
+	_images.erase(_images.begin());
+      }
+
+    const size_t M = _residuals.size();
+    if (M < 2) return gx;
+
+    //Build the bordered system [R^T R, 1; 1^T, 0] [c; l] = [0; 1]
+    std::vector<std::vector<long double> > A(M + 1, std::vector<long double>(M + 2, 0));
+    for (size_t i(0); i < M; ++i)
+      {
+	for (size_t j(0); j < M; ++j)
+	  for (size_t n(0); n < r.size(); ++n)
+	    A[i][j] += _residuals[i][n] * _residuals[j][n];
+	A[i][M] = A[M][i] = 1;
+      }
+    A[M][M + 1] = 1;
+
+    //Gaussian elimination with partial pivoting
+    for (size_t col(0); col <= M; ++col)
+      {
+	size_t pivot = col;
+	for (size_t row(col + 1); row <= M; ++row)
+	  if (std::fabs(A[row][col]) > std::fabs(A[pivot][col]))
+	    pivot = row;
+
+	if (std::fabs(A[pivot][col]) < 1e-300L)
+	  {
+	    //The residuals are linearly dependent, restart the history
+	    reset();
+	    return gx;
+	  }
+
+	std::swap(A[col], A[pivot]);
+	for (size_t row(0); row <= M; ++row)
+	  if (row != col)
+	    {
+	      const long double factor = A[row][col] / A[col][col];
+	      for (size_t k(col); k <= M + 1; ++k)
+		A[row][k] -= factor * A[col][k];
+	    }
+      }
+
+    std::vector<long double> next(x.size(), 0);
+    for (size_t i(0); i < M; ++i)
+      {
+	const long double c = A[i][M + 1] / A[i][i];
+	for (size_t n(0); n < x.size(); ++n)
+	  next[n] += c * _images[i][n];
+      }
+
+    return next;
+  }
+
+  void reset() { _residuals.clear(); _images.clear(); }
+
+  size_t history;
+
+private:
+  std::vector<std::vector<long double> > _residuals;
+  std::vector<std::vector<long double> > _images;
+};
+
 void
 solveWeightsInRange(size_t bottom = 0, size_t top = 0)
 {
   //If top = 0, then use all systems
   if (top == 0) top = SimulationDataData.size() - 1;
 
-  double err = 0.0;
+  WHAMWindow window(bottom, top, threadPool);
+
+  std::vector<long double> logZ(window.Nsims), newLogZ(window.Nsims);
+  std::vector<bool> free(window.Nsims);
+  for (size_t i(bottom); i <= top; ++i)
+    {
+      logZ[i - bottom] = SimulationDataData[i].logZ;
+      free[i - bottom] = !SimulationDataData[i].refZ;
+    }
+
+  DIIS diis(DIISHistory);
+
+  long double err = 0.0;
+  //The best error so far and the number of checks since it improved
+  long double bestErr = HUGE_VAL;
+  size_t stalledChecks = 0;
 
   do
     {
-      for (size_t i = NStepsPerStep; i != 0; --i)
+      for (size_t step(0); step <= NStepsPerStep; ++step)
 	{
-	  for (size_t i(bottom); i <= top; ++i)
-	    SimulationDataData[i].recalc_newlogZ(bottom, top);
-	  
-	  for (size_t i(bottom); i <= top; ++i)
-	    SimulationDataData[i].iterate_logZ();
+	  window.iterate(logZ, newLogZ);
+
+	  //The final step of each set is the error checking run
+	  if (step == NStepsPerStep)
+	    {
+	      err = 0.0;
+	      for (size_t i(0); i < window.Nsims; ++i)
+		{
+		  if (!free[i]) continue;
+		  //In case of new_logZ going to zero don't use relative values
+		  long double relerr = 0;
+		  if (newLogZ[i] != 0)
+		    relerr = std::fabs((newLogZ[i] - logZ[i]) / newLogZ[i]);
+		  else if (logZ[i] != 0)
+		    relerr = std::fabs((newLogZ[i] - logZ[i]) / logZ[i]);
+		  err = std::max(err, relerr);
+		}
+	    }
+
+	  if (DIISHistory)
+	    logZ = diis.step(logZ, newLogZ, free);
+	  else
+	    for (size_t i(0); i < window.Nsims; ++i)
+	      if (free[i])
+		logZ[i] += alpha * (newLogZ[i] - logZ[i]);
 	}
 
-      //Now the error checking run
-      err = 0.0;
-      for (size_t i(bottom); i <= top; ++i)
+      printf("\r%LE", err);
+      fflush(stdout);
+
+      if (err < bestErr)
 	{
-	  SimulationDataData[i].recalc_newlogZ(bottom, top);
-	  
-	  if (SimulationDataData[i].calc_error() > err)
-	    err = SimulationDataData[i].calc_error();
+	  bestErr = err;
+	  stalledChecks = 0;
+	}
+      else if (++stalledChecks > maxStalledChecks)
+	{
+	  std::cout << "\nThe error has stopped decreasing, the solution has reached the limit of the numerical precision";
+	  break;
 	}
+    }
+  while(err > minErr);
+
+  for (size_t i(bottom); i <= top; ++i)
+    SimulationDataData[i].logZ = SimulationDataData[i].new_logZ = logZ[i - bottom];
+}
 
-      //May as well use this as an iteration too
-      for (size_t i(bottom); i <= top; ++i)
-	SimulationDataData[i].iterate_logZ();
+/*! \brief Compares the speed and results of the WHAMWindow solver
+    against the reference SimulationData::calc_logZ implementation.
+ */
+void
+benchmark()
+{
+  const size_t iterations = vm["benchmark"].as<size_t>();
+  std::cout << "##################################################\n";
+  std::cout << "Benchmarking " << iterations << " iterations over all " << SimulationDataData.size() << " simulations\n";
 
-      printf("\r%E", err);
-      fflush(stdout);
+  for (SimulationData& simdat : SimulationDataData)
+    simdat.refZ = false;
+  SimulationDataData.front().refZ = true;
+
+  const std::vector<SimulationData> initialData = SimulationDataData;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t it(0); it < iterations; ++it)
+    {
+      for (SimulationData& simdat : SimulationDataData)
+	simdat.recalc_newlogZ(0, 0);
+      for (SimulationData& simdat : SimulationDataData)
+	simdat.iterate_logZ();
     }
-  while(err > minErr);
+  const double referenceTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<long double> reference;
+  for (const SimulationData& simdat : SimulationDataData)
+    reference.push_back(simdat.logZ);
+  SimulationDataData = initialData;
+
+  start = std::chrono::steady_clock::now();
+  WHAMWindow window(0, SimulationDataData.size() - 1, threadPool);
+  std::vector<long double> logZ(window.Nsims, 0), newLogZ;
+  for (size_t it(0); it < iterations; ++it)
+    {
+      window.iterate(logZ, newLogZ);
+      for (size_t i(1); i < window.Nsims; ++i)
+	logZ[i] = newLogZ[i];
+    }
+  const double windowTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  long double maxErr = 0;
+  for (size_t i(0); i < window.Nsims; ++i)
+    if (reference[i] != 0)
+      maxErr = std::max(maxErr, std::fabs((logZ[i] - reference[i]) / reference[i]));
+
+  std::cout << "Histogram bins: " << window.Nbins << ", threads: " << threadPool.getThreadCount() << "\n"
+	    << "Reference: " << referenceTime << "s\n"
+	    << "Blocked:   " << windowTime << "s (including setup)\n"
+	    << "Speedup:   " << referenceTime / windowTime << "\n"
+	    << "Max relative difference in logZ: " << maxErr << "\n";
 }
 
 void
@@ -580,6 +905,10 @@ main(int argc, char *argv[])
       ("data-file", po::value<std::vector<std::string> >(), "Specify a config file to load, or just list them on the command line")
       ("alpha", po::value<long double>()->default_value(1), "A fraction of the difference between the old and new logZ's to use, use to stop divergence")
       ("NSteps,N", po::value<size_t>()->default_value(10), "Number of steps to take before testing the error and spitting out the current vals")
+      ("min-err", po::value<long double>()->default_value(1e-14), "The relative change in the logZ's at which the iteration is converged")
+      ("DIIS", po::value<size_t>()->default_value(0), "If non-zero, accelerate the iteration using DIIS extrapolation over this many previous iterates (e.g., 5)")
+      ("n-threads", po::value<unsigned int>()->default_value(std::thread::hardware_concurrency()), "Number of threads to use in solving for the weights")
+      ("benchmark", po::value<size_t>(), "Time this many iterations of the fast solver against the reference implementation, then exit")
       ("Tmin", po::value<double>(), "Set the coldest temperature to output calculated data for (Cv.out, Energy.out) etc. If unset this defaults to the temperature of the coldest simulation.")
       ("Tmax", po::value<double>(), "Set the hottest temperature to output calculated data for (Cv.out, Energy.out) etc. If unset this defaults to the temperature of the hottest simulation.")
       ;
@@ -600,6 +929,9 @@ main(int argc, char *argv[])
 
     alpha = vm["alpha"].as<long double>();
     NStepsPerStep = vm["NSteps"].as<size_t>();
+    minErr = vm["min-err"].as<long double>();
+    DIISHistory = vm["DIIS"].as<size_t>();
+    threadPool.setThreadCount(vm["n-threads"].as<unsigned int>());
 
     //Data load
     for (std::string fileName : vm["data-file"].as<std::vector<std::string> >())
@@ -636,6 +968,12 @@ main(int argc, char *argv[])
     for (const SimulationData& dat : SimulationDataData)
       std::cout << dat.fileName << " NData = " << dat.data.size() << " gamma[0] = " << dat.gamma[0] << "\n";
 
+    if (vm.count("benchmark"))
+      {
+	benchmark();
+	return 0;
+      }
+
     solveWeightsPiecemeal();
     
     std::cout << "##################################################\n";
@@ -151,6 +151,9 @@ main(int argc, char *argv[])
       else
 	sim.loadXMLfile(vm["config-file"].as<string>());
 
+      if (vm.count("random-seed"))
+	sim.randomStreams.seed(vm["random-seed"].as<unsigned int>());
+
       sim.status = dynamo::CONFIG_LOADED;
       sim.endEventCount = 0;
 
@@ -0,0 +1,198 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file dynatraj.cpp
+
+  \brief Contains the main() function for dynatraj
+
+  This program reads the binary trajectory files written by the
+  OPBinaryTrajectory output plugin and converts them to text.
+*/
+
+#include <dynamo/outputplugins/binarytrajectory.hpp>
+#include <dynamo/eventtypes.hpp>
+#include <magnet/stream/formattedostream.hpp>
+#include <magnet/stream/console_specials.hpp>
+#include <boost/program_options.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <cstring>
+#include <limits>
+#include <map>
+
+using namespace dynamo;
+
+namespace {
+  void printRecord(std::ostream& os, const BinaryTrajectoryRecord& record, bool csv)
+  {
+    const char sep = csv ? ',' : ' ';
+    os << record.eventCount << sep
+       << record.sequence << sep
+       << EEventType(record.eventClass) << sep
+       << record.sourceID << sep
+       << EEventType(record.eventType) << sep
+       << EEventType(record.resultType) << sep
+       << record.time << sep;
+
+    if (record.p1 == BinaryTrajectoryRecord::noParticle)
+      os << "-";
+    else
+      os << record.p1;
+    os << sep;
+
+    if (record.p2 == BinaryTrajectoryRecord::noParticle)
+      os << "-";
+    else
+      os << record.p2;
+
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      os << sep << record.deltaP[iDim];
+    os << sep << record.deltaU << sep << record.state1 << sep << record.state2 << "\n";
+  }
+}
+
+/*! \brief Starting point for the dynatraj program.
+
+  \param argc The number of command line arguments.
+  \param argv A pointer to the array of command line arguments.
+*/
+int main(int argc, char *argv[])
+{
+  try
+    {
+      namespace po = boost::program_options;
+      namespace io = boost::iostreams;
+
+      po::variables_map vm;
+      po::options_description options("Program Options");
+      options.add_options()
+	("help", "Produces this message")
+	("trajectory-file", po::value<std::string>(), "The binary trajectory file to read")
+	("csv", "Output the records in comma separated value format")
+	("summary", "Only print a count of each type of event in the trajectory")
+	("start-event", po::value<size_t>()->default_value(0), "Skip records of events before this event count")
+	("end-event", po::value<size_t>()->default_value(std::numeric_limits<size_t>::max()), "Stop at records of events after this event count")
+	;
+
+      po::positional_options_description p;
+      p.add("trajectory-file", 1);
+
+      po::store(po::command_line_parser(argc, argv).options(options).positional(p).run(), vm);
+      po::notify(vm);
+
+      if (vm.count("help") || !vm.count("trajectory-file"))
+	{
+	  std::cout << "dynatraj  Copyright (C) 2011  Marcus N Campbell Bannerman\n"
+		    << "This program comes with ABSOLUTELY NO WARRANTY.\n"
+		    << "This is free software, and you are welcome to redistribute it\n"
+		    << "under certain conditions. See the licence you obtained with\n"
+		    << "the code\n"
+		    << "Usage : dynatraj <OPTION>... <trajectory-file>\n"
+		    << "Converts a binary trajectory file (written by the BinaryTrajectory\n"
+		    << "output plugin) into text. The file may be bzip2 or gzip compressed.\n"
+		    << options << "\n";
+	  return 1;
+	}
+
+      const std::string fileName = vm["trajectory-file"].as<std::string>();
+      if (!boost::filesystem::exists(fileName))
+	M_throw() << "Could not find the trajectory file named " << fileName;
+
+      io::filtering_istream inputFile;
+      if ((fileName.size() > 4) && (std::string(fileName.end() - 4, fileName.end()) == ".bz2"))
+	inputFile.push(io::bzip2_decompressor());
+      else if ((fileName.size() > 3) && (std::string(fileName.end() - 3, fileName.end()) == ".gz"))
+	inputFile.push(io::gzip_decompressor());
+      inputFile.push(io::file_source(fileName, std::ios::in | std::ios::binary));
+
+      BinaryTrajectoryHeader header;
+      if (!inputFile.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	M_throw() << "Failed to read the header of " << fileName;
+
+      if (std::strncmp(header.magic, "DYNAMOTR", 8))
+	M_throw() << fileName << " is not a DynamO binary trajectory file";
+
+      if (header.version != BinaryTrajectoryHeader::currentVersion)
+	M_throw() << "Unsupported binary trajectory version " << header.version;
+
+      if ((header.dimensions != NDIM) || (header.recordSize != sizeof(BinaryTrajectoryRecord)))
+	M_throw() << "The binary trajectory was written with a different record layout (NDIM="
+		  << header.dimensions << ", record size=" << header.recordSize << ")";
+
+      const bool csv = vm.count("csv");
+      const bool summary = vm.count("summary");
+      const size_t startEvent = vm["start-event"].as<size_t>();
+      const size_t endEvent = vm["end-event"].as<size_t>();
+
+      std::cout.precision(std::numeric_limits<double>::digits10 + 2);
+
+      if (!summary)
+	{
+	  std::cout << "# N=" << header.N << " StartTime=" << header.startTime
+		    << " StartEvent=" << header.startEventCount << "\n";
+	  if (csv)
+	    std::cout << "Event,Sequence,Class,SourceID,Type,Result,Time,P1,P2,DeltaPx,DeltaPy,DeltaPz,DeltaU,State1,State2\n";
+	}
+
+      std::map<std::pair<uint16_t, uint16_t>, size_t> counts;
+      size_t recordCount(0);
+      const size_t blockSize = 4096;
+      std::vector<BinaryTrajectoryRecord> block(blockSize);
+      bool done = false;
+      while (!done && inputFile)
+	{
+	  inputFile.read(reinterpret_cast<char*>(block.data()), blockSize * sizeof(BinaryTrajectoryRecord));
+	  const size_t bytes = inputFile.gcount();
+	  if (bytes % sizeof(BinaryTrajectoryRecord))
+	    M_throw() << "The trajectory file ends with a truncated record";
+
+	  for (size_t i(0); i < bytes / sizeof(BinaryTrajectoryRecord); ++i)
+	    {
+	      const BinaryTrajectoryRecord& record = block[i];
+	      if (record.eventCount < startEvent) continue;
+	      if (record.eventCount > endEvent) { done = true; break; }
+
+	      ++recordCount;
+	      if (summary)
+		++counts[std::make_pair(record.eventClass, record.resultType)];
+	      else
+		printRecord(std::cout, record, csv);
+	    }
+	}
+
+      if (summary)
+	{
+	  std::cout << "Records: " << recordCount << "\n";
+	  for (const auto& entry : counts)
+	    std::cout << EEventType(entry.first.first) << " " << EEventType(entry.first.second)
+		      << " " << entry.second << "\n";
+	}
+    }
+  catch (std::exception& cep)
+    {
+      std::cout.flush();
+      magnet::stream::FormattedOStream os(std::cerr, magnet::console::bold() + magnet::console::red_fg() + "Main(): " + magnet::console::reset());
+      os << cep.what() << std::endl;
+#ifndef DYNAMO_DEBUG
+      os << "Try using the debugging executable for more information on the error." << std::endl;
+#endif
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/ensemble.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <limits>
+
+using namespace dynamo;
+
+/* Benchmarks resizing the cells of a large hard sphere system
+   incrementally (GCells::expandMaxInteractionRange) against
+   rebuilding the cells and every event of the Scheduler
+   (GNeighbourList::setMaxInteractionRange). The cells are grown in
+   small steps with only a few events between each, as in a
+   compression run, so the resizes dominate the run time. This is not
+   a test, build it with "bjam src/dynamo//cellsresize-benchmark".
+ */
+
+void build(Simulation& sim)
+{
+  //A simple cubic lattice of spheres with random velocities
+  const size_t n = 40;
+  const double L = 56;
+
+  sim.primaryCellSize = Vector(L, L, L);
+  sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  sim.BCs = shared_ptr<BoundaryCondition>(new BCPeriodic(&sim));
+  sim.ptrScheduler = shared_ptr<SNeighbourList>(new SNeighbourList(&sim, new FELBoundedPQ<PELMinMax<3> >()));
+  sim.globals.push_back(shared_ptr<Global>(new GCells(&sim, "SchedulerNBList")));
+  sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new IHardSphere(&sim, 1.0, 1.0, new IDPairRangeAll(), "Bulk")));
+  sim.addSpecies(shared_ptr<Species>(new SpPoint(&sim, new IDRangeAll(&sim), 1.0, "Bulk", 0, "Bulk")));
+
+  std::mt19937 RNG(1234);
+  std::normal_distribution<double> velocity;
+  for (size_t i(0); i < n; ++i)
+    for (size_t j(0); j < n; ++j)
+      for (size_t k(0); k < n; ++k)
+	sim.particles.push_back(Particle(Vector((i + 0.5) / n - 0.5, (j + 0.5) / n - 0.5, (k + 0.5) / n - 0.5) * L,
+					 Vector(velocity(RNG), velocity(RNG), velocity(RNG)), sim.particles.size()));
+  sim.N = sim.particles.size();
+  sim.ensemble = Ensemble::loadEnsemble(sim);
+
+  sim.endEventCount = std::numeric_limits<size_t>::max();
+  sim.status = CONFIG_LOADED;
+  sim.initialise();
+}
+
+//! \brief Grow the cells in steps, returning the time taken in seconds.
+double resizeRun(Simulation& sim, bool incremental)
+{
+  const size_t resizes = 40;
+  const size_t eventsPerResize = 1000;
+  GNeighbourList& nblist = dynamic_cast<GNeighbourList&>(*sim.globals["SchedulerNBList"]);
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  double range = 1.0;
+  for (size_t i(0); i < resizes; ++i)
+    {
+      const size_t endCount = sim.eventCount + eventsPerResize;
+      while (sim.eventCount < endCount)
+	sim.runSimulationStep(true);
+
+      range *= 1.03;
+      if (incremental)
+	nblist.expandMaxInteractionRange(range);
+      else
+	nblist.setMaxInteractionRange(range);
+    }
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main()
+{
+  Simulation incremental, rebuilt;
+  build(incremental);
+  build(rebuilt);
+
+  const double incrementalTime = resizeRun(incremental, true);
+  const double rebuiltTime = resizeRun(rebuilt, false);
+
+  std::cout << "Cell resizes for " << incremental.N << " particles: incremental "
+	    << incrementalTime << "s, rebuild " << rebuiltTime << "s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,190 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/ensemble.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/outputplugins/outputplugin.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using namespace dynamo;
+
+/* Checks that resizing the cells while the simulation runs
+   (GCells::expandMaxInteractionRange, used by
+   SysNBListCompressionFix) gives the same events as reinitialising
+   the cells and the Scheduler (GNeighbourList::setMaxInteractionRange).
+   Two copies of a hard sphere system are run, one resizing its cells
+   incrementally and the other rebuilding them, and every interaction
+   event and the final configurations are compared.
+ */
+
+//! \brief Records the pairs and types of the interaction events.
+class OPPairRecorder: public OutputPlugin
+{
+public:
+  OPPairRecorder(const Simulation* sim):
+    OutputPlugin(sim, "PairRecorder")
+  {}
+
+  virtual void initialise() {}
+
+  virtual void eventUpdate(const IntEvent& event, const PairEventData&)
+  {
+    //The order of the pair depends on which particle's events found
+    //it, so only the unordered pair is compared
+    events.push_back(Record{std::min(event.getParticle1ID(), event.getParticle2ID()),
+	  std::max(event.getParticle1ID(), event.getParticle2ID()), event.getType()});
+  }
+
+  virtual EventSubscription getEventSubscription() const
+  { return EventSubscription(EventSubscription::INTERACTION_EVENTS); }
+
+  virtual void replicaExchange(OutputPlugin&) {}
+
+  struct Record
+  {
+    size_t p1;
+    size_t p2;
+    EEventType type;
+
+    bool operator==(const Record& other) const
+    { return (p1 == other.p1) && (p2 == other.p2) && (type == other.type); }
+  };
+
+  std::vector<Record> events;
+};
+
+void build(Simulation& sim, shared_ptr<OPPairRecorder>& recorder)
+{
+  //A simple cubic lattice of spheres with random velocities
+  const size_t n = 10;
+  const double L = 14;
+
+  sim.primaryCellSize = Vector(L, L, L);
+  sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  sim.BCs = shared_ptr<BoundaryCondition>(new BCPeriodic(&sim));
+  sim.ptrScheduler = shared_ptr<SNeighbourList>(new SNeighbourList(&sim, new FELBoundedPQ<PELMinMax<3> >()));
+  sim.globals.push_back(shared_ptr<Global>(new GCells(&sim, "SchedulerNBList")));
+  sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new IHardSphere(&sim, 1.0, 1.0, new IDPairRangeAll(), "Bulk")));
+  sim.addSpecies(shared_ptr<Species>(new SpPoint(&sim, new IDRangeAll(&sim), 1.0, "Bulk", 0, "Bulk")));
+
+  std::mt19937 RNG(1234);
+  std::normal_distribution<double> velocity;
+  for (size_t i(0); i < n; ++i)
+    for (size_t j(0); j < n; ++j)
+      for (size_t k(0); k < n; ++k)
+	sim.particles.push_back(Particle(Vector((i + 0.5) / n - 0.5, (j + 0.5) / n - 0.5, (k + 0.5) / n - 0.5) * L,
+					 Vector(velocity(RNG), velocity(RNG), velocity(RNG)), sim.particles.size()));
+  sim.N = sim.particles.size();
+  sim.ensemble = Ensemble::loadEnsemble(sim);
+
+  recorder = shared_ptr<OPPairRecorder>(new OPPairRecorder(&sim));
+  sim.outputPlugins.push_back(recorder);
+
+  sim.endEventCount = std::numeric_limits<size_t>::max();
+  sim.status = CONFIG_LOADED;
+  sim.initialise();
+}
+
+//! \brief Run the Simulation until it has executed the passed number of events.
+void run(Simulation& sim, size_t eventCount)
+{
+  while (sim.eventCount < eventCount)
+    sim.runSimulationStep(true);
+}
+
+int main()
+{
+  Simulation incremental, rebuilt;
+  shared_ptr<OPPairRecorder> incrementalEvents, rebuiltEvents;
+  build(incremental, incrementalEvents);
+  build(rebuilt, rebuiltEvents);
+
+  //The cells are resized between the same interaction events in
+  //both simulations. The runs are compared by their event count, as
+  //the cell events and stale events they process differ.
+  const double ranges[] = {1.5, 2.3, 3.5};
+  const size_t eventsPerRange = 1000;
+  for (const double range : ranges)
+    {
+      run(incremental, incremental.eventCount + eventsPerRange);
+      run(rebuilt, incremental.eventCount);
+      dynamic_cast<GNeighbourList&>(*incremental.globals["SchedulerNBList"]).expandMaxInteractionRange(range);
+      dynamic_cast<GNeighbourList&>(*rebuilt.globals["SchedulerNBList"]).setMaxInteractionRange(range);
+    }
+
+  run(incremental, incremental.eventCount + eventsPerRange);
+  run(rebuilt, incremental.eventCount);
+
+  size_t errors(0);
+
+  const std::vector<OPPairRecorder::Record>& events = incrementalEvents->events;
+  const std::vector<OPPairRecorder::Record>& expected = rebuiltEvents->events;
+  if (events.size() != expected.size())
+    {
+      std::cerr << "The incremental resize executed " << events.size() << " interaction events, but the rebuild "
+		<< expected.size() << std::endl;
+      ++errors;
+    }
+
+  for (size_t i(0); i < std::min(events.size(), expected.size()); ++i)
+    if (!(events[i] == expected[i]))
+      {
+	std::cerr << "Interaction event " << i << " is (" << events[i].p1 << ", " << events[i].p2
+		  << ") type " << events[i].type << " after the incremental resize, but ("
+		  << expected[i].p1 << ", " << expected[i].p2 << ") type " << expected[i].type
+		  << " after the rebuild" << std::endl;
+	++errors;
+	break;
+      }
+
+  //The event times are calculated at different points in the
+  //simulation, so the configurations only agree to round-off (which
+  //grows exponentially with the number of collisions)
+  incremental.dynamics->updateAllParticles();
+  rebuilt.dynamics->updateAllParticles();
+  double maxError(0);
+  for (size_t id(0); id < incremental.N; ++id)
+    {
+      Vector diff = incremental.particles[id].getPosition() - rebuilt.particles[id].getPosition();
+      rebuilt.BCs->applyBC(diff);
+      maxError = std::max(maxError, diff.nrm());
+    }
+
+  std::cout << events.size() << " interaction events, maximum position difference " << maxError << std::endl;
+
+  if (maxError > 1e-8)
+    {
+      std::cerr << "The configurations differ by up to " << maxError << std::endl;
+      ++errors;
+    }
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/ensemble.hpp>
+#include <dynamo/globals/cells.hpp>
+#include <dynamo/interactions/squarewell.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/outputplugins/contactmap.hpp>
+#include <dynamo/schedulers/include.hpp>
+#include <dynamo/schedulers/sorters/include.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+#include <unordered_map>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <map>
+
+using namespace dynamo;
+
+/* Checks the contact map histogram of OPContactMap, which only
+   subscribes to the capture and release events of its Interaction,
+   against a plugin which receives every event and sums their times
+   between the map changes.
+ */
+
+//! \brief A reference contact map histogram, using every event.
+class OPReferenceMap: public OutputPlugin
+{
+public:
+  OPReferenceMap(const Simulation* sim):
+    OutputPlugin(sim, "ReferenceMap")
+  {}
+
+  virtual void initialise()
+  {
+    _capture = std::dynamic_pointer_cast<ICapture>(Sim->interactions["Bulk"]);
+    _weight = 0;
+    _current = findMap();
+  }
+
+  virtual void eventUpdate(const IntEvent& event, const PairEventData&)
+  {
+    _weight += event.getdt();
+    if ((event.getInteractionID() == _capture->getID())
+	&& ((event.getType() == STEP_IN) || (event.getType() == STEP_OUT)))
+      {
+	flush();
+	const size_t oldMap = _current;
+	_current = findMap();
+	++links[std::make_pair(oldMap, _current)];
+      }
+  }
+
+  virtual void eventUpdate(const GlobalEvent& event, const NEventData&) { _weight += event.getdt(); }
+  virtual void eventUpdate(const LocalEvent& event, const NEventData&) { _weight += event.getdt(); }
+  virtual void eventUpdate(const System&, const NEventData&, const double& dt) { _weight += dt; }
+
+  virtual void replicaExchange(OutputPlugin&) {}
+
+  void flush()
+  {
+    weights[_current] += _weight;
+    _weight = 0;
+  }
+
+  //! \brief The time spent in each map, indexed by the order the maps were found.
+  std::vector<double> weights;
+  std::map<std::pair<size_t, size_t>, size_t> links;
+
+private:
+  size_t findMap()
+  {
+    //The maps are identified by their hash
+    const size_t hash = static_cast<const detail::CaptureMap&>(*_capture).hash();
+    std::unordered_map<size_t, size_t>::const_iterator it = _mapIDs.find(hash);
+    if (it != _mapIDs.end())
+      return it->second;
+
+    _mapIDs[hash] = weights.size();
+    weights.push_back(0);
+    return weights.size() - 1;
+  }
+
+  shared_ptr<ICapture> _capture;
+  std::unordered_map<size_t, size_t> _mapIDs;
+  size_t _current;
+  double _weight;
+};
+
+int main()
+{
+  //A small square well system, so that pairs are often
+  //captured and released and some contact maps recur
+  const size_t n = 2;
+  const double L = 4;
+
+  Simulation sim;
+  sim.primaryCellSize = Vector(L, L, L);
+  sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  sim.BCs = shared_ptr<BoundaryCondition>(new BCPeriodic(&sim));
+  sim.ptrScheduler = shared_ptr<SNeighbourList>(new SNeighbourList(&sim, new FELBoundedPQ<PELMinMax<3> >()));
+  sim.globals.push_back(shared_ptr<Global>(new GCells(&sim, "SchedulerNBList")));
+  sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new ISquareWell(&sim, 1.0, 1.5, 1.0, 1.0, new IDPairRangeAll(), "Bulk")));
+  sim.addSpecies(shared_ptr<Species>(new SpPoint(&sim, new IDRangeAll(&sim), 1.0, "Bulk", 0, "Bulk")));
+
+  std::mt19937 RNG(1234);
+  std::normal_distribution<double> velocity;
+  for (size_t i(0); i < n; ++i)
+    for (size_t j(0); j < n; ++j)
+      for (size_t k(0); k < n; ++k)
+	sim.particles.push_back(Particle(Vector((i + 0.5) / n - 0.5, (j + 0.5) / n - 0.5, (k + 0.5) / n - 0.5) * L,
+					 Vector(velocity(RNG), velocity(RNG), velocity(RNG)), sim.particles.size()));
+  sim.N = sim.particles.size();
+  sim.ensemble = Ensemble::loadEnsemble(sim);
+
+  sim.addOutputPlugin("Misc");
+  sim.addOutputPlugin("Contactmap:Interaction=Bulk");
+  shared_ptr<OPReferenceMap> reference(new OPReferenceMap(&sim));
+  sim.outputPlugins.push_back(reference);
+
+  sim.endEventCount = 20000;
+  sim.status = CONFIG_LOADED;
+  sim.initialise();
+  sim.runSimulation(true);
+  reference->flush();
+
+  std::ostringstream os;
+  os << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+  {
+    magnet::xml::XmlStream XML(os);
+    sim.getOutputPlugin<OPContactMap>()->output(XML);
+  }
+
+  magnet::xml::Document doc;
+  doc.getStoredXMLData() = os.str();
+  doc.parseData();
+  const magnet::xml::Node contactMap = doc.getNode("ContactMap");
+
+  size_t errors(0);
+  double totalWeight(0);
+  for (const double weight : reference->weights)
+    totalWeight += weight;
+
+  const size_t mapCount = contactMap.getNode("Maps").getAttribute("Count").as<size_t>();
+  if (mapCount != reference->weights.size())
+    {
+      std::cerr << "OPContactMap found " << mapCount << " maps, but the reference found "
+		<< reference->weights.size() << std::endl;
+      ++errors;
+    }
+  else
+    for (magnet::xml::Node node = contactMap.getNode("Maps").fastGetNode("Map"); node.valid(); ++node)
+      {
+	const size_t ID = node.getAttribute("ID").as<size_t>();
+	const double weight = node.getAttribute("Weight").as<double>();
+	const double expected = reference->weights[ID] / totalWeight;
+	if (std::abs(weight - expected) > 1e-10 * std::max(expected, 1e-3))
+	  {
+	    std::cerr << "Map " << ID << " has a weight of " << weight << ", but the reference weight is "
+		      << expected << std::endl;
+	    ++errors;
+	  }
+      }
+
+  const size_t linkCount = contactMap.getNode("Links").getAttribute("Count").as<size_t>();
+  if (linkCount != reference->links.size())
+    {
+      std::cerr << "OPContactMap found " << linkCount << " links, but the reference found "
+		<< reference->links.size() << std::endl;
+      ++errors;
+    }
+  else
+    for (magnet::xml::Node node = contactMap.getNode("Links").fastGetNode("Link"); node.valid(); ++node)
+      {
+	const std::pair<size_t, size_t> link(node.getAttribute("Source").as<size_t>(), node.getAttribute("Target").as<size_t>());
+	const size_t occurrences = node.getAttribute("Occurrences").as<size_t>();
+	if (reference->links[link] != occurrences)
+	  {
+	    std::cerr << "Link " << link.first << "->" << link.second << " occurred " << occurrences
+		      << " times, but the reference found " << reference->links[link] << std::endl;
+	    ++errors;
+	  }
+      }
+
+  std::cout << mapCount << " maps and " << linkCount << " links, " << errors << " errors" << std::endl;
+
+  //Some of the maps must have been revisited
+  if (linkCount <= mapCount)
+    {
+      std::cerr << "Too few contact map changes were found" << std::endl;
+      ++errors;
+    }
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <dynamo/simulation.hpp>
+#include <dynamo/BC/include.hpp>
+#include <dynamo/dynamics/newtonian.hpp>
+#include <dynamo/dynamics/gravity.hpp>
+#include <dynamo/interactions/hardsphere.hpp>
+#include <dynamo/interactions/squarewell.hpp>
+#include <dynamo/interactions/stepped.hpp>
+#include <dynamo/interactions/potentials/potential.hpp>
+#include <dynamo/interactions/intEvent.hpp>
+#include <dynamo/species/point.hpp>
+#include <dynamo/ranges/include.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace dynamo;
+
+/* Checks the batched event prediction of the Interactions
+   (Interaction::getEvents, used by Scheduler::addEvents) gives
+   exactly the same events as testing each pair with
+   Interaction::getEvent. Every pair of a random configuration is
+   tested for each Interaction, boundary condition and Dynamics. The
+   Newtonian Dynamics use the specialised pair kernels, and the
+   gravity Dynamics the generic PairBatch root searches.
+ */
+
+std::mt19937 RNG(1234);
+
+enum BCType { NONE_BC, PERIODIC_BC, LEESEDWARDS_BC };
+enum DynamicsType { NEWTONIAN_DYN, GRAVITY_DYN };
+enum InteractionType { HARDSPHERE_INT, SQUAREWELL_INT, STEPPED_INT };
+
+const char* BCNames[] = {"None", "Periodic", "LeesEdwards"};
+const char* DynamicsNames[] = {"Newtonian", "Gravity"};
+const char* InteractionNames[] = {"HardSphere", "SquareWell", "Stepped"};
+
+size_t test(BCType bc, DynamicsType dyn, InteractionType interactionType)
+{
+  const size_t N = 400;
+  const double L = 10;
+
+  Simulation sim;
+  sim.primaryCellSize = Vector(L, L, L);
+
+  switch (bc)
+    {
+    case NONE_BC: sim.BCs = shared_ptr<BoundaryCondition>(new BCNone(&sim)); break;
+    case PERIODIC_BC: sim.BCs = shared_ptr<BoundaryCondition>(new BCPeriodic(&sim)); break;
+    case LEESEDWARDS_BC:
+      sim.BCs = shared_ptr<BoundaryCondition>(new BCLeesEdwards(&sim));
+      //Shear the boundaries so the images are offset
+      sim.BCs->update(1.37);
+      break;
+    }
+
+  if (dyn == NEWTONIAN_DYN)
+    sim.dynamics = shared_ptr<Dynamics>(new DynNewtonian(&sim));
+  else
+    sim.dynamics = shared_ptr<Dynamics>(new DynGravity(&sim, Vector(0, -1, 0)));
+
+  switch (interactionType)
+    {
+    case HARDSPHERE_INT:
+      sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new IHardSphere(&sim, 1.0, 1.0, new IDPairRangeAll(), "Bulk")));
+      break;
+    case SQUAREWELL_INT:
+      sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new ISquareWell(&sim, 1.0, 1.5, 1.0, 1.0, new IDPairRangeAll(), "Bulk")));
+      break;
+    case STEPPED_INT:
+      {
+	std::vector<std::pair<double, double> > steps;
+	steps.push_back(std::make_pair(1.5, 0.5));
+	steps.push_back(std::make_pair(1.25, 1.0));
+	steps.push_back(std::make_pair(1.0, 1e300));
+	shared_ptr<Potential> potential(new PotentialStepped(steps, false));
+	sim.interactions.push_back(shared_ptr<dynamo::Interaction>(new IStepped(&sim, potential, new IDPairRangeAll(), "Bulk", 1.0, 1.0)));
+	break;
+      }
+    }
+
+  sim.addSpecies(shared_ptr<Species>(new SpPoint(&sim, new IDRangeAll(&sim), 1.0, "Bulk", 0, "Bulk")));
+
+  //A dense random configuration, so that many pairs are within the
+  //wells and steps (or overlapping) and have events
+  std::uniform_real_distribution<double> position(-0.5 * L, 0.5 * L);
+  std::normal_distribution<double> velocity;
+  for (size_t i(0); i < N; ++i)
+    sim.particles.push_back(Particle(Vector(position(RNG), position(RNG), position(RNG)),
+				     Vector(velocity(RNG), velocity(RNG), velocity(RNG)), i));
+  sim.N = sim.particles.size();
+
+  for (shared_ptr<Species>& species : sim.species)
+    species->initialise();
+  sim.species.updateTables(sim.N);
+  sim.dynamics->initialise();
+  //This also builds the capture maps of the square well and stepped
+  //Interactions from the configuration
+  sim.interactions[0]->initialise(0);
+
+  const dynamo::Interaction& interaction = *sim.interactions[0];
+
+  size_t errors(0), eventCount(0);
+  std::vector<size_t> ids;
+  std::vector<IntEvent> batchEvents, scalarEvents;
+  for (const Particle& p1 : sim.particles)
+    {
+      ids.clear();
+      for (size_t id2(0); id2 < N; ++id2)
+	if (id2 != p1.getID())
+	  ids.push_back(id2);
+
+      batchEvents.clear();
+      interaction.getEvents(p1, ids, batchEvents);
+
+      scalarEvents.clear();
+      for (const size_t id2 : ids)
+	{
+	  const IntEvent event = interaction.getEvent(p1, sim.particles[id2]);
+	  if (event.getType() != NONE)
+	    scalarEvents.push_back(event);
+	}
+
+      eventCount += scalarEvents.size();
+
+      if (batchEvents.size() != scalarEvents.size())
+	{
+	  if (errors++ < 10)
+	    std::cerr << "Particle " << p1.getID() << ": " << batchEvents.size() << " batched events but "
+		      << scalarEvents.size() << " scalar events" << std::endl;
+	  continue;
+	}
+
+      for (size_t i(0); i < batchEvents.size(); ++i)
+	if ((batchEvents[i].getParticle2ID() != scalarEvents[i].getParticle2ID())
+	    || (batchEvents[i].getType() != scalarEvents[i].getType())
+	    || (batchEvents[i].getdt() != scalarEvents[i].getdt()))
+	  if (errors++ < 10)
+	    std::cerr << "Pair (" << p1.getID() << ", " << scalarEvents[i].getParticle2ID() << "): batched event "
+		      << batchEvents[i].getType() << " with p2=" << batchEvents[i].getParticle2ID()
+		      << " at dt=" << batchEvents[i].getdt() << " but scalar event "
+		      << scalarEvents[i].getType() << " at dt=" << scalarEvents[i].getdt() << std::endl;
+    }
+
+  std::cout << InteractionNames[interactionType] << " " << DynamicsNames[dyn] << " " << BCNames[bc]
+	    << ": " << eventCount << " events, " << errors << " mismatches" << std::endl;
+
+  //The configuration must have tested some events, and for the
+  //capture Interactions some captured pairs
+  if (!eventCount)
+    {
+      std::cerr << "No events were predicted" << std::endl;
+      ++errors;
+    }
+
+  const ICapture* capture = dynamic_cast<const ICapture*>(&interaction);
+  if (capture && capture->empty())
+    {
+      std::cerr << "No pairs were captured" << std::endl;
+      ++errors;
+    }
+
+  return errors;
+}
+
+int main()
+{
+  std::cerr.precision(17);
+  size_t errors(0);
+
+  for (int interaction(HARDSPHERE_INT); interaction <= STEPPED_INT; ++interaction)
+    for (int dyn(NEWTONIAN_DYN); dyn <= GRAVITY_DYN; ++dyn)
+      for (int bc(NONE_BC); bc <= LEESEDWARDS_BC; ++bc)
+	errors += test(BCType(bc), DynamicsType(dyn), InteractionType(interaction));
+
+  if (errors)
+    {
+      std::cerr << errors << " errors in the batched event prediction" << std::endl;
+      return 1;
+    }
+
+  return 0;
+}
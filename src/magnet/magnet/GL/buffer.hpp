@@ -101,8 +101,27 @@ namespace magnet {
 	glBufferData(buffer_targets::ARRAY, _size * sizeof(T), ptr, usage);
       }
 
+      /*! \brief Overwrites a range of the Buffer's elements.
+
+	Unlike \ref init(), this does not reallocate the buffer, so
+	only the passed data is transferred to the device.
+
+        \param offset The index of the first element to overwrite.
+        \param count The number of elements to overwrite.
+        \param ptr A pointer to the new data of the elements.
+       */
+      inline void update(size_t offset, size_t count, const T* ptr)
+      {
+	initTest();
+	if (offset + count > _size)
+	  M_throw() << "Updating elements past the end of the GL::Buffer.";
+
+	bind(buffer_targets::ARRAY);
+	glBufferSubData(buffer_targets::ARRAY, offset * sizeof(T), count * sizeof(T), ptr);
+      }
+
       //! \brief Attach the Buffer to a OpenGL target
-      inline void bind(buffer_targets::Enum target) const 
+      inline void bind(buffer_targets::Enum target) const
       {
 	glBindBufferARB(target, _buffer);	
       }
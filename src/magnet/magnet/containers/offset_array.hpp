@@ -0,0 +1,114 @@
+/*    dynamo:- Event driven molecular dynamics simulator
+ *    http://www.dynamomd.org
+ *    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+ *
+ *    This program is free software: you can redistribute it and/or
+ *    modify it under the terms of the GNU General Public License
+ *    version 3 as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace magnet {
+  namespace containers {
+    /*! \brief A dense array addressed by signed integer indices.
+
+      This is a replacement for a std::unordered_map<long, T> when
+      the keys are clustered, e.g., the bins of a function of the
+      energy. The values are stored contiguously, from the lowest to
+      the highest index assigned, so a lookup is a range check and an
+      offset instead of a hash.
+
+      Reading an index outside of the stored range returns a default
+      value, and does not store anything. Writing to an index outside
+      of the range extends the range to include it, filling any new
+      elements with the default value.
+
+      \tparam T The type stored by the OffsetArray.
+    */
+    template<class T>
+    class OffsetArray
+    {
+    public:
+      /*! \brief Default constructor.
+
+	\param defaultValue The value of all elements that have not
+	been written.
+       */
+      OffsetArray(const T& defaultValue = T()):
+	_offset(0),
+	_default(defaultValue)
+      {}
+
+      /*! \brief Returns the element at an index, or the default
+        value if it is outside the stored range.
+       */
+      const T& operator()(long i) const
+      {
+	//The unsigned comparison also rejects indices below _offset
+	const size_t j = i - _offset;
+	return (j < _data.size()) ? _data[j] : _default;
+      }
+
+      /*! \brief Access an element, extending the stored range to
+        include it if required.
+       */
+      T& operator[](long i)
+      {
+	if (_data.empty())
+	  {
+	    _offset = i;
+	    _data.push_back(_default);
+	    return _data.front();
+	  }
+
+	if (i < _offset)
+	  {
+	    _data.insert(_data.begin(), _offset - i, _default);
+	    _offset = i;
+	  }
+	else if (i >= _offset + long(_data.size()))
+	  _data.resize(i - _offset + 1, _default);
+
+	return _data[i - _offset];
+      }
+
+      //! \brief The lowest index in the stored range.
+      long begin_index() const { return _offset; }
+
+      //! \brief One past the highest index in the stored range.
+      long end_index() const { return _offset + _data.size(); }
+
+      //! \brief Tests if an index is inside the stored range.
+      bool inRange(long i) const
+      { return size_t(i - _offset) < _data.size(); }
+
+      //! \brief The number of elements in the stored range.
+      size_t size() const { return _data.size(); }
+
+      bool empty() const { return _data.empty(); }
+
+      //! \brief Removes all elements.
+      void clear() { _data.clear(); _offset = 0; }
+
+      //! \brief The value of elements that have not been written.
+      const T& getDefault() const { return _default; }
+
+    protected:
+      long _offset;
+      T _default;
+      std::vector<T> _data;
+    };
+  }
+}
+
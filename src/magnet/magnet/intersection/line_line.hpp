@@ -19,6 +19,7 @@
 #include <magnet/math/vector.hpp>
 #include <magnet/math/quaternion.hpp>
 #include <magnet/math/frenkelroot.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
 
 namespace magnet {
   namespace intersection {
@@ -160,6 +161,13 @@ namespace magnet {
       //Shift the lower bound up so we don't find the same root again
       double t_min = skip_zero ? fabs(2.0 * fL.eval<1>()) / fL.max<2>() : 0;
     
+      //The lines can only touch while their centres are closer than
+      //their length (the margin guards against rounding)
+      std::pair<double,double> bsw = ray_sphere_window(rij, vij, length * (1 + 1e-10));
+      t_min = std::max(bsw.first, t_min);
+      t_max = std::min(bsw.second, t_max);
+      if (t_max <= t_min) return std::pair<bool, double>(false, HUGE_VAL);
+
       //Find window delimited by discs
       std::pair<double,double> dtw = fL.discIntersectionWindow();
       t_min = std::max(dtw.first, t_min);
@@ -19,6 +19,7 @@
 #include <magnet/math/vector.hpp>
 #include <magnet/math/quaternion.hpp>
 #include <magnet/intersection/generic_algorithm.hpp>
+#include <magnet/intersection/ray_sphere.hpp>
 
 namespace magnet {
   namespace intersection {
@@ -195,7 +196,25 @@ namespace magnet {
       };
     }
 
+    namespace detail {
+      /*! \brief The distance between the centres of two bodies
+	  within which their offcentre spheres may touch.
+
+	  Each offcentre sphere stays within a sphere about the centre
+	  of its body, of radius |u| + d/2. A small margin keeps any
+	  test using this bound conservative against rounding.
+       */
+      inline double offcentre_bounding_distance(const math::Vector& relativeposi, const math::Vector& relativeposj,
+						const double diameteri, const double diameterj)
+      { return (relativeposi.nrm() + relativeposj.nrm() + 0.5 * (diameteri + diameterj)) * (1 + 1e-10); }
+    }
+
     /*! \brief Intersection test for offcentre spheres.
+
+      The root search is restricted to the window in which the
+      bounding spheres of the two offcentre spheres overlap, and pairs
+      whose bounding spheres never meet before t_max are rejected
+      without a root search.
      */
     inline std::pair<bool, double> 
     offcentre_spheres(const math::Vector& rij, const math::Vector& vij, const math::Vector& angvi, const math::Vector& angvj,
@@ -206,8 +225,26 @@ namespace magnet {
       if (std::isinf(t_max)) M_throw() << "Cannot perform root search in infinite intervals";
 #endif
 
-      detail::OffcentreSpheresOverlapFunction f(rij, vij, angvi, angvj, relativeposi, relativeposj, diameteri, diameterj, maxdist);
-      return magnet::intersection::generic_algorithm(f, t_max, std::min(diameteri, diameterj) * 1e-10);
+      const double bound = detail::offcentre_bounding_distance(relativeposi, relativeposj, diameteri, diameterj);
+      const std::pair<double, double> window = ray_sphere_window(rij, vij, bound);
+      if (window.first >= t_max) return std::pair<bool, double>(false, HUGE_VAL);
+      t_max = std::min(t_max, window.second);
+
+      //As the separation of the centres is convex in time, its largest
+      //value in the window is at one of the ends. This tightens the
+      //bounds on the derivatives of the overlap function.
+      const double windowdist = std::isinf(t_max) ? bound : std::max(rij.nrm(), (rij + vij * t_max).nrm()) * (1 + 1e-10);
+      detail::OffcentreSpheresOverlapFunction f(rij, vij, angvi, angvj, relativeposi, relativeposj, diameteri, diameterj, 
+						std::min(std::min(maxdist, bound), windowdist));
+      const double err = std::min(diameteri, diameterj) * 1e-10;
+
+      if (window.first == 0)
+	return magnet::intersection::generic_algorithm(f, t_max, err);
+
+      f.stream(window.first);
+      std::pair<bool, double> root = magnet::intersection::generic_algorithm(f, t_max - window.first, err);
+      if (root.second != HUGE_VAL) root.second += window.first;
+      return root;
     }
 
     /*! \brief Intersection test for growing offcentre spheres.
@@ -222,7 +259,21 @@ namespace magnet {
 #endif
 
       detail::OffcentreGrowingSpheresOverlapFunction f(rij, vij, angvi, angvj, relativeposi, relativeposj, diameteri, diameterj, maxdist, t, invgamma, t_max);
-      return magnet::intersection::generic_algorithm(f, t_max, std::min(diameteri, diameterj) * 1e-10);
+      const double err = std::min(diameteri, diameterj) * 1e-10;
+
+      //Skip ahead to when the (growing) bounding spheres first meet
+      const double bound = detail::offcentre_bounding_distance(relativeposi, relativeposj, diameteri, diameterj);
+      const double growth = 1 + t * invgamma;
+      if (rij.nrm2() <= growth * growth * bound * bound)
+	return magnet::intersection::generic_algorithm(f, t_max, err);
+
+      const double t_min = std::max(0.0, ray_growing_sphere<false>(rij, vij, bound, invgamma, t));
+      if (t_min >= t_max) return std::pair<bool, double>(false, HUGE_VAL);
+
+      f.stream(t_min);
+      std::pair<bool, double> root = magnet::intersection::generic_algorithm(f, t_max - t_min, err);
+      if (root.second != HUGE_VAL) root.second += t_min;
+      return root;
     }
   }
 }
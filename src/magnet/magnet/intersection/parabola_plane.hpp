@@ -77,5 +77,96 @@ namespace magnet {
 	  return std::min(roots.first, roots.second);	  
 	}
     }
+
+    /*! \brief A batched form of the parabola_plane intersection test.
+
+      The parabolas and planes are passed in structure-of-arrays
+      form, so that the loop is free of branches and may be
+      vectorised by the compiler. Each entry gives exactly the same
+      result as the scalar parabola_plane test. The rare entries
+      where the roots of the quadratic are complex (due to rounding)
+      are passed to the scalar test.
+
+      \param T The origins of the parabolas relative to a point on
+      each plane, as NDIM arrays of components.
+      \param D The velocities of the parabolas.
+      \param A The accelerations of the parabolas.
+      \param Norm The normals of the planes.
+      \param d The thicknesses of the planes.
+      \param dt Output array of times until the intersections, or
+      HUGE_VAL if there is no intersection.
+      \param N The number of parabolas in the batch.
+     */
+    inline void parabola_plane(const double* const T[NDIM], const double* const D[NDIM], const double* const A[NDIM],
+			       const double* const Norm[NDIM], const double* d, double* dt, const size_t N)
+    {
+      const size_t blocksize = 64;
+      bool fallback[blocksize];
+
+      for (size_t start(0); start < N; start += blocksize)
+	{
+	  const size_t n = std::min(blocksize, N - start);
+
+	  for (size_t j(0); j < n; ++j)
+	    {
+	      const size_t i = start + j;
+	      //The dot products are summed in the same order as in the
+	      //Vector class, so that the signs of zero results match. The
+	      //velocity is also projected onto the flipped normal, as
+	      //negating a sum of zeros may not give the sum of the
+	      //negated zeros.
+	      double adot = A[0][i] * Norm[0][i], rdot = T[0][i] * Norm[0][i];
+	      double vdot = D[0][i] * Norm[0][i], vdot_flip = D[0][i] * -Norm[0][i];
+	      for (size_t dim(1); dim < NDIM; ++dim)
+		{
+		  adot += A[dim][i] * Norm[dim][i];
+		  rdot += T[dim][i] * Norm[dim][i];
+		  vdot += D[dim][i] * Norm[dim][i];
+		  vdot_flip += D[dim][i] * -Norm[dim][i];
+		}
+
+	      //Point the normal towards the particle
+	      const bool flip = rdot < 0;
+	      //The ray_plane test negates the dot products instead
+	      const double ray_v = flip ? -vdot : vdot;
+	      adot = flip ? -adot : adot;
+	      rdot = flip ? -rdot : rdot;
+	      vdot = flip ? vdot_flip : vdot;
+	      const double ray_root = (ray_v >= 0) ? HUGE_VAL : std::max(-(rdot - d[i]) / ray_v, 0.0);
+
+	      const double arg = vdot * vdot - 2 * (rdot - d[i]) * adot;
+	      const double minimum = - vdot / adot;
+
+	      //The roots of the quadratic, as in quadraticEquation
+	      const double a = 0.5 * adot, c = rdot - d[i];
+	      const double discriminant = vdot * vdot - 4 * a * c;
+	      const double sqrtdisc = std::sqrt(std::max(discriminant, 0.0));
+	      const double q = -0.5 * (vdot + ((vdot < 0) ? -sqrtdisc : sqrtdisc));
+	      const double root1 = q / a, root2 = c / q;
+
+	      const bool overlapped = (rdot < d[i]) & (vdot < 0);
+	      const double hit_root = (arg < 0) ? minimum : std::max(root1, root2);
+	      const bool miss = (arg < 0) | (minimum < 0);
+	      const double curve_root = miss ? HUGE_VAL : std::min(root1, root2);
+	      const double root = overlapped ? 0 : ((adot < 0) ? hit_root : curve_root);
+	      dt[i] = (adot == 0) ? ray_root : root;
+
+	      //Where the roots are used, but the quadratic is degenerate
+	      //or its roots are complex (due to rounding), the scalar
+	      //test is used
+	      const bool rootsUsed = (adot != 0) & !overlapped & !(arg < 0) & ((adot < 0) | !miss);
+	      fallback[j] = rootsUsed & ((a == 0) | (discriminant < 0));
+	    }
+
+	  for (size_t j(0); j < n; ++j)
+	    if (fallback[j])
+	      {
+		const size_t i = start + j;
+		dt[i] = parabola_plane(math::Vector(T[0][i], T[1][i], T[2][i]), math::Vector(D[0][i], D[1][i], D[2][i]),
+				       math::Vector(A[0][i], A[1][i], A[2][i]), math::Vector(Norm[0][i], Norm[1][i], Norm[2][i]), 
+				       d[i]);
+	      }
+	}
+    }
   }
 }
@@ -33,6 +33,173 @@ namespace magnet {
 	
 	double coeffs[5];
       };
+
+      //! \brief The number of intersections the batched tests work on at a time.
+      const size_t parabolaBlockSize = 64;
+
+      /*! \brief The quartic overlap function of a parabola-sphere test.
+
+	\param sign +1 for a sphere, -1 for an inverse sphere.
+       */
+      inline void parabolaSphereFunc(QuarticFunc& f, const double G2, const double GD, const double D2,
+				     const double GT, const double DT, const double T2, const double& r, 
+				     const double sign)
+      {
+	f.coeffs[0] = sign * (0.25 * G2);
+	f.coeffs[1] = sign * GD;
+	f.coeffs[2] = sign * (D2 + GT);
+	f.coeffs[3] = sign * (2 * DT);
+	f.coeffs[4] = sign * (T2 - r * r);
+      }
+
+      //! \brief Sort the (at most three) turning points in ascending order.
+      inline void sortRoots(double* roots, const size_t rootCount)
+      {
+	if (rootCount < 2) return;
+	if (roots[1] < roots[0]) std::swap(roots[0], roots[1]);
+	if (rootCount < 3) return;
+	if (roots[2] < roots[1]) std::swap(roots[1], roots[2]);
+	if (roots[1] < roots[0]) std::swap(roots[0], roots[1]);
+      }
+
+      /*! \brief The first root of a parabola-sphere overlap function,
+	given the (unsorted) turning points of the function.
+       */
+      inline double parabolaSphereRoot(const QuarticFunc& f, double* roots, const size_t rootCount, const double& r)
+      {
+	//This is our lengthscale to which we bisect the roots
+	const double rootthreshold = 1e-16 * r;
+
+	//Sort the roots in ascending order
+	sortRoots(roots, rootCount);
+	if ((roots[0] > 0) && (f(roots[0]) < 0))
+	  {
+	    if (f(0) <= 0) 
+	      return 0;
+	    else
+	      return magnet::math::bisect(f, 0, roots[0], rootthreshold);
+	  }
+
+	if ((rootCount == 3) && (roots[2] > 0) && (f(roots[2]) < 0))
+	  {
+	    double tmin = std::max(0.0, roots[1]);
+	    if (f(tmin) <= 0)
+	      return tmin;
+	    else
+	      return magnet::math::bisect(f, tmin, roots[2], rootthreshold);
+	  }
+	return HUGE_VAL;
+      }
+
+      /*! \brief The first root of a parabola-inverse sphere overlap
+	function, given the (unsorted) turning points of the function.
+
+	\param G2 The squared magnitude of the acceleration.
+       */
+      inline double parabolaInvSphereRoot(const QuarticFunc& f, double* roots, const size_t rootCount, const double& r,
+					  const double G2)
+      {
+	//This is our lengthscale to which we bisect the roots
+	const double rootthreshold = 1e-16 * r;
+
+	//Sort the roots in ascending order
+	sortRoots(roots, rootCount);
+
+	if ((rootCount == 3) && (roots[1] > 0) && (f(roots[1]) < 0))
+	  {
+	    double tmin = std::max(0.0, roots[0]);
+	    if (f(tmin) <= 0)
+	      return tmin;
+	    else
+	      return magnet::math::bisect(f, tmin, roots[1], rootthreshold);
+	  }
+      
+	double tlast = roots[rootCount - 1];
+      
+	if (f(tlast) <= 0) return std::max(0.0, tlast);
+
+	if ((tlast < 0) && (f(0) <= 0)) return 0;
+      
+	double t0 = std::max(0.0, tlast);
+      
+	double deltate = std::pow(4 * r * r / G2, 0.25);
+      
+	while (f(t0 + deltate) >= 0)
+	  {
+	    t0 += deltate;
+	    deltate *= 2;
+	  }
+
+	return magnet::math::bisect(f, t0, t0+deltate, rootthreshold);
+      }
+
+      /*! \brief The batched form of the parabola-sphere tests.
+
+	The coefficients of the overlap functions and the turning
+	points of the functions (the roots of their cubic
+	derivatives) are found in branch free loops over blocks of
+	intersections, which the compiler may vectorise. Only the
+	final bisection for the root is performed per intersection.
+
+	\tparam inverse If true, this is the parabola_invsphere test.
+       */
+      template<bool inverse>
+      inline void parabola_sphere_batch(const double* const T[NDIM], const double* const D[NDIM], const double* const G[NDIM],
+					const double* r, double* dt, const size_t N)
+      {
+	const double sign = inverse ? -1 : 1;
+	double G2[parabolaBlockSize], GD[parabolaBlockSize], D2[parabolaBlockSize], GT[parabolaBlockSize], 
+	  DT[parabolaBlockSize], T2[parabolaBlockSize];
+	double p[parabolaBlockSize], q[parabolaBlockSize], s[parabolaBlockSize];
+	double root1[parabolaBlockSize], root2[parabolaBlockSize], root3[parabolaBlockSize];
+	double* const roots[3] = {root1, root2, root3};
+	size_t rootCount[parabolaBlockSize];
+
+	for (size_t start(0); start < N; start += parabolaBlockSize)
+	  {
+	    const size_t n = std::min(parabolaBlockSize, N - start);
+
+	    for (size_t i(0); i < n; ++i)
+	      {
+		const size_t id = start + i;
+		//The dot products are summed in the same order as in the
+		//Vector class, so that the signs of zero results match
+		G2[i] = G[0][id] * G[0][id];
+		GD[i] = G[0][id] * D[0][id];
+		D2[i] = D[0][id] * D[0][id];
+		GT[i] = G[0][id] * T[0][id];
+		DT[i] = D[0][id] * T[0][id];
+		T2[i] = T[0][id] * T[0][id];
+		for (size_t dim(1); dim < NDIM; ++dim)
+		  {
+		    G2[i] += G[dim][id] * G[dim][id];
+		    GD[i] += G[dim][id] * D[dim][id];
+		    D2[i] += D[dim][id] * D[dim][id];
+		    GT[i] += G[dim][id] * T[dim][id];
+		    DT[i] += D[dim][id] * T[dim][id];
+		    T2[i] += T[dim][id] * T[dim][id];
+		  }
+		
+		//The normalised cubic derivative of the overlap function
+		const double A = sign * (0.25 * G2[i]);
+		p[i] = (sign * GD[i]) * 3 / (4 * A);
+		q[i] = (sign * (D2[i] + GT[i])) * 2 / (4 * A);
+		s[i] = (sign * (2 * DT[i])) * 1 / (4 * A);
+	      }
+
+	    magnet::math::cubicSolve(p, q, s, roots, rootCount, n);
+
+	    for (size_t i(0); i < n; ++i)
+	      {
+		const size_t id = start + i;
+		QuarticFunc f;
+		parabolaSphereFunc(f, G2[i], GD[i], D2[i], GT[i], DT[i], T2[i], r[id], sign);
+		double lane[3] = {root1[i], root2[i], root3[i]};
+		dt[id] = inverse ? parabolaInvSphereRoot(f, lane, rootCount[i], r[id], G2[i])
+		  : parabolaSphereRoot(f, lane, rootCount[i], r[id]);
+	      }
+	  }
+      }
     }
 
     /*! \brief A parabolic(ray)-sphere intersection test with backface culling.
@@ -45,15 +212,8 @@ namespace magnet {
     */
     inline double parabola_sphere(const math::Vector& T, const math::Vector& D, const math::Vector& G, const double& r)
     {
-      //This is our lengthscale to which we bisect the roots
-      const double rootthreshold = 1e-16 * r;
-      
       detail::QuarticFunc f;
-      f.coeffs[0] = 0.25 * G.nrm2();
-      f.coeffs[1] = G | D;
-      f.coeffs[2] = D.nrm2() + (G | T);
-      f.coeffs[3] = 2 * (D | T);
-      f.coeffs[4] = T.nrm2()- r * r;
+      detail::parabolaSphereFunc(f, G.nrm2(), G | D, D.nrm2(), G | T, D | T, T.nrm2(), r, 1);
       
       //We calculate the roots of the cubic differential of F
       //\f$F=A t^4 + B t^3 + C t^2 + D t + E == 0\f$ taking the differential gives
@@ -65,27 +225,28 @@ namespace magnet {
 						  f.coeffs[3] * 1 / (4 * f.coeffs[0]),
 						  roots[0], roots[1], roots[2]);
       
-      //Sort the roots in ascending order
-      std::sort(roots, roots + rootCount);
-      if ((roots[0] > 0) && (f(roots[0]) < 0))
-	{
-	  if (f(0) <= 0) 
-	    return 0;
-	  else
-	    return magnet::math::bisect(f, 0, roots[0], rootthreshold);
-	}
-
-      if ((rootCount == 3) && (roots[2] > 0) && (f(roots[2]) < 0))
-	{
-	  double tmin = std::max(0.0, roots[1]);
-	  if (f(tmin) <= 0)
-	    return tmin;
-	  else
-	    return magnet::math::bisect(f, tmin, roots[2], rootthreshold);
-	}
-      return HUGE_VAL;
+      return detail::parabolaSphereRoot(f, roots, rootCount, r);
     }
 
+    /*! \brief A batched form of the parabola_sphere intersection test.
+
+      The parabolas are passed in structure-of-arrays form, as in the
+      batched ray_sphere test. Each entry gives exactly the same
+      result as the scalar parabola_sphere test.
+
+      \param T The origins of the parabolas relative to the sphere
+      centers, as NDIM arrays of components.
+      \param D The velocities of the parabolas.
+      \param G The accelerations of the parabolas.
+      \param r The radii of the spheres.
+      \param dt Output array of times until the intersections, or
+      HUGE_VAL if there is no intersection.
+      \param N The number of parabolas in the batch.
+    */
+    inline void parabola_sphere(const double* const T[NDIM], const double* const D[NDIM], const double* const G[NDIM],
+				const double* r, double* dt, const size_t N)
+    { detail::parabola_sphere_batch<false>(T, D, G, r, dt, N); }
+
     /*! \brief A parabolic(ray) inverse-sphere intersection test with
         backface culling.
       
@@ -97,15 +258,8 @@ namespace magnet {
     */
     inline double parabola_invsphere(const math::Vector& T, const math::Vector& D, const math::Vector& G, const double& r)
     {
-      //This is our lengthscale to which we bisect the roots
-      const double rootthreshold = 1e-16 * r;
-      
       detail::QuarticFunc f;
-      f.coeffs[0] = - (0.25 * G.nrm2());
-      f.coeffs[1] = - (G | D);
-      f.coeffs[2] = - (D.nrm2() + (G | T));
-      f.coeffs[3] = - (2 * (D | T));
-      f.coeffs[4] = - (T.nrm2() - r * r);
+      detail::parabolaSphereFunc(f, G.nrm2(), G | D, D.nrm2(), G | T, D | T, T.nrm2(), r, -1);
       
       //We calculate the roots of the cubic differential of F
       //\f$F=A t^4 + B t^3 + C t^2 + D t + E == 0\f$ taking the differential gives
@@ -117,35 +271,17 @@ namespace magnet {
 						  f.coeffs[3] * 1 / (4 * f.coeffs[0]),
 						  roots[0], roots[1], roots[2]);
       
-      //Sort the roots in ascending order
-      std::sort(roots, roots + rootCount);
+      return detail::parabolaInvSphereRoot(f, roots, rootCount, r, G.nrm2());
+    }
 
-      if ((rootCount == 3) && (roots[1] > 0) && (f(roots[1]) < 0))
-	{
-	  double tmin = std::max(0.0, roots[0]);
-	  if (f(tmin) <= 0)
-	    return tmin;
-	  else
-	    return magnet::math::bisect(f, tmin, roots[1], rootthreshold);
-	}
-      
-      double tlast = roots[rootCount - 1];
-      
-      if (f(tlast) <= 0) return std::max(0.0, tlast);
+    /*! \brief A batched form of the parabola_invsphere intersection test.
 
-      if ((tlast < 0) && (f(0) <= 0)) return 0;
-      
-      double t0 = std::max(0.0, tlast);
-      
-      double deltate = std::pow(4 * r * r / G.nrm2(), 0.25);
-      
-      while (f(t0 + deltate) >= 0)
-	{
-	  t0 += deltate;
-	  deltate *= 2;
-	}
-
-      return magnet::math::bisect(f, t0, t0+deltate, rootthreshold);
-    }
+      See the batched parabola_sphere test for a description of the
+      arguments. Each entry gives exactly the same result as the
+      scalar parabola_invsphere test.
+    */
+    inline void parabola_invsphere(const double* const T[NDIM], const double* const D[NDIM], const double* const G[NDIM],
+				   const double* r, double* dt, const size_t N)
+    { detail::parabola_sphere_batch<true>(T, D, G, r, dt, N); }
   }
 }
@@ -17,6 +17,7 @@
 
 #pragma once
 #include <magnet/math/vector.hpp>
+#include <utility>
 #include <math.h>
 
 namespace magnet {
@@ -73,6 +74,99 @@ namespace magnet {
       return std::max(0.0, - TD / D2);
     }
 
+    /*! \brief The window of time a ray spends inside a sphere.
+
+      Unlike ray_sphere(), a ray which starts inside the sphere is
+      treated as entering it immediately, even if it is moving away
+      from the center. This is used as a cheap, conservative prefilter
+      for the more expensive intersection tests of bodies which are
+      bounded by a sphere.
+
+      \param T The origin of the ray relative to the sphere center.
+      \param D The direction/velocity of the ray.
+      \param r The radius of the sphere.
+      \return The times the ray enters and leaves the sphere. The
+      entry time is zero if the ray starts inside the sphere, and
+      both times are HUGE_VAL if the ray never enters it.
+    */
+    inline std::pair<double, double> ray_sphere_window(const math::Vector& T, const math::Vector& D, const double& r)
+    {
+      if (T.nrm2() > r * r)
+	{
+	  const double entry = ray_sphere(T, D, r);
+	  if (entry == HUGE_VAL) return std::pair<double, double>(HUGE_VAL, HUGE_VAL);
+	  return std::pair<double, double>(entry, ray_inv_sphere(T, D, r));
+	}
+
+      return std::pair<double, double>(0, ray_inv_sphere(T, D, r));
+    }
+
+    /*! \brief A batched form of the ray_sphere intersection test.
+
+      The rays are passed in structure-of-arrays form so that the
+      loop is free of branches and may be vectorised by the
+      compiler. Each entry gives exactly the same result as the
+      scalar ray_sphere test.
+
+      \param T The origins of the rays relative to the sphere centers,
+      as NDIM arrays of components.
+      \param D The directions/velocities of the rays, as NDIM arrays of
+      components.
+      \param r The radii of the spheres.
+      \param dt Output array of times until the intersections, or
+      HUGE_VAL if there is no intersection.
+      \param N The number of rays in the batch.
+    */
+    inline void ray_sphere(const double* const T[NDIM], const double* const D[NDIM], const double* r, double* dt, const size_t N)
+    {
+      for (size_t i(0); i < N; ++i)
+	{
+	  //The dot products are summed in the same order as in the
+	  //Vector class, so that the signs of zero results match
+	  double TD = T[0][i] * D[0][i], T2 = T[0][i] * T[0][i], D2 = D[0][i] * D[0][i];
+	  for (size_t n(1); n < NDIM; ++n)
+	    {
+	      TD += T[n][i] * D[n][i];
+	      T2 += T[n][i] * T[n][i];
+	      D2 += D[n][i] * D[n][i];
+	    }
+
+	  const double c = T2 - r[i] * r[i];
+	  const double arg = TD * TD - D2 * c;
+	  const double root = std::max(0.0, - c / (TD - std::sqrt(std::max(arg, 0.0))));
+	  dt[i] = ((TD >= 0) | (arg < 0)) ? HUGE_VAL : root;
+	}
+    }
+
+    /*! \brief A batched form of the ray_inv_sphere intersection test.
+
+      See the batched ray_sphere test for a description of the
+      arguments. Each entry gives exactly the same result as the
+      scalar ray_inv_sphere test.
+    */
+    inline void ray_inv_sphere(const double* const T[NDIM], const double* const D[NDIM], const double* r, double* dt, const size_t N)
+    {
+      for (size_t i(0); i < N; ++i)
+	{
+	  //The dot products are summed in the same order as in the
+	  //Vector class, so that the signs of zero results match
+	  double TD = T[0][i] * D[0][i], T2 = T[0][i] * T[0][i], D2 = D[0][i] * D[0][i];
+	  for (size_t n(1); n < NDIM; ++n)
+	    {
+	      TD += T[n][i] * D[n][i];
+	      T2 += T[n][i] * T[n][i];
+	      D2 += D[n][i] * D[n][i];
+	    }
+
+	  const double c = r[i] * r[i] - T2;
+	  const double arg = TD * TD + D2 * c;
+	  const double q = TD + copysign(std::sqrt(std::max(arg, 0.0)), TD);
+	  const double exit_root = std::max(0.0, std::max(- q / D2, c / q));
+	  const double closest_root = std::max(0.0, - TD / D2);
+	  dt[i] = (D2 == 0) ? HUGE_VAL : ((arg >= 0) ? exit_root : closest_root);
+	}
+    }
+
     /*! \brief A ray-sphere intersection test where the sphere
       diameter is growing linearly with time.
       
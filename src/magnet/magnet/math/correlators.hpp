@@ -118,6 +118,10 @@ namespace magnet {
 	return _count - i;
       }
 
+      //! \brief The bytes of heap memory held by the Correlator.
+      size_t getMemoryUsage() const
+      { return _sample_history.capacity() * sizeof(std::pair<T, T>) + _correlator.capacity() * sizeof(T); }
+
     protected:
       boost::circular_buffer<std::pair<T, T> > _sample_history;
       std::vector<T> _correlator;
@@ -160,6 +164,8 @@ namespace magnet {
     {
       typedef Correlator<T> Base;
     public:
+      using Base::getMemoryUsage;
+
       /*! \brief Constructor allowing the setting of the sample_time
           and the length of correlator.
 
@@ -411,6 +417,15 @@ namespace magnet {
       }
 
 
+      //! \brief The bytes of heap memory held by the correlators.
+      size_t getMemoryUsage() const
+      { 
+	size_t bytes = _correlators.capacity() * sizeof(Correlator);
+	for (const Correlator& correlator : _correlators)
+	  bytes += correlator.getMemoryUsage();
+	return bytes;
+      }
+
     protected:
       double _sample_time;
       double _current_time;
@@ -19,6 +19,7 @@
 
 #include <cmath>
 #include <limits>
+#include <algorithm>
 #include <magnet/math/quadratic.hpp>
 
 namespace magnet {
@@ -257,5 +258,184 @@ namespace magnet {
 
       return 3;
     }
+
+    namespace detail {
+      //! \brief The number of cubics the batched cubicSolve works on at a time.
+      const size_t cubicBlockSize = 64;
+
+      /*! \brief The Newton polishing of cubicNewtonRootPolish,
+	applied to a block of (at most cubicBlockSize) roots in
+	lock-step.
+
+	Each root stops being polished at the same point as in the
+	scalar form, so the results are identical, but the loop over
+	the block is branch free and may be vectorised.
+
+	\param active Which of the roots to polish.
+       */
+      inline void cubicNewtonRootPolish(const double* p, const double* q, const double* r,
+					double* root, const bool* active, const size_t N, size_t iterations)
+      {
+	bool done[cubicBlockSize];
+	for (size_t i(0); i < N; ++i)
+	  done[i] = !active[i];
+
+	for (size_t it = 0; it < iterations; ++it)
+	  for (size_t i(0); i < N; ++i)
+	    {
+	      const double error = ((root[i] + p[i]) * root[i] + q[i]) * root[i] + r[i];
+	      const double derivative = (3.0 * root[i] + 2 * p[i]) * root[i] + q[i];
+	      done[i] = done[i] | (error == 0) | (derivative == 0);
+	      root[i] = done[i] ? root[i] : root[i] - error / derivative;
+	    }
+      }
+    }
+
+    /*! \brief A batched form of cubicSolve, solving N cubics
+        \f$x^3 + p_i\,x^2 + q_i\,x + r_i = 0\f$.
+
+      Each entry gives exactly the same roots (in the same order) as
+      the scalar cubicSolve. The special cases and the evaluation of
+      the Cardano/trigonometric forms of the roots are handled per
+      entry, while the setup and the Newton polishing of the roots
+      (most of the arithmetic) are performed in branch free loops
+      over blocks of entries, which the compiler vectorises.
+
+      \param roots Three arrays holding the first, second and third
+      root of each cubic. Only the first rootCount[i] roots of entry
+      i are set.
+      \param rootCount The number of real roots of each cubic.
+      \param N The number of cubics.
+     */
+    inline void
+    cubicSolve(const double* p, const double* q, const double* r,
+	       double* const roots[3], size_t* rootCount, const size_t N)
+    {
+      static const double maxSqrt 
+	= std::sqrt(std::numeric_limits<double>::max());
+
+      const size_t blocksize = detail::cubicBlockSize;
+      double v[blocksize], uo3[blocksize], j[blocksize];
+      bool special[blocksize], polish1[blocksize], polish23[blocksize];
+
+      for (size_t start(0); start < N; start += blocksize)
+	{
+	  const size_t n = std::min(blocksize, N - start);
+	  const double* P = p + start;
+	  const double* Q = q + start;
+	  const double* R = r + start;
+	  double* root1 = roots[0] + start;
+	  double* root2 = roots[1] + start;
+	  double* root3 = roots[2] + start;
+	  size_t* count = rootCount + start;
+
+	  //The terms of the general case, and the entries which need
+	  //one of the special cases of the scalar solver
+	  for (size_t i(0); i < n; ++i)
+	    {
+	      v[i] = R[i] + (2.0 * P[i] * P[i] / 9.0 - Q[i]) * (P[i] / 3.0);
+	      uo3[i] = Q[i] / 3.0 - P[i] * P[i] / 9.0;
+	      const double u2o3 = uo3[i] + uo3[i];
+	      const double uo3sq4 = u2o3 * u2o3;
+	      j[i] = (uo3sq4 * uo3[i]) + v[i] * v[i];
+
+	      special[i] = (R[i] == 0) | ((P[i] == 0) & (Q[i] == 0))
+		| (P[i] > maxSqrt) | (P[i] < -maxSqrt)
+		| (Q[i] > maxSqrt) | (Q[i] < -maxSqrt)
+		| (R[i] > maxSqrt) | (R[i] < -maxSqrt)
+		| (v[i] > maxSqrt) | (v[i] < -maxSqrt)
+		| (u2o3 > maxSqrt) | (u2o3 < -maxSqrt)
+		| (uo3sq4 > maxSqrt);
+	    }
+
+	  //The initial estimates of the roots
+	  for (size_t i(0); i < n; ++i)
+	    {
+	      polish1[i] = polish23[i] = false;
+
+	      if (special[i])
+		{
+		  count[i] = cubicSolve(P[i], Q[i], R[i], root1[i], root2[i], root3[i]);
+		  continue;
+		}
+
+	      if (j[i] > 0)
+		{
+		  const double w = std::sqrt(j[i]);
+		  if (v[i] < 0)
+		    root1[i] = std::pow(0.5*(w-v[i]), 1.0/3.0) - (uo3[i]) * std::pow(2.0 / (w-v[i]), 1.0/3.0) - P[i] / 3.0;
+		  else
+		    root1[i] = uo3[i] * std::pow(2.0 / (w+v[i]), 1.0/3.0) - std::pow(0.5*(w+v[i]), 1.0/3.0) - P[i] / 3.0;
+		  count[i] = 1;
+		  polish1[i] = true;
+		  continue;
+		}
+
+	      if (uo3[i] >= 0)
+		{
+		  root1[i] = root2[i] = root3[i] = std::pow(v[i], 1.0 / 3.0) - P[i] / 3.0;
+		  count[i] = 3;
+		  continue;
+		}
+
+	      const double muo3 = - uo3[i];
+	      double s;
+	      if (muo3 > 0)
+		{
+		  s = std::sqrt(muo3);
+		  if (P[i] > 0) s = -s;
+		}
+	      else
+		s = 0;
+
+	      const double scube = s * muo3;
+	      if (scube == 0)
+		{
+		  root1[i] = - P[i] / 3.0;
+		  count[i] = 1;
+		  continue;
+		}
+
+	      const double t = - v[i] / (scube + scube);
+	      const double k = std::acos(t) / 3.0;
+	      const double cosk = std::cos(k);
+	      root1[i] = (s + s) * cosk - P[i] / 3.0;
+	      count[i] = 1;
+
+	      const double sinsqk = 1.0 - cosk * cosk;
+	      if (sinsqk < 0) continue;
+
+	      const double rt3sink = std::sqrt(3.0) * std::sqrt(sinsqk);
+	      root2[i] = s * (-cosk + rt3sink) - P[i] / 3.0;
+	      root3[i] = s * (-cosk - rt3sink) - P[i] / 3.0;
+	      count[i] = 3;
+	      polish1[i] = polish23[i] = true;
+	    }
+
+	  for (size_t i(0); i < n; ++i)
+	    polish1[i] = polish1[i] | polish23[i];
+
+	  detail::cubicNewtonRootPolish(P, Q, R, root1, polish1, n, 15);
+	  detail::cubicNewtonRootPolish(P, Q, R, root2, polish23, n, 15);
+	  detail::cubicNewtonRootPolish(P, Q, R, root3, polish23, n, 15);
+
+	  //The single root case checks for the other roots using the
+	  //quadratic formula on the factored problem (see the scalar
+	  //cubicSolve).
+	  for (size_t i(0); i < n; ++i)
+	    {
+	      const bool deflate = polish1[i] & !polish23[i];
+	      const double b = P[i] + root1[i];
+	      const double c = -R[i] / root1[i];
+	      const double discriminant = b * b - 4 * 1.0 * c;
+	      const double arg = std::sqrt(std::max(discriminant, 0.0));
+	      const double qd = -0.5 * ( b + ((b < 0) ? -arg : arg));
+	      const bool found = deflate & (discriminant >= 0);
+	      root2[i] = found ? qd / 1.0 : root2[i];
+	      root3[i] = found ? c / qd : root3[i];
+	      count[i] = found ? 3 : count[i];
+	    }
+	}
+    }
   }
 }
@@ -0,0 +1,147 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace magnet {
+  namespace math {
+    /*! \brief The Philox4x32-10 counter-based random number generator.
+
+      This is the generator of Salmon et al., "Parallel random
+      numbers: as easy as 1, 2, 3" (SC11). The output is a bijection
+      of a 128 bit counter, scrambled using a 64 bit key, so any
+      element of any stream may be generated directly and there is
+      no hidden state beyond the key and the counter.
+
+      Here the key selects a family of streams (e.g., the seed of a
+      run), the upper 64 bits of the counter select a stream within
+      the family, and the lower 64 bits are the position within the
+      stream. Independent generators may be created for any number
+      of threads, cells or particles without any synchronisation and
+      the values drawn do not depend on how the work is scheduled.
+
+      The class satisfies the requirements of a uniform random number
+      generator so it may be used with the standard distributions.
+     */
+    class Philox4x32
+    {
+    public:
+      typedef uint32_t result_type;
+      typedef std::array<uint32_t, 4> Block;
+
+      /*! \brief Constructor.
+	\param key The key of the generator.
+	\param stream The stream of the generator.
+	\param position The starting position within the stream.
+       */
+      Philox4x32(uint64_t key = 0, uint64_t stream = 0, uint64_t position = 0)
+      { seed(key, stream, position); }
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      //! \brief Reset the generator to the given key and stream.
+      void seed(uint64_t key, uint64_t stream = 0, uint64_t position = 0)
+      {
+	_key = key;
+	_stream = stream;
+	setPosition(position);
+      }
+
+      //! \brief Returns the next value of the stream.
+      result_type operator()()
+      {
+	if (_index == 4)
+	  {
+	    ++_block;
+	    _index = 0;
+	    _values = generate(_key, _stream, _block);
+	  }
+	return _values[_index++];
+      }
+
+      //! \brief Skip the next n values of the stream.
+      void discard(uint64_t n) { setPosition(getPosition() + n); }
+
+      //! \brief The key of the generator.
+      uint64_t getKey() const { return _key; }
+
+      //! \brief The stream of the generator.
+      uint64_t getStream() const { return _stream; }
+
+      //! \brief The number of values drawn from the stream so far.
+      uint64_t getPosition() const { return 4 * _block + _index; }
+
+      //! \brief Move to a position within the stream.
+      void setPosition(uint64_t position)
+      {
+	_block = position / 4;
+	_index = position % 4;
+	_values = generate(_key, _stream, _block);
+      }
+
+      bool operator==(const Philox4x32& o) const
+      { return (_key == o._key) && (_stream == o._stream) && (getPosition() == o.getPosition()); }
+
+      bool operator!=(const Philox4x32& o) const { return !(*this == o); }
+
+      /*! \brief Evaluate the Philox4x32-10 bijection.
+	\param key The two 32 bit words of the key.
+	\param counter The four 32 bit words of the counter.
+       */
+      static Block bijection(std::array<uint32_t, 2> key, Block counter)
+      {
+	for (size_t r(0); r < 10; ++r)
+	  {
+	    if (r)
+	      {
+		key[0] += 0x9E3779B9;
+		key[1] += 0xBB67AE85;
+	      }
+
+	    const uint64_t product0 = uint64_t(0xD2511F53) * counter[0];
+	    const uint64_t product1 = uint64_t(0xCD9E8D57) * counter[2];
+	    counter = Block{{uint32_t(product1 >> 32) ^ counter[1] ^ key[0], uint32_t(product1),
+			     uint32_t(product0 >> 32) ^ counter[3] ^ key[1], uint32_t(product0)}};
+	  }
+	return counter;
+      }
+
+      /*! \brief Generate a block of four values of a stream.
+	\param key The key of the generator.
+	\param stream The stream to generate from.
+	\param block The index of the block of four values in the stream.
+       */
+      static Block generate(uint64_t key, uint64_t stream, uint64_t block)
+      {
+	return bijection(std::array<uint32_t, 2>{{uint32_t(key), uint32_t(key >> 32)}},
+			 Block{{uint32_t(block), uint32_t(block >> 32), uint32_t(stream), uint32_t(stream >> 32)}});
+      }
+
+    private:
+      uint64_t _key;
+      uint64_t _stream;
+      uint64_t _block;
+      size_t _index;
+      Block _values;
+    };
+  }
+}
@@ -38,13 +38,46 @@ namespace magnet {
 	    root -= error / derivative;
 	  }
       }
-    }
 
-    //Solves quartics of the form x^4 + a x^3 + b x^2 + c x + d ==0
-    inline size_t quarticSolve(const double& a, const double& b, const double& c, const double& d,
-			       double& root1, double& root2, double& root3, double& root4)
-    {
+      //! \brief The number of quartics the batched quarticSolve works on at a time.
+      const size_t quarticBlockSize = 64;
+
+      /*! \brief The Newton polishing of quarticNewtonRootPolish,
+	applied to a block of (at most quarticBlockSize) roots in
+	lock-step.
+
+	Each root stops being polished at the same point as in the
+	scalar form, so the results are identical, but the loop over
+	the block is branch free and may be vectorised.
+
+	\param active Which of the roots to polish.
+       */
+      inline void quarticNewtonRootPolish(const double* a, const double* b, const double* c, const double* d,
+					  double* root, const bool* active, const size_t N, size_t iterations)
+      {
+	bool done[quarticBlockSize];
+	for (size_t i(0); i < N; ++i)
+	  done[i] = !active[i];
+
+	for (size_t it = 0; it < iterations; ++it)
+	  for (size_t i(0); i < N; ++i)
+	    {
+	      const double error = (((root[i] + a[i])*root[i] + b[i]) * root[i] + c[i]) * root[i] + d[i];
+	      const double derivative = ((4 * root[i] + 3 * a[i]) * root[i] + 2 * b[i]) * root[i] + c[i];
+	      done[i] = done[i] | (error == 0) | (derivative == 0);
+	      root[i] = done[i] ? root[i] : root[i] - error / derivative;
+	    }
+      }
+
+      /*! \brief The roots of quarticSolve, before they are polished.
+
+	\param polish Set if the roots should be polished.
+       */
+      inline size_t quarticSolveEstimate(const double& a, const double& b, const double& c, const double& d,
+					 double& root1, double& root2, double& root3, double& root4, bool& polish)
+      {
       static const double maxSqrt = std::sqrt(std::numeric_limits<double>::max());
+      polish = false;
 
       if (std::abs(a) > maxSqrt)
 	yacfraidQuarticSolve(a,b,c,d,root1,root2,root3,root4);
@@ -106,12 +139,67 @@ namespace magnet {
 	  break;
 	}
 
-      if (nr)   detail::quarticNewtonRootPolish(a, b, c, d, root1, 15);
-      if (nr>1) detail::quarticNewtonRootPolish(a, b, c, d, root2, 15);
-      if (nr>2) detail::quarticNewtonRootPolish(a, b, c, d, root3, 15);
-      if (nr>3) detail::quarticNewtonRootPolish(a, b, c, d, root4, 15);
+      polish = true;
+      return nr;  
+      }
+    }
+
+    //Solves quartics of the form x^4 + a x^3 + b x^2 + c x + d ==0
+    inline size_t quarticSolve(const double& a, const double& b, const double& c, const double& d,
+			       double& root1, double& root2, double& root3, double& root4)
+    {
+      bool polish;
+      const size_t nr = detail::quarticSolveEstimate(a, b, c, d, root1, root2, root3, root4, polish);
+
+      if (polish)
+	{
+	  if (nr)   detail::quarticNewtonRootPolish(a, b, c, d, root1, 15);
+	  if (nr>1) detail::quarticNewtonRootPolish(a, b, c, d, root2, 15);
+	  if (nr>2) detail::quarticNewtonRootPolish(a, b, c, d, root3, 15);
+	  if (nr>3) detail::quarticNewtonRootPolish(a, b, c, d, root4, 15);
+	}
       
       return nr;  
     }
+
+    /*! \brief A batched form of quarticSolve, solving N quartics
+        \f$x^4 + a_i\,x^3 + b_i\,x^2 + c_i\,x + d_i = 0\f$.
+
+      Each entry gives exactly the same roots (in the same order) as
+      the scalar quarticSolve. The initial estimates of the roots are
+      found per entry, while the Newton polishing of the roots (most
+      of the arithmetic) is performed in branch free loops over
+      blocks of entries, which the compiler vectorises.
+
+      \param roots Four arrays holding the roots of each quartic. Only
+      the first rootCount[i] roots of entry i are set.
+      \param rootCount The number of real roots of each quartic.
+      \param N The number of quartics.
+     */
+    inline void quarticSolve(const double* a, const double* b, const double* c, const double* d,
+			     double* const roots[4], size_t* rootCount, const size_t N)
+    {
+      const size_t blocksize = detail::quarticBlockSize;
+      bool polish[4][blocksize];
+
+      for (size_t start(0); start < N; start += blocksize)
+	{
+	  const size_t n = std::min(blocksize, N - start);
+
+	  for (size_t i(0); i < n; ++i)
+	    {
+	      const size_t id = start + i;
+	      bool polishEntry;
+	      rootCount[id] = detail::quarticSolveEstimate(a[id], b[id], c[id], d[id], roots[0][id], roots[1][id],
+							   roots[2][id], roots[3][id], polishEntry);
+	      for (size_t root(0); root < 4; ++root)
+		polish[root][i] = polishEntry && (rootCount[id] > root);
+	    }
+
+	  for (size_t root(0); root < 4; ++root)
+	    detail::quarticNewtonRootPolish(a + start, b + start, c + start, d + start, 
+					    roots[root] + start, polish[root], n, 15);
+	}
+    }
   }
 }
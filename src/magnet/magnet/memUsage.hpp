@@ -21,6 +21,10 @@
 #include <string>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <boost/circular_buffer.hpp>
 
 namespace magnet {
   /*! \brief Attempts to read the system-dependent data for a process'
@@ -65,4 +69,42 @@ namespace magnet {
   
     return resident_set;
   }
+
+  /*! \brief The bytes of heap memory held by the storage of a
+      container (excluding the heap memory of its elements).
+
+      These are used to account for the memory of the data structures
+      of a program. The node based containers are estimated from the
+      typical node layouts of the standard library, ignoring the
+      overheads of the allocator.
+   */
+  template<class T, class A>
+  inline size_t container_mem_usage(const std::vector<T, A>& container)
+  { return container.capacity() * sizeof(T); }
+
+  template<class T, class A>
+  inline size_t container_mem_usage(const boost::circular_buffer<T, A>& container)
+  { return container.capacity() * sizeof(T); }
+
+  /*! \brief A red-black tree node holds its colour and three
+      pointers. */
+  template<class K, class V, class C, class A>
+  inline size_t container_mem_usage(const std::map<K, V, C, A>& container)
+  { return container.size() * (sizeof(typename std::map<K, V, C, A>::value_type) + 4 * sizeof(void*)); }
+
+  /*! \brief A hash table node holds a pointer and the cached hash,
+      and each bucket is a pointer. */
+  template<class K, class V, class H, class E, class A>
+  inline size_t container_mem_usage(const std::unordered_map<K, V, H, E, A>& container)
+  { 
+    return container.size() * (sizeof(typename std::unordered_map<K, V, H, E, A>::value_type) + 2 * sizeof(void*))
+      + container.bucket_count() * sizeof(void*);
+  }
+
+  template<class K, class V, class H, class E, class A>
+  inline size_t container_mem_usage(const std::unordered_multimap<K, V, H, E, A>& container)
+  { 
+    return container.size() * (sizeof(typename std::unordered_multimap<K, V, H, E, A>::value_type) + 2 * sizeof(void*))
+      + container.bucket_count() * sizeof(void*);
+  }
 }
@@ -0,0 +1,159 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/exception.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <bzlib.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace magnet {
+  namespace stream {
+    /*! \brief A boost::iostreams output filter which bzip2
+      compresses the data using a ThreadPool.
+
+      The data is split into blocks which are compressed
+      independently as separate bzip2 streams, and the compressed
+      streams are written out in order. A file of concatenated bzip2
+      streams is a valid bzip2 file (this is how pbzip2 works) and it
+      is decompressed to the original data by the bzip2 tools and by
+      boost::iostreams::bzip2_decompressor.
+
+      At most two blocks per thread of the pool are held in memory
+      at once. The default block size matches the largest bzip2
+      block, so the compression ratio is essentially unchanged.
+
+      \code
+      boost::iostreams::filtering_ostream os;
+      os.push(magnet::stream::ParallelBzip2Compressor(pool));
+      os.push(boost::iostreams::file_sink("file.bz2"));
+      \endcode
+     */
+    class ParallelBzip2Compressor
+    {
+      struct State
+      {
+	State(thread::ThreadPool& pool, size_t blockSize):
+	  _pool(pool), _blockSize(blockSize), _written(false) {}
+
+	thread::ThreadPool& _pool;
+	size_t _blockSize;
+	std::string _current;
+	std::vector<std::string> _blocks;
+	bool _written;
+      };
+
+    public:
+      typedef char char_type;
+      struct category:
+	boost::iostreams::output_filter_tag,
+	boost::iostreams::multichar_tag,
+	boost::iostreams::closable_tag
+      {};
+
+      /*! \brief Constructor.
+	\param pool The ThreadPool used to compress the blocks.
+	\param blockSize The amount of uncompressed data in each bzip2
+	stream.
+       */
+      ParallelBzip2Compressor(thread::ThreadPool& pool, size_t blockSize = 900000):
+	_state(new State(pool, std::max(blockSize, size_t(1))))
+      {}
+
+      template<typename Sink>
+      std::streamsize write(Sink& snk, const char* s, std::streamsize n)
+      {
+	State& state = *_state;
+	std::streamsize remaining = n;
+	while (remaining)
+	  {
+	    const size_t count = std::min(size_t(remaining), state._blockSize - state._current.size());
+	    state._current.append(s, count);
+	    s += count;
+	    remaining -= count;
+
+	    if (state._current.size() == state._blockSize)
+	      {
+		state._blocks.push_back(std::string());
+		state._blocks.back().swap(state._current);
+		if (state._blocks.size() >= 2 * std::max(state._pool.getThreadCount(), size_t(1)))
+		  flushBlocks(snk);
+	      }
+	  }
+	return n;
+      }
+
+      template<typename Sink>
+      void close(Sink& snk)
+      {
+	State& state = *_state;
+	//Always write at least one stream, so empty input gives a
+	//valid (empty) bzip2 file
+	if (!state._current.empty() || (!state._written && state._blocks.empty()))
+	  {
+	    state._blocks.push_back(std::string());
+	    state._blocks.back().swap(state._current);
+	  }
+	flushBlocks(snk);
+	state._written = false;
+      }
+
+      /*! \brief Compress a block of data into a single bzip2 stream.
+       */
+      static std::string compress(const std::string& data)
+      {
+	//The bzip2 documentation guarantees the output fits in 1% more
+	//than the input plus 600 bytes
+	unsigned int length = data.size() + data.size() / 100 + 600;
+	std::string output(length, '\0');
+	const int error = BZ2_bzBuffToBuffCompress(&output[0], &length, const_cast<char*>(data.data()),
+						   data.size(), 9, 0, 0);
+	if (error != BZ_OK)
+	  M_throw() << "bzip2 compression failed with error code " << error;
+	output.resize(length);
+	return output;
+      }
+
+    private:
+      template<typename Sink>
+      void flushBlocks(Sink& snk)
+      {
+	State& state = *_state;
+	std::vector<std::string> compressed(state._blocks.size());
+	{
+	  thread::TaskGroup group(state._pool);
+	  for (size_t i(0); i < state._blocks.size(); ++i)
+	    group.run([&, i]{ compressed[i] = compress(state._blocks[i]); });
+	  group.wait();
+	}
+
+	for (const std::string& block : compressed)
+	  boost::iostreams::write(snk, block.data(), block.size());
+
+	state._written = state._written || !state._blocks.empty();
+	state._blocks.clear();
+      }
+
+      std::shared_ptr<State> _state;
+    };
+  }
+}
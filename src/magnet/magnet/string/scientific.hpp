@@ -0,0 +1,187 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+namespace magnet {
+  namespace string {
+    namespace detail {
+      typedef unsigned __int128 uint128;
+
+      //! \brief Table of the powers of ten representable in 128 bits.
+      struct Pow10Table
+      {
+	Pow10Table()
+	{
+	  _values[0] = 1;
+	  for (int i(1); i < 39; ++i)
+	    _values[i] = _values[i - 1] * 10;
+	}
+
+	uint128 _values[39];
+      };
+
+      //! \brief Returns \f$10^n\f$ for \f$0\le n\le 38\f$.
+      inline uint128 pow10_128(int n)
+      {
+	static const Pow10Table table;
+	return table._values[n];
+      }
+
+      /*! \brief Calculates \f$m\,2^e\,10^s\f$ rounded to the nearest
+	integer (ties to even) using exact integer arithmetic.
+
+	\return False if the calculation cannot be carried out in 128
+	bits or the result does not fit in 64 bits.
+       */
+      inline bool scaledRound(uint64_t m, int e, int s, uint64_t& result)
+      {
+	uint128 q, r, half;
+	bool odd;
+	if (s >= 0)
+	  {
+	    if (s > 38) return false;
+	    const uint128 p = pow10_128(s);
+	    if (p > ~uint128(0) / m) return false;
+	    const uint128 num = p * m;
+
+	    if (e >= 0)
+	      {
+		if ((e >= 64) || (num >> (64 - e))) return false;
+		result = uint64_t(num << e);
+		return true;
+	      }
+
+	    const int shift = -e;
+	    if (shift >= 128) return false;
+	    q = num >> shift;
+	    r = num & ((uint128(1) << shift) - 1);
+	    half = uint128(1) << (shift - 1);
+	    odd = q & 1;
+	    if ((r > half) || ((r == half) && odd)) ++q;
+	  }
+	else
+	  {
+	    if ((-s > 38) || (e < 0) || (e > 74)) return false;
+	    const uint128 den = pow10_128(-s);
+	    const uint128 num = uint128(m) << e;
+	    q = num / den;
+	    r = num % den;
+	    //den < 2^127, so 2r cannot overflow
+	    if ((2 * r > den) || ((2 * r == den) && (q & 1))) ++q;
+	  }
+
+	if (q >> 64) return false;
+	result = uint64_t(q);
+	return true;
+      }
+    }
+
+    /*! \brief Writes a double in scientific notation with a fixed
+      number of digits after the decimal point.
+
+      The output is identical to that of printf's "%.*e" format (and
+      of a std::ostream set to std::scientific) in the C locale, but
+      most values are converted using exact 128 bit integer
+      arithmetic instead of the general printf machinery. Values
+      which cannot be converted this way (very large or small
+      magnitudes, subnormals, infinities, NaNs and precisions above
+      17) are passed on to snprintf.
+
+      \param out The output buffer, which must have space for at
+      least precision + 32 characters.
+      \param value The value to format.
+      \param precision The number of digits after the decimal point.
+      \return A pointer to the end of the written characters (no
+      terminating null is written).
+     */
+    inline char* formatScientific(char* out, double value, int precision)
+    {
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      const bool negative = bits >> 63;
+      const int expField = (bits >> 52) & 0x7FF;
+      const uint64_t fraction = bits & ((uint64_t(1) << 52) - 1);
+
+      int E = 0;
+      uint64_t digits = 0;
+      bool exact = (precision >= 0) && (precision <= 17) && (expField != 0x7FF);
+
+      if (exact && (expField == 0))
+	//Zero is written directly, subnormals fall back to printf
+	exact = (fraction == 0);
+      else if (exact)
+	{
+	  const uint64_t m = fraction | (uint64_t(1) << 52);
+	  const int e = expField - 1075;
+
+	  //An estimate of floor(log10(value)) which is either exact or
+	  //one too small
+	  E = ((e + 52) * 78913) >> 18;
+
+	  const uint64_t lower = detail::pow10_128(precision);
+	  const uint64_t upper = lower * 10;
+	  for (int attempt(0); exact; ++attempt)
+	    {
+	      exact = (attempt < 3) && detail::scaledRound(m, e, precision - E, digits);
+	      if (!exact) break;
+	      if (digits >= upper) ++E;
+	      else if (digits < lower) --E;
+	      else break;
+	    }
+	}
+
+      if (!exact)
+	{
+	  const int len = std::snprintf(out, precision + 32, "%.*e", precision, value);
+	  return out + len;
+	}
+
+      char* p = out;
+      if (negative) *(p++) = '-';
+
+      //Write the digits in reverse then place the decimal point
+      char buffer[20];
+      for (int i(precision); i > 0; --i)
+	{
+	  buffer[i] = '0' + (digits % 10);
+	  digits /= 10;
+	}
+      buffer[0] = '0' + digits;
+
+      *(p++) = buffer[0];
+      if (precision)
+	{
+	  *(p++) = '.';
+	  std::memcpy(p, buffer + 1, precision);
+	  p += precision;
+	}
+
+      *(p++) = 'e';
+      *(p++) = (E < 0) ? '-' : '+';
+      const unsigned int absE = (E < 0) ? -E : E;
+      if (absE >= 100) *(p++) = '0' + absE / 100;
+      *(p++) = '0' + (absE / 10) % 10;
+      *(p++) = '0' + absE % 10;
+      return p;
+    }
+  }
+}
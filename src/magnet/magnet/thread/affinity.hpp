@@ -0,0 +1,74 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file affinity.hpp
+ * \brief Functions to bind threads to CPU cores.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace magnet {
+  namespace thread {
+    /*! \brief The CPUs the calling thread is allowed to run on, in
+        ascending order.
+
+	An empty list is returned if the platform does not support
+	setting the affinity of threads.
+     */
+    inline std::vector<size_t> availableCPUs()
+    {
+      std::vector<size_t> cpus;
+#ifdef __linux__
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (!sched_getaffinity(0, sizeof(set), &set))
+	for (size_t cpu(0); cpu < CPU_SETSIZE; ++cpu)
+	  if (CPU_ISSET(cpu, &set))
+	    cpus.push_back(cpu);
+#endif
+      return cpus;
+    }
+
+    /*! \brief Bind the calling thread to a single CPU.
+
+      As the kernel allocates the memory pages of a thread on the NUMA
+      node it is running on when they are first touched, a bound
+      thread keeps the data it initialises in local memory.
+
+      \return If the thread was bound.
+     */
+    inline bool pinThread(size_t cpu)
+    {
+#ifdef __linux__
+      if (cpu >= CPU_SETSIZE) return false;
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      return !pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+      return false;
+#endif
+    }
+  }
+}
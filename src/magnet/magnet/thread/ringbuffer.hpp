@@ -0,0 +1,137 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file ringbuffer.hpp
+ * \brief Contains the definition of BroadcastRingBuffer
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+
+namespace magnet {
+  namespace thread {
+    /*! \brief A lock-free, fixed capacity ring buffer with a single
+        producer and a fixed number of consumers, where every
+        consumer reads every item.
+
+      The items are constructed once and then reused, so items
+      holding containers (e.g., std::vector) only allocate until
+      their capacity is large enough. The producer writes into the
+      next free item in place, then publishes it. Each consumer reads
+      the items in the order they were published, and releases each
+      one once it has finished with it. An item is only reused once
+      every consumer has released it.
+
+      The producer only waits if the buffer is full, i.e., the
+      slowest consumer is a full buffer behind.
+     */
+    template<class T>
+    class BroadcastRingBuffer
+    {
+      //The indices are padded onto separate cache lines as each is
+      //written by a different thread.
+      struct Index
+      {
+	Index(): _value(0) {}
+	std::atomic<uint64_t> _value;
+	char _pad[64 - sizeof(std::atomic<uint64_t>)];
+      };
+
+    public:
+      /*! \brief Constructor.
+
+	\param capacity The number of items in the buffer, which must
+	be a power of two.
+	\param consumers The number of consumers reading the buffer.
+       */
+      BroadcastRingBuffer(size_t capacity, size_t consumers):
+	_data(capacity),
+	_mask(capacity - 1),
+	_tails(new Index[consumers]),
+	_consumers(consumers)
+      {}
+
+      size_t capacity() const { return _data.size(); }
+
+      size_t consumers() const { return _consumers; }
+
+      /*! \brief Returns the next item to be written, waiting until
+          every consumer has released it.
+
+	This may only be called by the producer thread, and the item
+	must be published using publish() before calling this again.
+       */
+      T& claim()
+      {
+	const uint64_t head = _head._value.load(std::memory_order_relaxed);
+	while (head - minimumTail() >= _data.size())
+	  std::this_thread::yield();
+	return _data[head & _mask];
+      }
+
+      /*! \brief Make the item returned by claim() available to the
+          consumers.
+       */
+      void publish()
+      { _head._value.store(_head._value.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+      /*! \brief Returns the next item for a consumer, or a null
+          pointer if there are no unread items.
+
+	The item remains valid until it is released using release().
+       */
+      const T* front(size_t consumer) const
+      {
+	const uint64_t tail = _tails[consumer]._value.load(std::memory_order_relaxed);
+	if (tail == _head._value.load(std::memory_order_acquire))
+	  return nullptr;
+	return &_data[tail & _mask];
+      }
+
+      //! \brief Release the item returned by front() for a consumer.
+      void release(size_t consumer)
+      { _tails[consumer]._value.store(_tails[consumer]._value.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+      //! \brief Test if every consumer has released every published item.
+      bool drained() const
+      { return minimumTail() == _head._value.load(std::memory_order_relaxed); }
+
+    private:
+      BroadcastRingBuffer(const BroadcastRingBuffer&);
+      BroadcastRingBuffer& operator=(const BroadcastRingBuffer&);
+
+      uint64_t minimumTail() const
+      {
+	uint64_t tail = _tails[0]._value.load(std::memory_order_acquire);
+	for (size_t i(1); i < _consumers; ++i)
+	  tail = std::min(tail, _tails[i]._value.load(std::memory_order_acquire));
+	return tail;
+      }
+
+      std::vector<T> _data;
+      const uint64_t _mask;
+      Index _head;
+      std::unique_ptr<Index[]> _tails;
+      const size_t _consumers;
+    };
+  }
+}
@@ -1,4 +1,4 @@
-/*  dynamo:- Event driven molecular dynamics simulator 
+/*  dynamo:- Event driven molecular dynamics simulator
     http://www.dynamomd.org
     Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
 
@@ -15,212 +15,663 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 /*! \file threadpool.hpp
- * \brief Contains the definition of ThreadPool
+ * \brief Contains the definition of ThreadPool and TaskGroup
  */
 
 #pragma once
 
-#include <sstream>
-#include <iostream>
-
 #include <magnet/thread/threadgroup.hpp>
-#include <magnet/thread/taskQueue.hpp>
+#include <magnet/thread/affinity.hpp>
+#include <magnet/thread/workstealingdeque.hpp>
+#include <magnet/exception.hpp>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <limits>
+#include <algorithm>
 
 namespace magnet {
   namespace thread {
-    /*! \brief A class providing a pool of worker threads that will
-      execute "tasks" pushed to it.
-      
-      This class will also run in 0 thread mode, where the controlling
-      process will execute the tasks when it enters the
-      ThreadPool::wait() function.
+    class ThreadPool;
+
+    /*! \brief A set of tasks which may be waited on together.
+
+      Tasks are run on the ThreadPool passed to the constructor. A
+      thread waiting on a TaskGroup executes queued tasks of the pool
+      while it waits, so tasks may themselves create and wait on
+      TaskGroups (nested parallelism) without deadlocking the pool,
+      and the waiting thread performs all of the work if the pool has
+      no threads.
+
+      If any task throws an exception, the first exception is
+      rethrown by wait().
      */
-    class ThreadPool : public TaskQueue
-    {	
-    private:
-      volatile bool _exception_flag;
-      std::ostringstream _exception_data;
-      
-      ThreadPool (const ThreadPool&);
-      ThreadPool& operator = (const ThreadPool&);
-  
-      /*! \brief This mutex is to control access to write that an exception has occurred.
+    class TaskGroup
+    {
+    public:
+      inline TaskGroup(ThreadPool& pool):
+	_pool(pool),
+	_pending(0)
+      {}
+
+      /*! \brief Waits for any remaining tasks, discarding their
+          exceptions.
        */
-      std::mutex _exception_mutex;
+      inline ~TaskGroup() { try { wait(); } catch (...) {} }
+
+      /*! \brief Queue a task in this group. */
+      inline void run(std::function<void()> task);
+
+      /*! \brief Queue a task in this group which may only be run by
+          a particular thread of the pool.
 
-      /*! \brief Triggered every time a thread becomes available, to
-        notify the mother thread stuck in the wait() function.
+	  See ThreadPool::queueTaskOn().
        */
-      std::condition_variable _threadAvailable_condition;
+      inline void runOn(size_t thread, std::function<void()> task);
 
-      /*! \brief Triggered to wake threads when jobs are added to the queue.
+      /*! \brief Wait for all the tasks of this group to complete. */
+      inline void wait();
+
+    private:
+      friend class ThreadPool;
+
+      TaskGroup(const TaskGroup&);
+      TaskGroup& operator=(const TaskGroup&);
+
+      /*! \brief Called by the pool as each task of this group completes.
        */
-      std::condition_variable _need_thread_mutex;
+      inline void taskDone(std::exception_ptr exception);
 
-      magnet::thread::ThreadGroup _threads;
+      ThreadPool& _pool;
+      std::atomic<size_t> _pending;
+      std::mutex _mutex;
+      std::condition_variable _done;
+      std::exception_ptr _exception;
+    };
 
-      volatile size_t _idlingThreads;
-      volatile bool _stop_flag;
+    /*! \brief A class providing a pool of worker threads that will
+      execute "tasks" pushed to it.
+
+      Each worker thread owns a lock-free WorkStealingDeque. Tasks
+      created by a worker (e.g., the subtasks of a parallel_for or of
+      a nested TaskGroup) are pushed onto its own deque and popped in
+      LIFO order, while idle workers steal tasks from the other
+      deques. Tasks queued from outside the pool are placed in a
+      shared FIFO injection queue. Workers only sleep when there are
+      no queued tasks anywhere in the pool.
 
-    public:  
+      Tasks may also be bound to a particular worker (see
+      queueTaskOn()), and the workers may be bound to CPU cores (see
+      setThreadAffinity()). Together these keep long-lived data, such
+      as a Simulation, on the core (and NUMA node) of the thread
+      which created it.
+
+      The simple queueTask()/wait() interface of the original pool is
+      kept: these tasks are placed in a default TaskGroup which
+      wait() waits on. This class will also run in 0 thread mode,
+      where the controlling process will execute the tasks when it
+      enters a wait() function.
+     */
+    class ThreadPool
+    {
+      struct Task
+      {
+	std::function<void()> _func;
+	//! The group of the task, or NULL for tasks created by async().
+	TaskGroup* _group;
+      };
+
+      struct WorkerID
+      {
+	ThreadPool* _pool;
+	size_t _index;
+      };
+
+      //! \brief The queue of tasks bound to a single worker.
+      struct BoundQueue
+      {
+	BoundQueue(): _count(0) {}
+
+	std::deque<Task*> _tasks;
+	std::mutex _mutex;
+	std::atomic<size_t> _count;
+      };
+
+      static const size_t external = std::numeric_limits<size_t>::max();
+
+      /*! \brief The number of times an idle worker yields before
+          going to sleep.
+       */
+      static const size_t spinCount = 64;
+
+    public:
       /*! \brief Default Constructor
-       
+
         This initialises the pool to 0 threads
        */
       inline ThreadPool():
-	_exception_flag(false),
-	_idlingThreads(0),
-	_stop_flag(false)
+	_injectedCount(0),
+	_queued(0),
+	_sleeping(0),
+	_stop(false),
+	_affinity(false),
+	_defaultGroup(*this)
       {}
-      
+
+      /*! \brief Destructor
+
+        Join all threads in the pool and wait until they are
+        terminated. Any tasks which have not started are discarded.
+       */
+      inline ~ThreadPool() throw()
+      {
+	stop();
+	for (Task* task : _injected)
+	  {
+	    TaskGroup* group = task->_group;
+	    delete task;
+	    if (group) group->taskDone(std::exception_ptr());
+	  }
+	_injected.clear();
+      }
+
       /*! \brief Set the number of threads in the pool
-       
-        This creates the specified amount of threads to populate the
-        pool. When lowering the number of threads this pool kills ALL
-        threads, but waits for all their current tasks to complete
-        first, then repopulates the pool.
+
+        All current threads are stopped (after completing their
+        current task) and the pool is repopulated. Tasks which had not
+        started are kept and will be run by the new threads. This must
+        not be called from inside a task.
        */
       inline void setThreadCount(size_t x)
-      { 
+      {
 	if (x == _threads.size()) return;
-	
-	if (x < _threads.size())
-	  {
-	    //Stop all threads as we're shrinking our thread pool size
-	    stop();
-	    //All threads are dead, reset the kill switch
-	    _stop_flag = false;
-	  }
-	
-	//Add the required number of threads
-	for (size_t i=_threads.size(); i < x; ++i)
-	  _threads.create_thread(std::function<void()>(std::bind(&ThreadPool::beginThread, this)));
+	startThreads(x);
       }
 
       /*! \brief The current number of threads in the pool */
       inline size_t getThreadCount() const { return _threads.size(); }
 
-      //Actual queuer
-      inline void queueTask(std::function<void()>&& threadfunc)
+      /*! \brief Bind each thread of the pool to a CPU core.
+
+        Thread i is bound to the i'th CPU the calling thread may run
+        on (wrapping around if there are more threads than CPUs), so
+        the mapping of threads to cores is stable for the lifetime of
+        the pool. The threads are restarted if the setting changes,
+        and, like setThreadCount(), this must not be called from
+        inside a task. This has no effect on platforms which do not
+        support thread affinity.
+       */
+      inline void setThreadAffinity(bool affinity)
       {
-	TaskQueue::queueTask(threadfunc);
-	_need_thread_mutex.notify_all();
+	if (affinity == _affinity) return;
+	_affinity = affinity;
+	if (_threads.size())
+	  startThreads(_threads.size());
       }
 
-      //Actual queuer
+      /*! \brief If the threads of the pool are bound to CPU cores. */
+      inline bool getThreadAffinity() const { return _affinity; }
+
+      /*! \brief Queue a task in the default task group.
+       */
+      inline void queueTask(std::function<void()> threadfunc)
+      { _defaultGroup.run(std::move(threadfunc)); }
+
+      /*! \brief Queue a set of tasks in the default task group.
+       */
       inline void queueTasks(std::vector<std::function<void()> >& threadfuncs)
       {
-	TaskQueue::queueTasks(threadfuncs);
-	_need_thread_mutex.notify_all();
+	for (auto& func : threadfuncs)
+	  _defaultGroup.run(std::move(func));
+	threadfuncs.clear();
       }
-  
-      /*! \brief Destructor
-       
-        Join all threads in the pool and wait until they are
-        terminated.
+
+      /*! \brief Queue a task in the default task group which may only
+          be run by a particular thread.
+
+	  The task is never stolen by the other threads, so the tasks
+	  queued on a thread run in FIFO order on that thread
+	  only. This is used to keep repeated work on the same data on
+	  the same thread (and, with setThreadAffinity(), the same
+	  core). In exchange, these tasks are not load balanced.
+
+	  If the pool has no threads, the task is run in wait() as
+	  usual. If the thread count is changed, any tasks which have
+	  not started are kept but lose their binding.
+
+	  \param thread The index of the thread, taken modulo the
+	  number of threads.
        */
-      inline ~ThreadPool() throw() { stop(); }
+      inline void queueTaskOn(size_t thread, std::function<void()> threadfunc)
+      { _defaultGroup.runOn(thread, std::move(threadfunc)); }
+
+      /*! \brief Wait for all tasks queued with queueTask() or
+          queueTasks() to complete.
 
-      /*! \brief Wait for all tasks to complete.
-       
         If there are no threads in the pool then this function will
         actually make the waiting/mother process perform the tasks.
        */
       inline void wait()
       {
-	if (_threads.size())
+	try { _defaultGroup.wait(); }
+	catch (std::exception& cep)
+	  {
+	    M_throw() << "Thread Exception found while waiting for tasks/threads to finish"
+		      << "\nTHREAD: Task threw an exception:-" << cep.what();
+	  }
+      }
+
+      /*! \brief The number of threads sleeping while waiting for work. */
+      inline size_t getIdleThreadCount() { return _sleeping; }
+
+      /*! \brief Run a function on the pool, returning a future for
+          its result.
+
+	  Exceptions thrown by the function are stored in the
+	  future. A task should wait on a future using
+	  ThreadPool::get(), which executes other tasks while it
+	  waits.
+       */
+      template<class F>
+      inline std::future<typename std::result_of<F()>::type> async(F func)
+      {
+	typedef typename std::result_of<F()>::type R;
+	std::shared_ptr<std::packaged_task<R()> > task(new std::packaged_task<R()>(std::move(func)));
+	std::future<R> result = task->get_future();
+	submit(new Task{[task](){ (*task)(); }, nullptr});
+	return result;
+      }
+
+      /*! \brief Wait on a future created by async(), executing queued
+          tasks of the pool while waiting.
+       */
+      template<class R>
+      inline R get(std::future<R>& future)
+      {
+	while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	  if (!help())
+	    future.wait_for(std::chrono::microseconds(100));
+	return future.get();
+      }
+
+      /*! \brief Call func(begin, end) over sub-ranges of [begin,end)
+          in parallel.
+
+	  The range is recursively split in half until the sub-ranges
+	  are no larger than grain, so idle threads steal large
+	  sub-ranges and split them further. The calling thread
+	  participates, and this may be called from inside a task.
+
+	  \param grain The largest sub-range passed to func. If zero,
+	  a grain giving roughly eight sub-ranges per thread is used.
+       */
+      template<class F>
+      inline void parallel_for(size_t begin, size_t end, const F& func, size_t grain = 0)
+      {
+	if (end <= begin) return;
+
+	if (!grain)
+	  grain = std::max(size_t(1), (end - begin) / (8 * (_threads.size() + 1)));
+
+	TaskGroup group(*this);
+	splitRange(group, begin, end, grain, func);
+	group.wait();
+      }
+
+    private:
+      friend class TaskGroup;
+
+      ThreadPool (const ThreadPool&);
+      ThreadPool& operator = (const ThreadPool&);
+
+      /*! \brief The identity of the current thread, if it is a
+          worker of a ThreadPool.
+       */
+      inline static WorkerID& currentWorker()
+      {
+	static thread_local WorkerID id = {nullptr, 0};
+	return id;
+      }
+
+      /*! \brief The index of the deque of the current thread, or
+	  external if it is not a worker of this pool.
+       */
+      inline size_t workerIndex() const
+      {
+	const WorkerID& id = currentWorker();
+	return (id._pool == this) ? id._index : external;
+      }
+
+      template<class F>
+      inline void splitRange(TaskGroup& group, size_t begin, size_t end, size_t grain, const F& func)
+      {
+	while (end - begin > grain)
 	  {
-	    //We are in threaded mode! Wait until all tasks are gone
-	    //and all threads are idling
-	    std::unique_lock<std::mutex> lock1(_queue_mutex);      
-	    while (!_waitingFunctors.empty() 
-		   || (_idlingThreads != _threads.size()))
-	      _threadAvailable_condition.wait(lock1);
+	    const size_t mid = begin + (end - begin) / 2;
+	    group.run([this, &group, mid, end, grain, &func](){ splitRange(group, mid, end, grain, func); });
+	    end = mid;
 	  }
+	func(begin, end);
+      }
+
+      /*! \brief Queue a task on the deque of the current worker, or
+          in the injection queue if called from outside the pool.
+       */
+      inline void submit(Task* task)
+      {
+	//The task is counted before it is queued so that _queued
+	//never underflows.
+	_queued.fetch_add(1);
+
+	const size_t index = workerIndex();
+	if (index != external)
+	  _deques[index]->push(task);
 	else
 	  {
-	    //Non threaded mode
-	    while (!_waitingFunctors.empty())
+	    std::lock_guard<std::mutex> lock(_injectMutex);
+	    _injected.push_back(task);
+	    _injectedCount.fetch_add(1);
+	  }
+
+	//A sleeping worker increments _sleeping before checking
+	//_queued, so either it sees the new task or we see it.
+	if (_sleeping.load())
+	  {
+	    std::lock_guard<std::mutex> lock(_sleepMutex);
+	    _wake.notify_one();
+	  }
+      }
+
+      /*! \brief Queue a task which may only be run by one worker.
+
+	  Bound tasks are not counted in _queued, as only their worker
+	  may run them, so every sleeping worker is woken to find it.
+       */
+      inline void submitTo(size_t thread, Task* task)
+      {
+	if (_bound.empty())
+	  {
+	    submit(task);
+	    return;
+	  }
+
+	BoundQueue& queue = *_bound[thread % _bound.size()];
+	{
+	  std::lock_guard<std::mutex> lock(queue._mutex);
+	  queue._tasks.push_back(task);
+	  queue._count.fetch_add(1);
+	}
+
+	if (_sleeping.load())
+	  {
+	    std::lock_guard<std::mutex> lock(_sleepMutex);
+	    _wake.notify_all();
+	  }
+      }
+
+      /*! \brief Take a task from the current worker's bound queue, its
+          deque, the injection queue, or another worker's deque (in
+          that order).
+
+	  \return The task, or NULL if none could be found.
+       */
+      inline Task* findTask()
+      {
+	const size_t index = workerIndex();
+	Task* task = nullptr;
+
+	if ((index != external) && _bound[index]->_count.load(std::memory_order_relaxed))
+	  {
+	    BoundQueue& queue = *_bound[index];
+	    std::lock_guard<std::mutex> lock(queue._mutex);
+	    if (!queue._tasks.empty())
+	      {
+		task = queue._tasks.front();
+		queue._tasks.pop_front();
+		queue._count.fetch_sub(1);
+		return task;
+	      }
+	  }
+
+	if (index != external)
+	  task = _deques[index]->pop();
+
+	if (!task && _injectedCount.load(std::memory_order_relaxed))
+	  {
+	    std::lock_guard<std::mutex> lock(_injectMutex);
+	    if (!_injected.empty())
+	      {
+		task = _injected.front();
+		_injected.pop_front();
+		_injectedCount.fetch_sub(1);
+	      }
+	  }
+
+	if (!task && !_deques.empty())
+	  {
+	    static thread_local size_t victim = 0;
+	    for (size_t i(0); (i < _deques.size()) && !task; ++i)
 	      {
-		_waitingFunctors.front()();
-		_waitingFunctors.pop();
+		victim = (victim + 1) % _deques.size();
+		if (victim != index)
+		  task = _deques[victim]->steal();
 	      }
 	  }
-	
-	if (_exception_flag) 
-	  M_throw() << "Thread Exception found while waiting for tasks/threads to finish"
-		    << _exception_data.str();
+
+	if (task) _queued.fetch_sub(1);
+	return task;
       }
 
-      inline size_t getIdleThreadCount() { return _idlingThreads; }
-  
-    private:
-      /*! \brief Thread worker loop, called by the threads beginThreadFunc.
+      /*! \brief Execute one queued task, if there is one.
+
+	\return If a task was executed.
        */
-      inline void beginThread()
+      inline bool help()
+      {
+	Task* task = findTask();
+	if (!task) return false;
+	execute(task);
+	return true;
+      }
+
+      inline void execute(Task* task)
       {
-	try
+	std::exception_ptr exception;
+	try { task->_func(); }
+	catch (...) { exception = std::current_exception(); }
+
+	TaskGroup* group = task->_group;
+	delete task;
+	if (group) group->taskDone(exception);
+      }
+
+      /*! \brief Thread worker loop.
+       */
+      inline void beginThread(size_t index)
+      {
+	currentWorker()._pool = this;
+	currentWorker()._index = index;
+
+	if (_affinity && !_cpus.empty())
+	  pinThread(_cpus[index % _cpus.size()]);
+
+	size_t idle = 0;
+	while (!_stop.load())
 	  {
-	    std::unique_lock<std::mutex> lock1(_queue_mutex);
-	    
-	    while (!_stop_flag)
+	    if (help()) { idle = 0; continue; }
+
+	    if (++idle < spinCount)
 	      {
-		if (_waitingFunctors.empty())
-		  {
-		    ++_idlingThreads;
-		    //Let whoever is waiting know that the thread is now available
-		    _threadAvailable_condition.notify_all();
-		    //And send it to sleep
-		    _need_thread_mutex.wait(lock1);
-		    --_idlingThreads;
-		    continue;
-		  }
-		
-		std::function<void()> func = _waitingFunctors.front();
-		_waitingFunctors.pop();
-		
-		lock1.unlock();
-		
-		try { func(); }
-		catch(std::exception& cep)
-		  {
-		    //Mark the main process to throw an exception as soon as possible
-		    std::lock_guard<std::mutex> lock2(_exception_mutex);
-		    
-		    _exception_data << "\nTHREAD: Task threw an exception:-"
-				    << cep.what();
-		    
-		    _exception_flag = true;
-		  }
-		lock1.lock();
+		std::this_thread::yield();
+		continue;
 	      }
+
+	    idle = 0;
+	    std::unique_lock<std::mutex> lock(_sleepMutex);
+	    _sleeping.fetch_add(1);
+	    if (!_stop.load() && !_queued.load() && !_bound[index]->_count.load())
+	      _wake.wait(lock);
+	    _sleeping.fetch_sub(1);
 	  }
-	catch (std::exception& p)
+      }
+
+      /*! \brief (Re)start the pool with x threads.
+       */
+      inline void startThreads(size_t x)
+      {
+	stop();
+
+	_cpus = _affinity ? availableCPUs() : std::vector<size_t>();
+
+	_deques.clear();
+	_bound.clear();
+	for (size_t i(0); i < x; ++i)
 	  {
-	    std::cout << "\nTHREAD :Catastrophic Failure of thread!!! System will Hang, Aborting!"
-		      << p.what();
-	    throw;
+	    _deques.push_back(std::unique_ptr<WorkStealingDeque<Task*> >(new WorkStealingDeque<Task*>()));
+	    _bound.push_back(std::unique_ptr<BoundQueue>(new BoundQueue()));
 	  }
+
+	for (size_t i(0); i < x; ++i)
+	  _threads.create_thread(std::function<void()>(std::bind(&ThreadPool::beginThread, this, i)));
       }
-      
-      /*! \brief Halt the threadpool and terminate all the threads.
+
+      /*! \brief Terminate all the threads, and move any tasks left
+          on their deques and bound queues to the injection queue.
        */
       inline void stop()
       {
-	// _stop_flag must be set to true in a critical section.  Otherwise
-	// it is possible for a thread to miss notify_all and never
+	// _stop must be set in a critical section. Otherwise it is
+	// possible for a thread to miss notify_all and never
 	// terminate.
 	{
-	  std::unique_lock<std::mutex> lock1(_queue_mutex);
-	  _stop_flag = true;       
+	  std::lock_guard<std::mutex> lock(_sleepMutex);
+	  _stop = true;
 	}
-	
-	_need_thread_mutex.notify_all();
+
+	_wake.notify_all();
 	_threads.join_all();
+	_stop = false;
+
+	for (auto& deque : _deques)
+	  while (Task* task = deque->pop())
+	    {
+	      _injected.push_back(task);
+	      ++_injectedCount;
+	    }
+
+	for (auto& queue : _bound)
+	  {
+	    for (Task* task : queue->_tasks)
+	      {
+		_injected.push_back(task);
+		++_injectedCount;
+		++_queued;
+	      }
+	    queue->_tasks.clear();
+	    queue->_count = 0;
+	  }
       }
 
+      std::vector<std::unique_ptr<WorkStealingDeque<Task*> > > _deques;
+
+      //! The queues of the tasks bound to each worker.
+      std::vector<std::unique_ptr<BoundQueue> > _bound;
+
+      /*! \brief The queue of tasks submitted from outside the pool.
+       */
+      std::deque<Task*> _injected;
+      std::mutex _injectMutex;
+      std::atomic<size_t> _injectedCount;
+
+      //! The number of tasks queued but not yet started.
+      std::atomic<size_t> _queued;
+      std::atomic<size_t> _sleeping;
+      std::atomic<bool> _stop;
+
+      //! If the workers are bound to the CPUs in _cpus.
+      bool _affinity;
+      std::vector<size_t> _cpus;
+
+      std::mutex _sleepMutex;
+      std::condition_variable _wake;
+
+      magnet::thread::ThreadGroup _threads;
+
+      //! The task group used by queueTask() and wait().
+      TaskGroup _defaultGroup;
     };
+
+    inline void
+    TaskGroup::run(std::function<void()> task)
+    {
+      _pending.fetch_add(1);
+      _pool.submit(new ThreadPool::Task{std::move(task), this});
+    }
+
+    inline void
+    TaskGroup::runOn(size_t thread, std::function<void()> task)
+    {
+      _pending.fetch_add(1);
+      _pool.submitTo(thread, new ThreadPool::Task{std::move(task), this});
+    }
+
+    inline void
+    TaskGroup::wait()
+    {
+      size_t idle = 0;
+      while (_pending.load())
+	{
+	  if (_pool.help()) { idle = 0; continue; }
+
+	  if (++idle < ThreadPool::spinCount)
+	    {
+	      std::this_thread::yield();
+	      continue;
+	    }
+
+	  //The timeout lets the waiting thread help with any tasks
+	  //queued while it sleeps.
+	  std::unique_lock<std::mutex> lock(_mutex);
+	  _done.wait_for(lock, std::chrono::milliseconds(1), [this](){ return !_pending.load(); });
+	}
+
+      //Synchronise with the thread which completed the last task, as
+      //it may still be notifying _done and this group may be
+      //destroyed once wait() returns.
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_exception)
+	{
+	  std::exception_ptr exception = _exception;
+	  _exception = std::exception_ptr();
+	  std::rethrow_exception(exception);
+	}
+    }
+
+    inline void
+    TaskGroup::taskDone(std::exception_ptr exception)
+    {
+      if (exception)
+	{
+	  std::lock_guard<std::mutex> lock(_mutex);
+	  if (!_exception) _exception = exception;
+	}
+
+      //Only the last task of the group decrements _pending under the
+      //lock, as the waiting thread may destroy the group as soon as
+      //it sees _pending reach zero.
+      size_t pending = _pending.load();
+      while (pending > 1)
+	if (_pending.compare_exchange_weak(pending, pending - 1))
+	  return;
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_pending.fetch_sub(1) == 1)
+	_done.notify_all();
+    }
   }
 }
@@ -0,0 +1,182 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file workstealingdeque.hpp
+ * \brief Contains the definition of WorkStealingDeque
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+namespace magnet {
+  namespace thread {
+    /*! \brief A lock-free work-stealing deque of pointers.
+
+      This is the Chase-Lev deque (using the memory orderings of Lê et
+      al., "Correct and efficient work-stealing for weak memory
+      models", PPoPP 2013). A single owner thread pushes and pops
+      items at the bottom of the deque (LIFO order, which keeps the
+      working set of the owner in cache), while any number of thief
+      threads may steal items from the top (FIFO order, so the
+      thieves take the oldest, and typically largest, pieces of
+      work).
+
+      Only pointers may be stored, as the items must be read
+      atomically by the thieves. A null pointer is returned when the
+      deque is empty or a steal lost a race.
+
+      The deque grows without bound. The arrays replaced when growing
+      are kept until the deque is destroyed, as a thief may still be
+      reading from them.
+     */
+    template<class T>
+    class WorkStealingDeque
+    {
+      static_assert(std::is_pointer<T>::value, "WorkStealingDeque can only store pointers");
+
+      struct Array
+      {
+	Array(int64_t size): _size(size), _data(new std::atomic<T>[size]) {}
+
+	T get(int64_t i) const { return _data[i & (_size - 1)].load(std::memory_order_relaxed); }
+
+	void put(int64_t i, T x) { _data[i & (_size - 1)].store(x, std::memory_order_relaxed); }
+
+	const int64_t _size;
+	std::unique_ptr<std::atomic<T>[]> _data;
+      };
+
+    public:
+      /*! \brief Constructor.
+
+	\param capacity The initial capacity of the deque, which must
+	be a power of two.
+       */
+      WorkStealingDeque(int64_t capacity = 256):
+	_top(0), _bottom(0)
+      {
+	_arrays.push_back(std::unique_ptr<Array>(new Array(capacity)));
+	_array.store(_arrays.back().get(), std::memory_order_relaxed);
+      }
+
+      /*! \brief Add an item to the bottom of the deque.
+
+	This may only be called by the owner thread.
+       */
+      void push(T x)
+      {
+	const int64_t b = _bottom.load(std::memory_order_relaxed);
+	const int64_t t = _top.load(std::memory_order_acquire);
+	Array* a = _array.load(std::memory_order_relaxed);
+
+	if (b - t > a->_size - 1)
+	  a = grow(a, b, t);
+
+	a->put(b, x);
+	std::atomic_thread_fence(std::memory_order_release);
+	_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+
+      /*! \brief Remove the item at the bottom of the deque.
+
+	This may only be called by the owner thread.
+
+	\return The item, or a null pointer if the deque is empty.
+       */
+      T pop()
+      {
+	const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+	Array* a = _array.load(std::memory_order_relaxed);
+	_bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = _top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	  {
+	    //The deque was empty
+	    _bottom.store(b + 1, std::memory_order_relaxed);
+	    return nullptr;
+	  }
+
+	T x = a->get(b);
+	if (t == b)
+	  {
+	    //This is the last item, race the thieves for it
+	    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	      x = nullptr;
+	    _bottom.store(b + 1, std::memory_order_relaxed);
+	  }
+	return x;
+      }
+
+      /*! \brief Remove the item at the top of the deque.
+
+	This may be called by any thread.
+
+	\return The item, or a null pointer if the deque is empty or
+	another thread took the item first.
+       */
+      T steal()
+      {
+	int64_t t = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t b = _bottom.load(std::memory_order_acquire);
+
+	if (t >= b) return nullptr;
+
+	Array* a = _array.load(std::memory_order_acquire);
+	T x = a->get(t);
+	if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	  return nullptr;
+	return x;
+      }
+
+      /*! \brief A hint to whether the deque is empty. */
+      bool empty() const
+      { return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed); }
+
+    private:
+      WorkStealingDeque(const WorkStealingDeque&);
+      WorkStealingDeque& operator=(const WorkStealingDeque&);
+
+      Array* grow(Array* a, int64_t b, int64_t t)
+      {
+	std::unique_ptr<Array> newArray(new Array(2 * a->_size));
+	for (int64_t i(t); i < b; ++i)
+	  newArray->put(i, a->get(i));
+
+	a = newArray.get();
+	_arrays.push_back(std::move(newArray));
+	_array.store(a, std::memory_order_release);
+	return a;
+      }
+
+      //The indices are padded onto separate cache lines as the
+      //owner writes _bottom while the thieves write _top.
+      std::atomic<int64_t> _top;
+      char _pad1[64 - sizeof(std::atomic<int64_t>)];
+      std::atomic<int64_t> _bottom;
+      char _pad2[64 - sizeof(std::atomic<int64_t>)];
+      std::atomic<Array*> _array;
+      std::vector<std::unique_ptr<Array> > _arrays;
+    };
+  }
+}
@@ -0,0 +1,620 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.dynamomd.org
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <magnet/xmlreader.hpp>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/exception.hpp>
+#include <istream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <locale.h>
+
+namespace magnet {
+  namespace xml {
+    namespace detail {
+      /*! \brief Parses a floating point number from the text
+          [begin,end), independent of the current locale.
+
+	Numbers with at most 15 significant digits and a small
+	exponent are converted exactly using a single floating point
+	operation (Clinger's fast path), all others are passed to
+	strtod. Both paths are correctly rounded, so the result is
+	identical to boost::lexical_cast<double>.
+
+	\return false if the text is not entirely a number.
+       */
+      inline bool parseDouble(const char* begin, const char* end, double& value)
+      {
+	static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+					1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+					1e20, 1e21, 1e22};
+	const char* p = begin;
+	bool negative = false;
+	if ((p != end) && ((*p == '-') || (*p == '+')))
+	  negative = (*(p++) == '-');
+
+	uint64_t mantissa = 0;
+	int digits = 0, exponent = 0;
+	bool anyDigits = false;
+
+	for (; (p != end) && (*p >= '0') && (*p <= '9'); ++p, anyDigits = true)
+	  if (mantissa || (*p != '0'))
+	    {
+	      if (++digits > 15) break;
+	      mantissa = mantissa * 10 + (*p - '0');
+	    }
+
+	if ((digits <= 15) && (p != end) && (*p == '.'))
+	  for (++p; (p != end) && (*p >= '0') && (*p <= '9'); ++p, anyDigits = true)
+	    {
+	      if (mantissa || (*p != '0'))
+		if (++digits > 15) break;
+	      mantissa = mantissa * 10 + (*p - '0');
+	      --exponent;
+	    }
+
+	if ((digits <= 15) && anyDigits)
+	  {
+	    if ((p != end) && ((*p == 'e') || (*p == 'E')))
+	      {
+		++p;
+		bool negExp = false;
+		if ((p != end) && ((*p == '-') || (*p == '+')))
+		  negExp = (*(p++) == '-');
+		int exp = 0;
+		const char* expStart = p;
+		for (; (p != end) && (*p >= '0') && (*p <= '9') && (exp < 10000); ++p)
+		  exp = exp * 10 + (*p - '0');
+		if (p == expStart) return false;
+		exponent += negExp ? -exp : exp;
+	      }
+
+	    if ((p == end) && (exponent >= -22) && (exponent <= 22))
+	      {
+		value = double(mantissa);
+		if (exponent < 0)
+		  value /= powers[-exponent];
+		else
+		  value *= powers[exponent];
+		if (negative) value = -value;
+		return true;
+	      }
+	  }
+
+	//Slow path, the number is copied to allow strtod to find the
+	//end of the number.
+	static const locale_t cLocale = newlocale(LC_ALL_MASK, "C", locale_t(0));
+	char buffer[64];
+	if (end - begin >= int(sizeof(buffer))) return false;
+	std::memcpy(buffer, begin, end - begin);
+	buffer[end - begin] = '\0';
+	char* numEnd;
+	value = strtod_l(buffer, &numEnd, cLocale);
+	return (numEnd == buffer + (end - begin)) && (numEnd != buffer);
+      }
+    }
+
+    /*! \brief The attributes of a sequence of identical XML elements
+        (records), stored by column.
+
+      Each attribute of a record is stored in a column named after
+      the attribute (e.g., "ID"), and each attribute of a child
+      element of a record is stored in a column named after the
+      element and attribute (e.g., "P.x"). Values are converted to
+      double as they are parsed.
+     */
+    class RecordTable
+    {
+    public:
+      struct Column
+      {
+	Column(): _numeric(true) {}
+
+	//! The value of each record (NaN if missing or not numeric).
+	std::vector<double> _values;
+	//! If each record has this attribute.
+	std::vector<char> _present;
+	//! False if any present value was not a number.
+	bool _numeric;
+
+	void resize(size_t N)
+	{
+	  _values.resize(N, std::numeric_limits<double>::quiet_NaN());
+	  _present.resize(N, false);
+	}
+      };
+
+      RecordTable(): _size(0) {}
+
+      //! \brief The number of records.
+      inline size_t size() const { return _size; }
+
+      //! \brief Test if any record has the named attribute.
+      inline bool hasColumn(const std::string& name) const
+      { return _columns.find(name) != _columns.end(); }
+
+      /*! \brief Fetch a column, which may have missing or
+          non-numeric values.
+
+	\return The column, or NULL if no record has the named
+	attribute.
+       */
+      inline const Column* findColumn(const std::string& name) const
+      {
+	std::map<std::string, Column>::const_iterator it = _columns.find(name);
+	return (it != _columns.end()) ? &(it->second) : NULL;
+      }
+
+      /*! \brief Fetch a numeric attribute of all the records.
+
+	An exception is thrown if any record is missing the
+	attribute, or if any value is not a number.
+       */
+      inline const std::vector<double>& getColumn(const std::string& name) const
+      {
+	std::map<std::string, Column>::const_iterator it = _columns.find(name);
+	if (it == _columns.end())
+	  M_throw() << "XML error: The attribute \"" << name << "\" is missing from the " << _recordTag << " records";
+
+	for (size_t i(0); i < _size; ++i)
+	  if (!it->second._present[i])
+	    M_throw() << "XML error: The attribute \"" << name << "\" is missing from " << _recordTag << " record " << i;
+
+	if (!it->second._numeric)
+	  M_throw() << "XML error: The attribute \"" << name << "\" of the " << _recordTag << " records is not numeric";
+
+	return it->second._values;
+      }
+
+      /*! \brief Append the records of another table to this table.
+       */
+      inline void append(const RecordTable& other)
+      {
+	for (std::map<std::string, Column>::const_iterator it = other._columns.begin();
+	     it != other._columns.end(); ++it)
+	  {
+	    Column& column = _columns[it->first];
+	    column.resize(_size);
+	    column._values.insert(column._values.end(), it->second._values.begin(), it->second._values.end());
+	    column._present.insert(column._present.end(), it->second._present.begin(), it->second._present.end());
+	    column._numeric = column._numeric && it->second._numeric;
+	  }
+
+	_size += other._size;
+	for (std::map<std::string, Column>::iterator it = _columns.begin(); it != _columns.end(); ++it)
+	  it->second.resize(_size);
+      }
+
+      /*! \brief Parse a sequence of complete records from the text
+          [p, end).
+
+	The records are appended to this table. Only a subset of XML
+	is supported: records may contain attributes and child
+	elements with attributes, but no text or deeper nesting.
+       */
+      inline void parse(const char* p, const char* end, const std::string& recordTag)
+      {
+	_recordTag = recordTag;
+	const char* const start = p;
+	size_t depth = 0;
+	std::string prefix;
+	std::string name;
+
+	while (true)
+	  {
+	    while ((p != end) && isSpace(*p)) ++p;
+	    if (p == end) break;
+
+	    if (*p != '<') error(start, p, end, "Unexpected text");
+
+	    if ((end - p >= 4) && !std::strncmp(p, "<!--", 4))
+	      {
+		const char* close = std::search(p, end, "-->", "-->" + 3);
+		if (close == end) error(start, p, end, "Unterminated comment");
+		p = close + 3;
+		continue;
+	      }
+
+	    if ((end - p >= 2) && (p[1] == '/'))
+	      {
+		p += 2;
+		while ((p != end) && (*p != '>')) ++p;
+		if ((p == end) || !depth) error(start, p, end, "Unexpected closing tag");
+		++p;
+		--depth;
+		continue;
+	      }
+
+	    ++p;
+	    const char* nameStart = p;
+	    while ((p != end) && !isSpace(*p) && (*p != '>') && (*p != '/')) ++p;
+	    name.assign(nameStart, p);
+
+	    if (depth == 0)
+	      {
+		if (name != recordTag)
+		  error(start, nameStart, end, "Expected a " + recordTag + " element");
+		++_size;
+		prefix.clear();
+	      }
+	    else if (depth == 1)
+	      prefix = name + ".";
+	    else
+	      error(start, nameStart, end, "The elements are nested too deeply");
+
+	    //Parse the attributes
+	    while (true)
+	      {
+		while ((p != end) && isSpace(*p)) ++p;
+		if (p == end) error(start, p, end, "Unterminated element");
+		if (*p == '>') { ++p; ++depth; break; }
+		if (*p == '/')
+		  {
+		    if ((end - p < 2) || (p[1] != '>')) error(start, p, end, "Malformed element");
+		    p += 2;
+		    break;
+		  }
+
+		const char* attrStart = p;
+		while ((p != end) && !isSpace(*p) && (*p != '=')) ++p;
+		const char* attrEnd = p;
+		while ((p != end) && isSpace(*p)) ++p;
+		if ((p == end) || (*p != '=')) error(start, p, end, "Malformed attribute");
+		++p;
+		while ((p != end) && isSpace(*p)) ++p;
+		if ((p == end) || ((*p != '"') && (*p != '\''))) error(start, p, end, "Malformed attribute");
+		const char quote = *(p++);
+		const char* valueStart = p;
+		while ((p != end) && (*p != quote)) ++p;
+		if (p == end) error(start, valueStart, end, "Unterminated attribute value");
+
+		Column& column = _columns[prefix + std::string(attrStart, attrEnd)];
+		column.resize(_size);
+		double value;
+		if (detail::parseDouble(valueStart, p, value))
+		  column._values[_size - 1] = value;
+		else
+		  column._numeric = false;
+		column._present[_size - 1] = true;
+		++p;
+	      }
+	  }
+
+	if (depth)
+	  error(start, p, end, "Unterminated " + recordTag + " element");
+
+	for (std::map<std::string, Column>::iterator it = _columns.begin(); it != _columns.end(); ++it)
+	  it->second.resize(_size);
+      }
+
+    private:
+      static inline bool isSpace(char c)
+      { return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r'); }
+
+      inline void error(const char* start, const char* p, const char* end, const std::string& msg) const
+      {
+	const char* lineStart = p;
+	while ((lineStart != start) && (*(lineStart - 1) != '\n')) --lineStart;
+	const char* lineEnd = p;
+	while ((lineEnd != end) && (*lineEnd != '\n')) ++lineEnd;
+
+	M_throw() << "XML error: " << msg << " while parsing the " << _recordTag << " records\n"
+		  << std::string(lineStart, lineEnd) << "\n"
+		  << std::string(p - lineStart, ' ') << "^";
+      }
+
+      std::map<std::string, Column> _columns;
+      size_t _size;
+      std::string _recordTag;
+    };
+
+    /*! \brief An XML Document which is loaded from a stream, where the
+        records within one bulk element are parsed in parallel into
+        a RecordTable.
+
+      Loading a large document into a Document requires the entire
+      text to be held in memory while it is parsed. This class reads
+      the stream on a separate thread (so that any decompression is
+      overlapped with the parsing), and passes chunks of the text of
+      the bulk element to a ThreadPool to be parsed into a
+      RecordTable as they arrive. Only the small remainder of the
+      document is stored and parsed as a Document, where the bulk
+      element appears empty (but with its attributes).
+
+      The memory used for the text is bounded by the block and chunk
+      sizes, and not by the size of the document.
+     */
+    class StreamingDocument: public Document
+    {
+    public:
+      /*! \brief Constructor.
+
+	\param blockSize The size of the blocks read from the stream.
+	\param chunkSize The approximate size of the text of the
+	records parsed by each task.
+	\param maxBlocks The maximum number of blocks read ahead of
+	the parsing.
+       */
+      StreamingDocument(size_t blockSize = 1 << 20, size_t chunkSize = 1 << 20, size_t maxBlocks = 8):
+	_blockSize(blockSize),
+	_chunkSize(chunkSize),
+	_maxBlocks(maxBlocks)
+      {}
+
+      /*! \brief Load and parse a Document from a stream.
+
+	\param in The stream to read the document from.
+	\param bulkTag The name of the element containing the records.
+	\param recordTag The name of the record elements.
+	\param pool The ThreadPool used to parse the records.
+       */
+      inline void load(std::istream& in, const std::string& bulkTag, const std::string& recordTag,
+		       magnet::thread::ThreadPool& pool)
+      {
+	_records = RecordTable();
+	_data.clear();
+	_in = &in;
+	_eof = false;
+	_stop = false;
+	_readError = std::exception_ptr();
+	_blocks.clear();
+
+	std::thread reader(std::bind(&StreamingDocument::readBlocks, this));
+	try {
+	  split(bulkTag, recordTag, pool);
+	} catch (...)
+	  {
+	    {
+	      std::lock_guard<std::mutex> lock(_mutex);
+	      _stop = true;
+	    }
+	    _blockTaken.notify_all();
+	    reader.join();
+	    throw;
+	  }
+	reader.join();
+
+	parseData();
+      }
+
+      //! \brief The records of the bulk element.
+      inline const RecordTable& getRecords() const { return _records; }
+
+    private:
+      enum State { HEADER, BULK, TRAILER };
+
+      /*! \brief The reading thread, which places blocks of the
+          stream in the _blocks queue.
+       */
+      inline void readBlocks()
+      {
+	try {
+	  while (true)
+	    {
+	      std::string block(_blockSize, '\0');
+	      _in->read(&block[0], _blockSize);
+	      block.resize(_in->gcount());
+	      if (block.empty()) break;
+
+	      std::unique_lock<std::mutex> lock(_mutex);
+	      while (!_stop && (_blocks.size() >= _maxBlocks))
+		_blockTaken.wait(lock);
+	      if (_stop) return;
+	      _blocks.push_back(std::string());
+	      _blocks.back().swap(block);
+	      _blockAdded.notify_one();
+	    }
+	} catch (...)
+	  {
+	    std::lock_guard<std::mutex> lock(_mutex);
+	    _readError = std::current_exception();
+	  }
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_eof = true;
+	_blockAdded.notify_one();
+      }
+
+      /*! \brief Fetch the next block of the stream.
+
+	\return false once the stream is finished.
+       */
+      inline bool nextBlock(std::string& block)
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (_blocks.empty() && !_eof)
+	  _blockAdded.wait(lock);
+
+	if (_blocks.empty())
+	  {
+	    if (_readError) std::rethrow_exception(_readError);
+	    return false;
+	  }
+
+	block.swap(_blocks.front());
+	_blocks.pop_front();
+	_blockTaken.notify_one();
+	return true;
+      }
+
+      /*! \brief Find a tag opening in text, starting at from.
+       */
+      static inline size_t findTag(const std::string& text, const std::string& tag, size_t from)
+      {
+	for (size_t pos = text.find(tag, from); pos != std::string::npos; pos = text.find(tag, pos + 1))
+	  if ((pos + tag.size() < text.size()))
+	    {
+	      const char c = text[pos + tag.size()];
+	      if ((c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '>') || (c == '/'))
+		return pos;
+	    }
+	return std::string::npos;
+      }
+
+      /*! \brief Find the last tag opening in text.
+       */
+      static inline size_t rfindTag(const std::string& text, const std::string& tag)
+      {
+	for (size_t pos = text.rfind(tag); pos != std::string::npos; pos = pos ? text.rfind(tag, pos - 1) : std::string::npos)
+	  if ((pos + tag.size() < text.size()))
+	    {
+	      const char c = text[pos + tag.size()];
+	      if ((c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '>') || (c == '/'))
+		return pos;
+	    }
+	return std::string::npos;
+      }
+
+      /*! \brief Split the stream into the Document text and the
+          records, and parse the records.
+       */
+      inline void split(const std::string& bulkTag, const std::string& recordTag,
+			magnet::thread::ThreadPool& pool)
+      {
+	const std::string bulkOpen = "<" + bulkTag;
+	const std::string bulkClose = "</" + bulkTag;
+	const std::string recordOpen = "<" + recordTag;
+	const size_t maxInFlight = 2 * pool.getThreadCount() + 2;
+
+	State state = HEADER;
+	std::string pending, block;
+	size_t searchFrom = 0;
+
+	std::vector<RecordTable> batch;
+	std::vector<std::string> batchText;
+	magnet::thread::TaskGroup group(pool);
+
+	bool more = true;
+	while (more)
+	  {
+	    more = nextBlock(block);
+	    if (more)
+	      {
+		if (state == TRAILER)
+		  _data += block;
+		else
+		  pending += block;
+	      }
+
+	    if (state == HEADER)
+	      {
+		const size_t pos = findTag(pending, bulkOpen, searchFrom);
+		if (pos == std::string::npos)
+		  {
+		    if (pending.size() > bulkOpen.size())
+		      searchFrom = pending.size() - bulkOpen.size();
+		    continue;
+		  }
+
+		const size_t close = pending.find('>', pos);
+		if (close == std::string::npos) { searchFrom = pos; continue; }
+
+		_data.append(pending, 0, close + 1);
+		pending.erase(0, close + 1);
+		state = (_data[_data.size() - 2] == '/') ? TRAILER : BULK;
+		if (state == TRAILER)
+		  {
+		    _data += pending;
+		    pending.clear();
+		    continue;
+		  }
+		searchFrom = 0;
+	      }
+
+	    if (state == BULK)
+	      {
+		const size_t close = pending.find(bulkClose, searchFrom);
+		size_t cut = std::string::npos;
+		if (close != std::string::npos)
+		  cut = close;
+		else if ((pending.size() >= _chunkSize) || !more)
+		  {
+		    cut = rfindTag(pending, recordOpen);
+		    if (cut == 0) cut = std::string::npos;
+		  }
+
+		if (close == std::string::npos)
+		  searchFrom = (pending.size() > bulkClose.size()) ? pending.size() - bulkClose.size() : 0;
+
+		if (cut != std::string::npos)
+		  {
+		    batchText.push_back(pending.substr(0, cut));
+		    pending.erase(0, cut);
+		    searchFrom = 0;
+		  }
+
+		if ((batchText.size() >= maxInFlight) || (close != std::string::npos) || !more)
+		  {
+		    batch.resize(batchText.size());
+		    for (size_t i(0); i < batchText.size(); ++i)
+		      group.run([&batch, &batchText, &recordTag, i]()
+				{
+				  const std::string& text = batchText[i];
+				  batch[i].parse(text.data(), text.data() + text.size(), recordTag);
+				});
+		    group.wait();
+
+		    for (const RecordTable& table : batch)
+		      _records.append(table);
+		    batch.clear();
+		    batchText.clear();
+		  }
+
+		if (close != std::string::npos)
+		  {
+		    _data += pending;
+		    pending.clear();
+		    state = TRAILER;
+		  }
+		else if (!more)
+		  M_throw() << "XML error: The " << bulkTag << " element is not terminated";
+	      }
+	  }
+
+	if (state == HEADER)
+	  _data += pending;
+      }
+
+      RecordTable _records;
+
+      std::istream* _in;
+      std::deque<std::string> _blocks;
+      std::mutex _mutex;
+      std::condition_variable _blockAdded;
+      std::condition_variable _blockTaken;
+      bool _eof;
+      bool _stop;
+      std::exception_ptr _readError;
+
+      const size_t _blockSize;
+      const size_t _chunkSize;
+      const size_t _maxBlocks;
+    };
+  }
+}
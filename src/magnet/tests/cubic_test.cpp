@@ -3,6 +3,59 @@
 #include <vector>
 #include "quartic_original.hpp"
 #include <complex>
+#include <random>
+#include <cstring>
+
+//The coefficients of every cubic tested, to check the batched solver
+std::vector<double> batchP, batchQ, batchR;
+
+/* Check the batched cubicSolve gives exactly the same roots as the
+   scalar form.
+ */
+size_t checkBatch()
+{
+  //Add some random cubics, including the special cases
+  std::mt19937 RNG(42);
+  std::uniform_real_distribution<double> exponent(-12, 12);
+  std::uniform_int_distribution<int> choice(0, 9);
+  for (size_t i(0); i < 100000; ++i)
+    {
+      double coeffs[3];
+      for (double& coeff : coeffs)
+	switch (choice(RNG))
+	  {
+	  case 0: coeff = 0; break;
+	  case 1: coeff = (choice(RNG) < 5 ? 1 : -1) * 1e200; break;
+	  default: coeff = (choice(RNG) < 5 ? 1 : -1) * std::pow(10.0, exponent(RNG));
+	  }
+      batchP.push_back(coeffs[0]);
+      batchQ.push_back(coeffs[1]);
+      batchR.push_back(coeffs[2]);
+    }
+
+  const size_t N = batchP.size();
+  std::vector<double> root1(N), root2(N), root3(N);
+  std::vector<size_t> count(N);
+  double* const roots[3] = {root1.data(), root2.data(), root3.data()};
+  magnet::math::cubicSolve(batchP.data(), batchQ.data(), batchR.data(), roots, count.data(), N);
+
+  size_t errors = 0;
+  for (size_t i(0); i < N; ++i)
+    {
+      double scalar[3];
+      size_t scalarcount = magnet::math::cubicSolve(batchP[i], batchQ[i], batchR[i], scalar[0], scalar[1], scalar[2]);
+
+      bool match = (scalarcount == count[i]);
+      for (size_t j(0); match && (j < scalarcount); ++j)
+	match = !std::memcmp(&scalar[j], &roots[j][i], sizeof(double));
+
+      if (!match && (++errors < 10))
+	std::cout << "\nBatched cubicSolve mismatch for p=" << batchP[i] << " q=" << batchQ[i] << " r=" << batchR[i];
+    }
+
+  std::cout << "\nTested " << N << " cubics with the batched solver, " << errors << " mismatches\n";
+  return errors;
+}
 
 int main()
 {
@@ -30,6 +83,7 @@ int main()
 	    + rootvals[root1] * rootvals[root3]
 	    + rootvals[root2] * rootvals[root3],
 	    c = - rootvals[root1] * rootvals[root2] * rootvals[root3];
+	  batchP.push_back(a); batchQ.push_back(b); batchR.push_back(c);
 	  
 	  std::vector<double> originals(3);
 	  originals[0] = rootvals[root1];
@@ -118,6 +172,7 @@ int main()
 		 + root1val * root3val
 		 + root2val * root3val).real(),
 	    c = - (root1val * root2val * root3val).real();
+	  batchP.push_back(a); batchQ.push_back(b); batchR.push_back(c);
 	  
 	  std::vector<double> roots(3);
 	  
@@ -178,5 +233,7 @@ int main()
   std::cout << "\nTested " << counter << " single roots";
   std::cout << "\nFound " << errors << " errors\n";
 
+  if (checkBatch()) return 1;
+
   return (errors < 37) ? 0 : 1;
 }
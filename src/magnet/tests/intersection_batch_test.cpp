@@ -0,0 +1,137 @@
+#include <magnet/intersection/ray_sphere.hpp>
+#include <magnet/intersection/parabola_sphere.hpp>
+#include <magnet/intersection/parabola_plane.hpp>
+#include <magnet/intersection/ray_cube.hpp>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cmath>
+
+using namespace magnet;
+using magnet::math::Vector;
+
+/* Checks the batched intersection tests give exactly the same results
+   as the scalar tests, and benchmarks the two.
+ */
+
+std::mt19937 RNG(1234);
+
+double uniform(double min, double max)
+{ return std::uniform_real_distribution<double>(min, max)(RNG); }
+
+double elapsed(std::chrono::high_resolution_clock::time_point start)
+{ return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count(); }
+
+//A batch of vectors, held in structure-of-arrays form
+struct VectorArray
+{
+  VectorArray(size_t N)
+  {
+    for (size_t n(0); n < NDIM; ++n)
+      {
+	_data[n].resize(N);
+	ptrs[n] = _data[n].data();
+      }
+  }
+
+  Vector operator[](size_t i) const
+  { return Vector(ptrs[0][i], ptrs[1][i], ptrs[2][i]); }
+
+  void set(size_t i, const Vector& vec)
+  {
+    for (size_t n(0); n < NDIM; ++n)
+      ptrs[n][i] = vec[n];
+  }
+
+  double* ptrs[NDIM];
+
+private:
+  std::vector<double> _data[NDIM];
+};
+
+/* A random vector, with a few components exactly zero to test the
+   special cases of the tests.
+ */
+Vector randomVector(double magnitude)
+{
+  Vector vec;
+  for (size_t n(0); n < NDIM; ++n)
+    vec[n] = (uniform(0, 1) < 0.05) ? 0 : uniform(-magnitude, magnitude);
+  return vec;
+}
+
+size_t compare(const std::vector<double>& scalar, const std::vector<double>& batched, const char* name)
+{
+  size_t errors(0);
+  for (size_t i(0); i < scalar.size(); ++i)
+    if (std::memcmp(&scalar[i], &batched[i], sizeof(double)) && (++errors < 10))
+      std::cerr << name << ": scalar " << scalar[i] << " != batched " << batched[i] << " for entry " << i << "\n";
+
+  std::cout << name << ": " << scalar.size() << " tests, " << errors << " mismatches\n";
+  return errors;
+}
+
+template<class Scalar, class Batched>
+size_t test(Scalar scalar, Batched batched, const char* name, size_t N)
+{
+  std::vector<double> scalar_dt(N), batched_dt(N);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i(0); i < N; ++i)
+    scalar_dt[i] = scalar(i);
+  const double scalar_time = elapsed(start);
+
+  start = std::chrono::high_resolution_clock::now();
+  batched(batched_dt.data());
+  const double batched_time = elapsed(start);
+
+  std::cout << name << ": scalar " << scalar_time << "s, batched " << batched_time << "s\n";
+  return compare(scalar_dt, batched_dt, name);
+}
+
+int main()
+{
+  const size_t N = 200000;
+  VectorArray T(N), D(N), G(N), Norm(N), C(N);
+  std::vector<double> r(N);
+
+  for (size_t i(0); i < N; ++i)
+    {
+      T.set(i, randomVector(2));
+      D.set(i, randomVector(1));
+      G.set(i, randomVector(1));
+      Norm.set(i, randomVector(1) / std::max(randomVector(1).nrm(), 1e-3));
+      C.set(i, Vector(uniform(0.1, 2), uniform(0.1, 2), uniform(0.1, 2)));
+      r[i] = uniform(0.5, 1.5);
+    }
+
+  size_t errors(0);
+
+  errors += test([&](size_t i) { return intersection::ray_sphere(T[i], D[i], r[i]); },
+		 [&](double* dt) { intersection::ray_sphere(T.ptrs, D.ptrs, r.data(), dt, N); },
+		 "ray_sphere", N);
+
+  errors += test([&](size_t i) { return intersection::ray_inv_sphere(T[i], D[i], r[i]); },
+		 [&](double* dt) { intersection::ray_inv_sphere(T.ptrs, D.ptrs, r.data(), dt, N); },
+		 "ray_inv_sphere", N);
+
+  errors += test([&](size_t i) { return intersection::parabola_sphere(T[i], D[i], G[i], r[i]); },
+		 [&](double* dt) { intersection::parabola_sphere(T.ptrs, D.ptrs, G.ptrs, r.data(), dt, N); },
+		 "parabola_sphere", N);
+
+  errors += test([&](size_t i) { return intersection::parabola_invsphere(T[i], D[i], G[i], r[i]); },
+		 [&](double* dt) { intersection::parabola_invsphere(T.ptrs, D.ptrs, G.ptrs, r.data(), dt, N); },
+		 "parabola_invsphere", N);
+
+  errors += test([&](size_t i) { return intersection::parabola_plane(T[i], D[i], G[i], Norm[i], r[i]); },
+		 [&](double* dt) { intersection::parabola_plane(T.ptrs, D.ptrs, G.ptrs, Norm.ptrs, r.data(), dt, N); },
+		 "parabola_plane", N);
+
+  errors += test([&](size_t i) { return intersection::ray_AAcube(T[i], D[i], C[i]); },
+		 [&](double* dt) { intersection::ray_AAcube(T.ptrs, D.ptrs, C.ptrs, dt, N); },
+		 "ray_AAcube", N);
+
+  return errors != 0;
+}
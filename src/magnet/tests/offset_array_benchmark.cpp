@@ -0,0 +1,69 @@
+#include <magnet/containers/offset_array.hpp>
+#include <unordered_map>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+using magnet::containers::OffsetArray;
+
+/* Benchmarks the W(E) lookups of a multicanonical simulation in an
+   OffsetArray against an unordered_map. This is not a test, build it
+   with "bjam src/magnet//offsetarray-benchmark".
+ */
+
+int main()
+{
+  //The energy takes a random walk of single steps over a range of
+  //bins
+  const long bins = 2000;
+  OffsetArray<double> W;
+  std::unordered_map<int, double> Wmap;
+  for (long i(-bins); i < 0; ++i)
+    {
+      W[i] = std::sin(0.01 * i);
+      Wmap[i] = std::sin(0.01 * i);
+    }
+
+  std::mt19937 gen(1);
+  std::vector<double> energies(1000000);
+  double E = -bins / 2;
+  for (double& e : energies)
+    {
+      E += (gen() % 2) ? 1 : -1;
+      e = E;
+    }
+
+  const size_t repeats = 20;
+  double sumArray = 0, sumMap = 0;
+
+  const auto arrayStart = std::chrono::high_resolution_clock::now();
+  for (size_t r(0); r < repeats; ++r)
+    for (const double e : energies)
+      sumArray += W(lrint(e)) - W(lrint(e - 1));
+  const auto arrayEnd = std::chrono::high_resolution_clock::now();
+
+  for (size_t r(0); r < repeats; ++r)
+    for (const double e : energies)
+      {
+	auto it1 = Wmap.find(lrint(e));
+	auto it2 = Wmap.find(lrint(e - 1));
+	sumMap += ((it1 != Wmap.end()) ? it1->second : 0) - ((it2 != Wmap.end()) ? it2->second : 0);
+      }
+  const auto mapEnd = std::chrono::high_resolution_clock::now();
+
+  if (sumArray != sumMap)
+    {
+      std::cerr << "Lookups do not match the unordered_map, " << sumArray << " != " << sumMap << std::endl;
+      return 1;
+    }
+
+  std::cout << "W(E) lookups: OffsetArray "
+	    << std::chrono::duration<double>(arrayEnd - arrayStart).count()
+	    << "s, unordered_map "
+	    << std::chrono::duration<double>(mapEnd - arrayEnd).count()
+	    << "s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <magnet/containers/offset_array.hpp>
+#include <unordered_map>
+#include <iostream>
+#include <random>
+#include <cmath>
+
+using magnet::containers::OffsetArray;
+
+int main()
+{
+  OffsetArray<double> array;
+
+  if (!array.empty() || (array(5) != 0) || (array(-5) != 0) || !array.empty())
+    {
+      std::cerr << "Reading an empty array stored a value or did not return the default" << std::endl;
+      return 1;
+    }
+
+  //Extend upwards, then downwards, past the existing range
+  array[3] = 1;
+  array[7] = 2;
+  array[-4] = 3;
+
+  if ((array.begin_index() != -4) || (array.end_index() != 8) || (array.size() != 12))
+    {
+      std::cerr << "Bad range [" << array.begin_index() << "," << array.end_index() << ")" << std::endl;
+      return 1;
+    }
+
+  for (long i(-10); i < 10; ++i)
+    {
+      const double expected = (i == 3) ? 1 : (i == 7) ? 2 : (i == -4) ? 3 : 0;
+      if ((array(i) != expected) || (array.inRange(i) != ((i >= -4) && (i < 8))))
+	{
+	  std::cerr << "Bad value or range at " << i << std::endl;
+	  return 1;
+	}
+    }
+
+  //A non-zero default fills the new elements
+  OffsetArray<int> filled(-1);
+  filled[10] = 5;
+  filled[6] = 4;
+  if ((filled(7) != -1) || (filled(100) != -1) || (filled(6) != 4) || (filled(10) != 5))
+    {
+      std::cerr << "Default values were not used when extending" << std::endl;
+      return 1;
+    }
+
+  //Check the lookups of a multicanonical simulation, where the
+  //energy takes a random walk of single steps over a range of bins,
+  //against a hash table of the same values.
+  const long bins = 2000;
+  OffsetArray<double> W;
+  std::unordered_map<int, double> Wmap;
+  for (long i(-bins); i < 0; ++i)
+    {
+      W[i] = std::sin(0.01 * i);
+      Wmap[i] = std::sin(0.01 * i);
+    }
+
+  std::mt19937 gen(1);
+  long E = -bins / 2;
+  for (size_t step(0); step < 100000; ++step)
+    {
+      E += (gen() % 2) ? 1 : -1;
+      auto it = Wmap.find(E);
+      if (W(E) != ((it != Wmap.end()) ? it->second : 0))
+	{
+	  std::cerr << "Lookup of " << E << " does not match the unordered_map" << std::endl;
+	  return 1;
+	}
+    }
+
+  std::cout << "Finished" << std::endl;
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include <magnet/math/philox.hpp>
+#include <iostream>
+#include <random>
+#include <cmath>
+
+using magnet::math::Philox4x32;
+
+bool checkBlock(const Philox4x32::Block& value, const Philox4x32::Block& expected)
+{
+  for (size_t i(0); i < 4; ++i)
+    if (value[i] != expected[i])
+      {
+	std::cerr << "Known answer test failed" << std::endl;
+	return false;
+      }
+  return true;
+}
+
+int main()
+{
+  //The known answer tests of the Random123 library
+  if (!checkBlock(Philox4x32::bijection({{0, 0}}, {{0, 0, 0, 0}}),
+		  {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}})
+      || !checkBlock(Philox4x32::bijection({{0xffffffff, 0xffffffff}}, {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}),
+		     {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}})
+      || !checkBlock(Philox4x32::bijection({{0xa4093822, 0x299f31d0}}, {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}),
+		     {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}))
+    return 1;
+
+  //Jumping within a stream must match drawing the values
+  Philox4x32 gen(12345, 7);
+  for (size_t i(0); i < 1001; ++i) gen();
+  Philox4x32 jumped(12345, 7);
+  jumped.discard(1001);
+  if ((gen != jumped) || (gen() != jumped()))
+    {
+      std::cerr << "Discarding values does not match drawing them" << std::endl;
+      return 1;
+    }
+
+  //A rough check of the distribution of a stream
+  Philox4x32 uniform(42, 0);
+  std::uniform_real_distribution<double> dist;
+  const size_t N = 1000000;
+  double sum = 0, sum2 = 0;
+  for (size_t i(0); i < N; ++i)
+    {
+      const double x = dist(uniform);
+      sum += x;
+      sum2 += x * x;
+    }
+
+  const double mean = sum / N, var = sum2 / N - mean * mean;
+  if ((std::abs(mean - 0.5) > 0.002) || (std::abs(var - 1.0 / 12) > 0.001))
+    {
+      std::cerr << "Bad uniform distribution, mean = " << mean << ", variance = " << var << std::endl;
+      return 1;
+    }
+
+  //Neighbouring streams must not be correlated
+  Philox4x32 s1(42, 1), s2(42, 2);
+  double corr = 0;
+  for (size_t i(0); i < N; ++i)
+    corr += (dist(s1) - 0.5) * (dist(s2) - 0.5);
+  corr *= 12.0 / N;
+  if (std::abs(corr) > 0.01)
+    {
+      std::cerr << "Streams are correlated, correlation = " << corr << std::endl;
+      return 1;
+    }
+
+  std::cout << "Finished" << std::endl;
+  return 0;
+}
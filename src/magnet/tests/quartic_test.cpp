@@ -3,6 +3,62 @@
 #include <vector>
 #include "quartic_original.hpp"
 #include <complex>
+#include <random>
+#include <cstring>
+
+//The coefficients of every quartic tested, to check the batched solver
+std::vector<double> batchA, batchB, batchC, batchD;
+
+/* Check the batched quarticSolve gives exactly the same roots as the
+   scalar form.
+ */
+size_t checkBatch()
+{
+  //Add some random quartics, including the special cases
+  std::mt19937 RNG(42);
+  std::uniform_real_distribution<double> exponent(-12, 12);
+  std::uniform_int_distribution<int> choice(0, 9);
+  for (size_t i(0); i < 100000; ++i)
+    {
+      double coeffs[4];
+      for (double& coeff : coeffs)
+	switch (choice(RNG))
+	  {
+	  case 0: coeff = 0; break;
+	  case 1: coeff = (choice(RNG) < 5 ? 1 : -1) * 1e200; break;
+	  default: coeff = (choice(RNG) < 5 ? 1 : -1) * std::pow(10.0, exponent(RNG));
+	  }
+      batchA.push_back(coeffs[0]);
+      batchB.push_back(coeffs[1]);
+      batchC.push_back(coeffs[2]);
+      batchD.push_back(coeffs[3]);
+    }
+
+  const size_t N = batchA.size();
+  std::vector<double> root1(N), root2(N), root3(N), root4(N);
+  std::vector<size_t> count(N);
+  double* const roots[4] = {root1.data(), root2.data(), root3.data(), root4.data()};
+  magnet::math::quarticSolve(batchA.data(), batchB.data(), batchC.data(), batchD.data(), roots, count.data(), N);
+
+  size_t errors = 0;
+  for (size_t i(0); i < N; ++i)
+    {
+      double scalar[4];
+      size_t scalarcount = magnet::math::quarticSolve(batchA[i], batchB[i], batchC[i], batchD[i],
+						      scalar[0], scalar[1], scalar[2], scalar[3]);
+
+      bool match = (scalarcount == count[i]);
+      for (size_t j(0); match && (j < scalarcount); ++j)
+	match = !std::memcmp(&scalar[j], &roots[j][i], sizeof(double));
+
+      if (!match && (++errors < 10))
+	std::cout << "\nBatched quarticSolve mismatch for a=" << batchA[i] << " b=" << batchB[i]
+		  << " c=" << batchC[i] << " d=" << batchD[i];
+    }
+
+  std::cout << "\nTested " << N << " quartics with the batched solver, " << errors << " mismatches\n";
+  return errors;
+}
 
 int main()
 {
@@ -47,6 +103,7 @@ int main()
 
  	    std::vector<double> roots(4);
 	    
+	    batchA.push_back(a); batchB.push_back(b); batchC.push_back(c); batchD.push_back(d);
  	    size_t rootcount = magnet::math::quarticSolve(a, b, c, d,
  							  roots[0], roots[1], 
 							  roots[2], roots[3]);
@@ -200,6 +257,7 @@ int main()
 	    
  	    std::vector<double> roots(4);
 	    
+	    batchA.push_back(a); batchB.push_back(b); batchC.push_back(c); batchD.push_back(d);
  	    size_t rootcount = magnet::math::quarticSolve(a, b, c, d,
  							  roots[0], roots[1], 
 							  roots[2], roots[3]);
@@ -349,6 +407,7 @@ int main()
 	    
  	    std::vector<double> roots(4);
 	    
+	    batchA.push_back(a); batchB.push_back(b); batchC.push_back(c); batchD.push_back(d);
  	    size_t rootcount = magnet::math::quarticSolve(a, b, c, d,
  							  roots[0], roots[1], 
 							  roots[2], roots[3]);
@@ -453,5 +512,7 @@ int main()
 
   std::cout << "\nFound " << errors << " errors\n";
 
+  if (checkBatch()) return 1;
+
   return (errors < 45) ? 0 : 1;
 }
@@ -0,0 +1,83 @@
+#include <magnet/thread/ringbuffer.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+using magnet::thread::BroadcastRingBuffer;
+
+struct Item
+{
+  size_t _index;
+  std::vector<size_t> _values;
+};
+
+int main()
+{
+  //A small buffer, so the producer must regularly wait for the
+  //consumers
+  const size_t items = 1000000;
+  const size_t consumers = 3;
+  BroadcastRingBuffer<Item> buffer(64, consumers);
+
+  std::atomic<size_t> errors(0);
+  std::vector<size_t> sums(consumers, 0);
+  std::vector<std::thread> threads;
+  for (size_t c(0); c < consumers; ++c)
+    threads.push_back(std::thread([&buffer, &errors, &sums, c, items]()
+      {
+	for (size_t expected(0); expected < items;)
+	  {
+	    const Item* item = buffer.front(c);
+	    if (!item) { std::this_thread::yield(); continue; }
+
+	    //Every consumer must see every item, in order, with its
+	    //contents complete
+	    if ((item->_index != expected) || (item->_values.size() != expected % 5))
+	      ++errors;
+	    for (size_t value : item->_values)
+	      {
+		if (value != expected) ++errors;
+		sums[c] += value;
+	      }
+
+	    buffer.release(c);
+	    ++expected;
+	  }
+      }));
+
+  size_t sum = 0;
+  for (size_t i(0); i < items; ++i)
+    {
+      Item& item = buffer.claim();
+      item._index = i;
+      item._values.assign(i % 5, i);
+      sum += i * (i % 5);
+      buffer.publish();
+    }
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  if (!buffer.drained())
+    {
+      std::cerr << "The buffer was not drained" << std::endl;
+      return 1;
+    }
+
+  if (errors)
+    {
+      std::cerr << errors << " items were read out of order or incomplete" << std::endl;
+      return 1;
+    }
+
+  for (size_t c(0); c < consumers; ++c)
+    if (sums[c] != sum)
+      {
+	std::cerr << "Consumer " << c << " sum " << sums[c] << " != " << sum << std::endl;
+	return 1;
+      }
+
+  std::cout << "Finished" << std::endl;
+  return 0;
+}
@@ -0,0 +1,203 @@
+#include <magnet/intersection/offcentre_spheres.hpp>
+#include <magnet/intersection/line_line.hpp>
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+using namespace magnet;
+using magnet::math::Vector;
+using magnet::math::Quaternion;
+
+/* Checks the bounding sphere prefilters of the offcentre sphere and
+   line intersection tests against the plain root searches, and
+   benchmarks the two. The pairs are set up as in the IDumbbells and
+   ILines interactions: the centres start within the capture distance,
+   and the search runs until they leave it.
+ */
+
+std::mt19937 RNG(1234);
+
+double uniform(double min, double max)
+{ return std::uniform_real_distribution<double>(min, max)(RNG); }
+
+Vector randomUnitVector()
+{
+  std::normal_distribution<double> normal;
+  Vector vec(normal(RNG), normal(RNG), normal(RNG));
+  return vec / vec.nrm();
+}
+
+Vector randomVector(double magnitude)
+{ return randomUnitVector() * uniform(0, magnitude); }
+
+//A point uniformly distributed in a sphere, as the neighbours of a
+//particle in a fluid are.
+Vector randomPointInSphere(double radius)
+{ return randomUnitVector() * radius * std::cbrt(uniform(0, 1)); }
+
+double elapsed(std::chrono::high_resolution_clock::time_point start)
+{ return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count(); }
+
+struct SpheresCase
+{
+  Vector rij, vij, wi, wj, ui, uj;
+  double diami, diamj, maxdist, t_max;
+};
+
+struct LinesCase
+{
+  Vector rij, vij, wi, wj;
+  Quaternion qi, qj;
+  double length, t_max;
+};
+
+std::pair<bool, double> referenceSpheres(const SpheresCase& c)
+{
+  intersection::detail::OffcentreSpheresOverlapFunction f(c.rij, c.vij, c.wi, c.wj, c.ui, c.uj, c.diami, c.diamj, c.maxdist);
+  return intersection::generic_algorithm(f, c.t_max, std::min(c.diami, c.diamj) * 1e-10);
+}
+
+std::pair<bool, double> filteredSpheres(const SpheresCase& c)
+{ return intersection::offcentre_spheres(c.rij, c.vij, c.wi, c.wj, c.ui, c.uj, c.diami, c.diamj, c.maxdist, c.t_max); }
+
+std::pair<bool, double> referenceLines(const LinesCase& c)
+{
+  intersection::detail::LinesOverlapFunc fL(c.rij, c.vij, c.wi, c.wj, c.qi, c.qj, c.length);
+  std::pair<double,double> dtw = fL.discIntersectionWindow();
+  return math::frenkelRootSearch(fL, std::max(dtw.first, 0.0), std::min(dtw.second, c.t_max), c.length * 1e-10);
+}
+
+std::pair<bool, double> filteredLines(const LinesCase& c)
+{ return intersection::line_line(c.rij, c.vij, c.wi, c.wj, c.qi, c.qj, c.length, false, c.t_max); }
+
+/* Compare the two searches on every case, returning the number of
+   disagreements. Only the events the interactions act on are
+   compared: the time of the first collision, or that there is none.
+ */
+template<class Case, class F1, class F2>
+size_t compare(const std::vector<Case>& cases, F1 reference, F2 filtered, const char* name)
+{
+  size_t failures(0), collisions(0);
+  for (const Case& c : cases)
+    {
+      const std::pair<bool, double> ref = reference(c);
+      const std::pair<bool, double> fil = filtered(c);
+
+      //Virtual events are only lower bounds on the root, so they
+      //cannot be compared
+      if ((!ref.first && (ref.second != HUGE_VAL)) || (!fil.first && (fil.second != HUGE_VAL)))
+	continue;
+
+      collisions += ref.first;
+      if ((ref.first != fil.first)
+	  || (ref.first && (std::abs(ref.second - fil.second) > 1e-8 * std::max(1.0, ref.second))))
+	{
+	  if (++failures < 10)
+	    std::cerr << name << ": reference (" << ref.first << ", " << ref.second
+		      << ") != filtered (" << fil.first << ", " << fil.second << ")\n";
+	}
+    }
+
+  std::cout << name << ": " << cases.size() << " pairs, " << collisions << " collisions, "
+	    << failures << " disagreements\n";
+  return failures;
+}
+
+template<class Case, class F>
+double benchmark(const std::vector<Case>& cases, F func)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  double sum(0);
+  for (size_t repeat(0); repeat < 5; ++repeat)
+    for (const Case& c : cases)
+      {
+	const std::pair<bool, double> root = func(c);
+	if (root.second != HUGE_VAL) sum += root.second;
+      }
+  //Use the result so the loop cannot be optimised away
+  if (sum < 0) std::cout << sum;
+  return elapsed(start);
+}
+
+/* Snowman-like dumbbells, with a small sphere A and a large sphere B
+   on either side of the centre of the particle.
+ */
+std::vector<SpheresCase> makeSpheresCases(size_t N, bool small_pairs)
+{
+  std::vector<SpheresCase> cases;
+  while (cases.size() < N)
+    {
+      const double LA = 0.4, LB = 0.2, diamA = 0.5, diamB = 1.0;
+      const double maxdist = 2 * std::max(LA + 0.5 * diamA, LB + 0.5 * diamB);
+
+      SpheresCase c;
+      c.rij = randomPointInSphere(maxdist);
+      c.vij = randomVector(2.0);
+      c.wi = randomVector(2.0);
+      c.wj = randomVector(2.0);
+      //Test the pairing of the two small spheres, or of a small and a
+      //large sphere
+      c.ui = randomUnitVector() * LA;
+      c.uj = randomUnitVector() * (small_pairs ? LA : LB);
+      c.diami = diamA;
+      c.diamj = small_pairs ? diamA : diamB;
+      c.maxdist = maxdist;
+      c.t_max = intersection::ray_inv_sphere(c.rij, c.vij, maxdist);
+
+      //Skip initially overlapping pairs, as they cannot occur in a simulation
+      if ((c.rij + c.ui - c.uj).nrm() < 0.5 * (c.diami + c.diamj)) continue;
+
+      cases.push_back(c);
+    }
+  return cases;
+}
+
+/* Needle-like lines, whose angular velocities are perpendicular to
+   their directors.
+ */
+std::vector<LinesCase> makeLinesCases(size_t N)
+{
+  std::vector<LinesCase> cases;
+  while (cases.size() < N)
+    {
+      LinesCase c;
+      c.length = 1.0;
+      c.rij = randomPointInSphere(c.length);
+      c.vij = randomVector(2.0);
+      const Vector ui = randomUnitVector(), uj = randomUnitVector();
+      c.qi = Quaternion::fromToVector(ui);
+      c.qj = Quaternion::fromToVector(uj);
+      c.wi = ui ^ randomVector(2.0);
+      c.wj = uj ^ randomVector(2.0);
+      //The search window used by the interaction is set by the
+      //capture sphere, but an unbounded window is also passed here
+      //to test the prefilter
+      c.t_max = (cases.size() % 2) ? intersection::ray_inv_sphere(c.rij, c.vij, c.length) : HUGE_VAL;
+      cases.push_back(c);
+    }
+  return cases;
+}
+
+int main()
+{
+  size_t failures(0);
+
+  const std::vector<SpheresCase> smallPairs = makeSpheresCases(20000, true);
+  const std::vector<SpheresCase> mixedPairs = makeSpheresCases(20000, false);
+  const std::vector<LinesCase> lines = makeLinesCases(20000);
+
+  failures += compare(smallPairs, referenceSpheres, filteredSpheres, "Offcentre spheres (small-small)");
+  failures += compare(mixedPairs, referenceSpheres, filteredSpheres, "Offcentre spheres (small-large)");
+  failures += compare(lines, referenceLines, filteredLines, "Lines");
+
+  std::cout << "Offcentre spheres (small-small): reference " << benchmark(smallPairs, referenceSpheres)
+	    << "s, filtered " << benchmark(smallPairs, filteredSpheres) << "s\n";
+  std::cout << "Offcentre spheres (small-large): reference " << benchmark(mixedPairs, referenceSpheres)
+	    << "s, filtered " << benchmark(mixedPairs, filteredSpheres) << "s\n";
+  std::cout << "Lines: reference " << benchmark(lines, referenceLines)
+	    << "s, filtered " << benchmark(lines, filteredLines) << "s\n";
+
+  return failures != 0;
+}
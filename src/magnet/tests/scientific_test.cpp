@@ -0,0 +1,57 @@
+#include <magnet/string/scientific.hpp>
+#include <iostream>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+//Check the formatter matches printf for random values over the full
+//range of doubles, values typical of a simulation and values which
+//are exactly half way between two outputs.
+int main()
+{
+  std::mt19937_64 gen(42);
+  size_t failures = 0;
+
+  std::vector<double> values = {0.0, -0.0, 2.5, 0.5, 1.5, 125.0, 0.125, 1e22, 1e23, 9.5, 99.5,
+				 std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min(),
+				 std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity(),
+				 -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+
+  for (size_t i(0); i < 2000000; ++i)
+    {
+      const uint64_t bits = gen();
+      double x;
+      switch (i % 3)
+	{
+	case 0: std::memcpy(&x, &bits, sizeof(x)); break;
+	case 1: x = std::uniform_real_distribution<double>(-100, 100)(gen); break;
+	default: x = std::ldexp(double(bits >> 11), int(gen() % 200) - 150); break;
+	}
+      values.push_back(x);
+    }
+
+  for (size_t i(0); i < values.size(); ++i)
+    for (int precision : {0, 1, 5, 13, 17, 20})
+      {
+	if ((i > 100) && (precision != int(i % 21)) && (precision != 17))
+	  continue;
+
+	char fast[128], reference[128];
+	*magnet::string::formatScientific(fast, values[i], precision) = '\0';
+	std::snprintf(reference, sizeof(reference), "%.*e", precision, values[i]);
+
+	if (std::strcmp(fast, reference) && (failures++ < 10))
+	  std::cerr << "Formatted " << fast << " instead of " << reference << std::endl;
+      }
+
+  if (failures)
+    {
+      std::cerr << failures << " values were formatted incorrectly" << std::endl;
+      return 1;
+    }
+
+  std::cout << "Finished" << std::endl;
+  return 0;
+}
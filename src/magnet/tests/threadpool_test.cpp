@@ -1,6 +1,10 @@
 #include <iostream>
 #include <vector>
+#include <queue>
 #include <stdexcept>
+#include <chrono>
+#include <atomic>
+#include <cmath>
 #include <magnet/thread/threadpool.hpp>
 
 std::vector<float> sums;
@@ -33,6 +37,210 @@ struct A
   { std::cerr << "Inside memberfunc3, i=" << i << ", j=" << j << "\n"; }
 };
 
+/*! \brief A minimal copy of the original ThreadPool design (a single
+  mutex protected queue, notifying all threads on every push), used
+  as a baseline in the benchmarks.
+ */
+class MutexQueuePool
+{
+public:
+  MutexQueuePool(size_t threads): _idle(0), _stop(false)
+  {
+    for (size_t i(0); i < threads; ++i)
+      _threads.create_thread(std::function<void()>(std::bind(&MutexQueuePool::loop, this)));
+    _nthreads = threads;
+  }
+
+  ~MutexQueuePool()
+  {
+    { std::lock_guard<std::mutex> lock(_mutex); _stop = true; }
+    _work.notify_all();
+    _threads.join_all();
+  }
+
+  void queueTask(std::function<void()> func)
+  {
+    { std::lock_guard<std::mutex> lock(_mutex); _queue.push(func); }
+    _work.notify_all();
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_queue.empty() || (_idle != _nthreads))
+      _available.wait(lock);
+  }
+
+private:
+  void loop()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop)
+      {
+	if (_queue.empty())
+	  {
+	    ++_idle;
+	    _available.notify_all();
+	    _work.wait(lock);
+	    --_idle;
+	    continue;
+	  }
+	std::function<void()> func = _queue.front();
+	_queue.pop();
+	lock.unlock();
+	func();
+	lock.lock();
+      }
+  }
+
+  std::queue<std::function<void()> > _queue;
+  std::mutex _mutex;
+  std::condition_variable _work, _available;
+  magnet::thread::ThreadGroup _threads;
+  size_t _nthreads, _idle;
+  bool _stop;
+};
+
+size_t fib(magnet::thread::ThreadPool& pool, size_t n)
+{
+  if (n < 12)
+    return (n < 2) ? n : fib(pool, n - 1) + fib(pool, n - 2);
+
+  size_t a, b;
+  magnet::thread::TaskGroup group(pool);
+  group.run([&](){ a = fib(pool, n - 1); });
+  b = fib(pool, n - 2);
+  group.wait();
+  return a + b;
+}
+
+double elapsed(std::chrono::high_resolution_clock::time_point start)
+{ return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count(); }
+
+void testExtensions(magnet::thread::ThreadPool& pool)
+{
+  //parallel_for over ranges, with nested parallel_for's
+  std::vector<size_t> data(100000);
+  pool.parallel_for(0, data.size(), [&](size_t begin, size_t end)
+		    { 
+		      for (size_t i(begin); i < end; ++i) data[i] = i;
+		    });
+  for (size_t i(0); i < data.size(); ++i)
+    if (data[i] != i) throw std::runtime_error("Muck up in parallel_for");
+
+  std::atomic<size_t> nestedSum(0);
+  pool.parallel_for(0, 100, [&](size_t begin, size_t end)
+		    {
+		      for (size_t i(begin); i < end; ++i)
+			pool.parallel_for(0, 100, [&](size_t b, size_t e) { nestedSum += e - b; }, 7);
+		    }, 3);
+  if (nestedSum != 100 * 100) throw std::runtime_error("Muck up in nested parallel_for");
+
+  //Nested task groups
+  if (fib(pool, 24) != 46368) throw std::runtime_error("Muck up in nested task groups");
+
+  //Futures
+  std::future<size_t> future = pool.async([&](){ return fib(pool, 20); });
+  if (pool.get(future) != 6765) throw std::runtime_error("Muck up in async");
+
+  std::future<int> throwing = pool.async([]() -> int { throw std::runtime_error("expected"); });
+  try { pool.get(throwing); throw std::logic_error("Exception not passed through future"); }
+  catch (std::runtime_error&) {}
+
+  //Exceptions passed to wait()
+  pool.queueTask([](){ M_throw() << "expected"; });
+  try { pool.wait(); throw std::logic_error("Exception not passed to wait"); }
+  catch (magnet::exception&) {}
+  pool.wait();
+}
+
+void testBoundTasks(magnet::thread::ThreadPool& pool)
+{
+  //Tasks bound to a thread always run on that thread, in order
+  const size_t threads = std::max(pool.getThreadCount(), size_t(1));
+  const size_t tasks = 100;
+  std::vector<std::vector<std::thread::id> > ids(threads, std::vector<std::thread::id>(tasks));
+  std::vector<std::vector<int> > cpus(threads, std::vector<int>(tasks, -1));
+  std::vector<size_t> order(threads, 0);
+  std::atomic<size_t> outOfOrder(0);
+
+  for (size_t i(0); i < tasks; ++i)
+    for (size_t t(0); t < threads; ++t)
+      pool.queueTaskOn(t, [&, t, i]()
+		       {
+			 ids[t][i] = std::this_thread::get_id();
+#ifdef __linux__
+			 cpus[t][i] = sched_getcpu();
+#endif
+			 if (order[t]++ != i) ++outOfOrder;
+		       });
+  pool.wait();
+
+  if (outOfOrder) throw std::runtime_error("Muck up in the order of bound tasks");
+
+  const std::vector<size_t> available = magnet::thread::availableCPUs();
+  for (size_t t(0); t < threads; ++t)
+    for (size_t i(0); i < tasks; ++i)
+      {
+	if (ids[t][i] != ids[t][0])
+	  throw std::runtime_error("Muck up, bound task ran on the wrong thread");
+
+	if (pool.getThreadCount() && (ids[t][i] == std::this_thread::get_id()))
+	  throw std::runtime_error("Muck up, bound task ran on the waiting thread");
+
+	if (pool.getThreadCount() && pool.getThreadAffinity() && (cpus[t][i] >= 0) 
+	    && (size_t(cpus[t][i]) != available[t % available.size()]))
+	  throw std::runtime_error("Muck up, bound task ran on the wrong CPU");
+      }
+
+  for (size_t t(1); t < pool.getThreadCount(); ++t)
+    if (ids[t][0] == ids[0][0])
+      throw std::runtime_error("Muck up, tasks bound to different threads ran on the same thread");
+}
+
+void benchmark(magnet::thread::ThreadPool& pool)
+{
+  const size_t N = 100000;
+  std::vector<double> data(N);
+  auto work = [&](size_t i) { data[i] = std::sqrt(double(i)); };
+
+  {
+    MutexQueuePool old(pool.getThreadCount());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i(0); i < N; ++i) old.queueTask(std::bind(work, i));
+    old.wait();
+    std::cerr << "Mutex queue pool, " << N << " tasks: " << elapsed(start) << "s\n";
+  }
+
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i(0); i < N; ++i) pool.queueTask(std::bind(work, i));
+    pool.wait();
+    std::cerr << "ThreadPool::queueTask, " << N << " tasks: " << elapsed(start) << "s\n";
+  }
+
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    magnet::thread::TaskGroup group(pool);
+    pool.queueTask([&](){ for (size_t i(0); i < N; ++i) group.run(std::bind(work, i)); });
+    pool.wait();
+    group.wait();
+    std::cerr << "TaskGroup::run from a worker, " << N << " tasks: " << elapsed(start) << "s\n";
+  }
+
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    pool.parallel_for(0, N, [&](size_t begin, size_t end) { for (size_t i(begin); i < end; ++i) work(i); }, 1);
+    std::cerr << "parallel_for, grain 1, " << N << " elements: " << elapsed(start) << "s\n";
+  }
+
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    fib(pool, 27);
+    std::cerr << "Nested task groups, fib(27): " << elapsed(start) << "s\n";
+  }
+}
+
 int main()
 {
   int N = 1000;
@@ -94,6 +302,28 @@ int main()
 	}
     }
 
+  testExtensions(pool);
+  testBoundTasks(pool);
+  benchmark(pool);
+
+  pool.setThreadAffinity(true);
+  testBoundTasks(pool);
+  testExtensions(pool);
+  pool.setThreadAffinity(false);
+
+  //Changing the thread count keeps queued tasks, and 0 thread mode
+  //runs the tasks in wait()
+  std::atomic<size_t> counter(0);
+  for (size_t i(0); i < 1000; ++i) pool.queueTask([&](){ ++counter; });
+  pool.setThreadCount(0);
+  testExtensions(pool);
+  testBoundTasks(pool);
+  pool.wait();
+  if (counter != 1000) throw std::runtime_error("Muck up in setThreadCount");
+
+  pool.setThreadCount(2);
+  testExtensions(pool);
+
   std::cerr << "Finished\n";
 
   return 0;
@@ -0,0 +1,133 @@
+#include <magnet/xmlstreamreader.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+
+//Check the parser against boost::lexical_cast, which was used to
+//read the numbers before.
+void testParseDouble()
+{
+  std::mt19937_64 gen(42);
+  const char* formats[] = {"%.17e", "%.10e", "%.3f", "%g", "%.0f"};
+  size_t failures = 0;
+
+  for (size_t i(0); i < 500000; ++i)
+    {
+      double x;
+      uint64_t bits = gen();
+      if (i % 2)
+	x = std::uniform_real_distribution<double>(-1000, 1000)(gen);
+      else
+	std::memcpy(&x, &bits, sizeof(x));
+
+      if ((x != x) || std::isinf(x)) continue;
+
+      char buffer[512];
+      std::snprintf(buffer, sizeof(buffer), formats[i % 5], x);
+      if (std::strlen(buffer) > 60) continue;
+
+      double fast;
+      if (!magnet::xml::detail::parseDouble(buffer, buffer + std::strlen(buffer), fast)
+	  || (boost::lexical_cast<double>(buffer) != fast))
+	{
+	  if (failures++ < 10)
+	    std::cerr << "Failed to parse " << buffer << "\n";
+	}
+    }
+
+  const char* invalid[] = {"", "-", "e5", "1e", "1.0x", "Static", "1 2"};
+  for (const char* text : invalid)
+    {
+      double val;
+      if (magnet::xml::detail::parseDouble(text, text + std::strlen(text), val))
+	{
+	  std::cerr << "Accepted the invalid number \"" << text << "\"\n";
+	  ++failures;
+	}
+    }
+
+  if (failures)
+    throw std::runtime_error("parseDouble does not match boost::lexical_cast");
+}
+
+//Check a streamed document, with records split over many chunks,
+//matches the rapidxml parse of the same document.
+void testStreamingDocument(magnet::thread::ThreadPool& pool, size_t blockSize, size_t chunkSize)
+{
+  const size_t N = 20000;
+  std::ostringstream os;
+  os.precision(17);
+  os << "<?xml version=\"1.0\"?>\n<Root>\n  <Header Value=\"3\"/>\n  <Bulk Flag=\"Y\">\n";
+  for (size_t i(0); i < N; ++i)
+    {
+      os << "    <R ID=\"" << i << "\"" << ((i % 7) ? "" : " Static=\"Static\"") << " M='" << 0.5 * i << "'>\n"
+	 << "      <P x=\"" << 1.0 / (i + 1) << "\" y=\"" << -3.0 * i << "\"/>\n";
+      if (i == 100) os << "      <!-- A comment -->\n";
+      os << "    </R>\n";
+    }
+  os << "  </Bulk>\n  <Trailer Value=\"4\"/>\n</Root>\n";
+
+  const std::string text = os.str();
+  std::istringstream is(text);
+  magnet::xml::StreamingDocument doc(blockSize, chunkSize, 2);
+  doc.load(is, "Bulk", "R", pool);
+
+  magnet::xml::Node root = doc.getNode("Root");
+  if ((root.getNode("Header").getAttribute("Value").as<int>() != 3)
+      || (root.getNode("Trailer").getAttribute("Value").as<int>() != 4)
+      || (root.getNode("Bulk").getAttribute("Flag").getValue() != "Y")
+      || root.getNode("Bulk").hasNode("R"))
+    throw std::runtime_error("The document structure was not preserved");
+
+  magnet::xml::Document reference;
+  reference.getStoredXMLData() = text;
+  reference.parseData();
+
+  const magnet::xml::RecordTable& records = doc.getRecords();
+  if (records.size() != N)
+    throw std::runtime_error("Wrong record count");
+
+  const std::vector<double>& ids = records.getColumn("ID");
+  const std::vector<double>& mass = records.getColumn("M");
+  const std::vector<double>& px = records.getColumn("P.x");
+  const std::vector<double>& py = records.getColumn("P.y");
+  const magnet::xml::RecordTable::Column* flags = records.findColumn("Static");
+
+  size_t i(0);
+  for (magnet::xml::Node node = reference.getNode("Root").getNode("Bulk").fastGetNode("R");
+       node.valid(); ++node, ++i)
+    if ((ids[i] != node.getAttribute("ID").as<double>())
+	|| (mass[i] != node.getAttribute("M").as<double>())
+	|| (px[i] != node.getNode("P").getAttribute("x").as<double>())
+	|| (py[i] != node.getNode("P").getAttribute("y").as<double>())
+	|| (bool(flags->_present[i]) != node.hasAttribute("Static")))
+      throw std::runtime_error("Record mismatch");
+
+  //Malformed records must be reported
+  std::istringstream bad("<Root><Bulk><R ID=\"0\"><P x=\"1\"></R></Bulk></Root>");
+  try {
+    doc.load(bad, "Bulk", "R", pool);
+    throw std::logic_error("A malformed record was accepted");
+  } catch (magnet::exception&) {}
+}
+
+int main()
+{
+  magnet::thread::ThreadPool pool;
+  pool.setThreadCount(3);
+
+  testParseDouble();
+  testStreamingDocument(pool, 1 << 20, 1 << 20);
+  testStreamingDocument(pool, 1000, 4096);
+  testStreamingDocument(pool, 7, 64);
+
+  pool.setThreadCount(0);
+  testStreamingDocument(pool, 1000, 4096);
+
+  std::cout << "Finished\n";
+  return 0;
+}